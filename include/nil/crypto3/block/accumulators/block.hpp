@@ -42,7 +42,7 @@
 
 #include <nil/crypto3/block/accumulators/parameters/cipher.hpp>
 #include <nil/crypto3/block/accumulators/parameters/bits.hpp>
-#include <boost/accumulators/framework/parameters/sample.hpp>
+#include <nil/crypto3/block/accumulators/parameters/expected_bits.hpp>
 #include <nil/crypto3/block/detail/cipher_modes.hpp>
 
 #include <nil/crypto3/block/cipher.hpp>
@@ -69,6 +69,7 @@ namespace nil {
 
                     constexpr static const std::size_t value_bits = sizeof(typename block_type::value_type) * CHAR_BIT;
                     constexpr static const std::size_t block_values = block_bits / value_bits;
+                    constexpr static const std::size_t block_octets = block_bits / octet_bits;
 
                     typedef ::nil::crypto3::detail::injector<endian_type, value_bits, block_values, block_bits>
                         injector_type;
@@ -83,6 +84,7 @@ namespace nil {
 
                     template<typename ArgumentPack>
                     inline void operator()(const ArgumentPack &args) {
+                        reserve(args[::nil::crypto3::accumulators::expected_bits | std::size_t()]);
                         resolve_type(args[boost::accumulators::sample],
                                      args[::nil::crypto3::accumulators::bits | std::size_t()]);
                     }
@@ -94,15 +96,57 @@ namespace nil {
 
                         block_type processed_block = mode.end_message(cache, total_seen);
 
-                        res = ::nil::crypto3::resize<block_bits>(res, res.size() + block_values);
+                        res.resize(res.size() + block_octets);
 
                         pack<endian_type, endian_type, value_bits, octet_bits>(
-                            processed_block.begin(), processed_block.end(), res.end() - block_values);
+                            processed_block.begin(), processed_block.end(), res.end() - block_octets);
 
                         return res;
                     }
 
+                    /*!
+                     * @brief Moves the output produced so far to out and drops it from the accumulator. Only the
+                     * block held back for end_message and a possibly incomplete block stay inside, which lets
+                     * callers stream arbitrarily long messages with bounded memory.
+                     * @param out Output iterator
+                     * @return Output iterator past the last written octet
+                     */
+                    template<typename OutputIterator>
+                    inline OutputIterator flush(OutputIterator out) {
+                        out = std::move(dgst.begin(), dgst.end(), out);
+                        dgst.clear();
+                        return out;
+                    }
+
                 protected:
+                    /*!
+                     * @brief Reserves output storage for the input of known length, so the whole message is
+                     * appended without reallocations.
+                     * @param bits Amount of input bits still to come
+                     */
+                    inline void reserve(std::size_t bits) {
+                        if (bits) {
+                            // One more block for the one currently held in cache
+                            dgst.reserve(dgst.size() + (bits / block_bits + 2) * block_octets);
+                        }
+                    }
+
+                    /*!
+                     * @brief Appends processed blocks to the output. The digest grows geometrically, so appending
+                     * n blocks one by one costs amortized O(n).
+                     */
+                    inline void append(const block_type *processed, std::size_t blocks) {
+                        using namespace ::nil::crypto3::detail;
+
+                        std::size_t offset = dgst.size();
+                        dgst.resize(offset + blocks * block_octets);
+
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            pack<endian_type, endian_type, value_bits, octet_bits>(
+                                processed[i].begin(), processed[i].end(), dgst.begin() + offset + i * block_octets);
+                        }
+                    }
+
                     inline void resolve_type(const block_type &value, std::size_t bits) {
                         process(value, bits == 0 ? block_bits : bits);
                     }
@@ -111,20 +155,24 @@ namespace nil {
                         process(value, bits == 0 ? word_bits : bits);
                     }
 
+                    template<std::size_t BatchBlocks>
+                    inline void resolve_type(const std::array<block_type, BatchBlocks> &value, std::size_t bits) {
+                        process(value, bits / block_bits);
+                    }
+
                     inline void process_block() {
                         using namespace ::nil::crypto3::detail;
 
                         block_type processed_block;
-                        if (dgst.empty()) {
+                        // Processed output may have been flushed already, so the first block is detected by the bits
+                        // seen so far
+                        if (total_seen <= block_bits) {
                             processed_block = mode.begin_message(cache, total_seen);
                         } else {
                             processed_block = mode.process_block(cache, total_seen);
                         }
 
-                        dgst = ::nil::crypto3::resize<block_bits>(dgst, dgst.size() + block_values);
-
-                        pack<endian_type, endian_type, value_bits, octet_bits>(
-                            processed_block.begin(), processed_block.end(), dgst.end() - block_values);
+                        append(&processed_block, 1);
 
                         filled = false;
                     }
@@ -138,6 +186,14 @@ namespace nil {
 
                         std::size_t cached_bits = total_seen % block_bits;
 
+                        if (cached_bits == 0 && value_seen == block_bits) {
+                            // Block-aligned full block, no need for the injector
+                            cache = value;
+                            total_seen += block_bits;
+                            filled = true;
+                            return;
+                        }
+
                         if (cached_bits != 0) {
                             // If there are already any bits in the cache
 
@@ -188,6 +244,40 @@ namespace nil {
                         }
                     }
 
+                    template<std::size_t BatchBlocks>
+                    inline void process(const std::array<block_type, BatchBlocks> &value, std::size_t blocks) {
+                        using namespace ::nil::crypto3::detail;
+
+                        if (!blocks) {
+                            return;
+                        }
+
+                        process(value[0], block_bits);
+
+                        if (total_seen % block_bits != 0) {
+                            // Not aligned to the block boundary, so blocks have to be injected one by one
+                            for (std::size_t i = 1; i != blocks; ++i) {
+                                process(value[i], block_bits);
+                            }
+                            return;
+                        }
+
+                        if (blocks == 1) {
+                            return;
+                        }
+
+                        // The first block is pending in cache now, the last one is kept there for end_message
+                        process_block();
+
+                        std::array<block_type, BatchBlocks> processed;
+                        mode.process_blocks(value.data() + 1, processed.data(), blocks - 2, total_seen + block_bits);
+                        append(processed.data(), blocks - 2);
+
+                        cache = value[blocks - 1];
+                        total_seen += (blocks - 1) * block_bits;
+                        filled = true;
+                    }
+
                     inline void process(const word_type &value, std::size_t value_seen) {
                         using namespace ::nil::crypto3::detail;
 
@@ -35,6 +35,18 @@ namespace nil {
              */
             template<std::size_t KeyBits>
             using aes = rijndael<KeyBits, 128>;
+
+            /*!
+             * @brief AES with the encryption key schedule only, see rijndael_encryptor.
+             */
+            template<std::size_t KeyBits>
+            using aes_encryptor = rijndael_encryptor<KeyBits, 128>;
+
+            /*!
+             * @brief AES with the decryption key schedule only, see rijndael_decryptor.
+             */
+            template<std::size_t KeyBits>
+            using aes_decryptor = rijndael_decryptor<KeyBits, 128>;
         }    // namespace block
     }        // namespace crypto3
 }    // namespace nil
@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_PARALLEL_HPP
+#define CRYPTO3_BLOCK_PARALLEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/static_assert.hpp>
+
+#include <nil/crypto3/detail/pack.hpp>
+
+#include <nil/crypto3/block/detail/utilities/thread_pool.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            namespace detail {
+                /*!
+                 * @cond DETAIL_IMPL
+                 */
+                // Chunks are sized to stay within a private L2 slice, batches to stay in L1 while being
+                // converted in and out of cipher words
+                constexpr static const std::size_t parallel_chunk_octets = 32 * 1024;
+                constexpr static const std::size_t parallel_batch_octets = 4096;
+
+                template<typename BlockCipher, bool Encrypt>
+                struct parallel_ecb_pass {
+                    typedef BlockCipher cipher_type;
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::endian_type endian_type;
+
+                    constexpr static const std::size_t octet_bits = CHAR_BIT;
+                    constexpr static const std::size_t word_bits = sizeof(typename block_type::value_type) * CHAR_BIT;
+                    constexpr static const std::size_t block_octets = cipher_type::block_bits / octet_bits;
+
+                    constexpr static const std::size_t chunk_blocks = parallel_chunk_octets / block_octets;
+                    constexpr static const std::size_t batch_blocks = parallel_batch_octets / block_octets;
+                    BOOST_STATIC_ASSERT(chunk_blocks % batch_blocks == 0);
+
+                    typedef std::array<block_type, batch_blocks> batch_type;
+
+                    // Octet sized cipher words need no repacking, so a whole batch is moved with a single copy
+                    typedef std::integral_constant<bool, word_bits == octet_bits &&
+                                                             sizeof(batch_type) == batch_blocks * block_octets>
+                        octet_words;
+
+                    template<typename InputIterator>
+                    static inline void load(InputIterator in, batch_type &batch, std::size_t n, std::true_type) {
+                        std::copy(in, in + n * block_octets, batch.front().data());
+                    }
+
+                    template<typename InputIterator>
+                    static inline void load(InputIterator in, batch_type &batch, std::size_t n, std::false_type) {
+                        for (std::size_t i = 0; i != n; ++i, in += block_octets) {
+                            ::nil::crypto3::detail::pack_to<endian_type, octet_bits, word_bits>(
+                                in, in + block_octets, batch[i].begin());
+                        }
+                    }
+
+                    template<typename OutputIterator>
+                    static inline void store(const batch_type &batch, std::size_t n, OutputIterator out,
+                                             std::true_type) {
+                        std::copy(batch.front().data(), batch.front().data() + n * block_octets, out);
+                    }
+
+                    template<typename OutputIterator>
+                    static inline void store(const batch_type &batch, std::size_t n, OutputIterator out,
+                                             std::false_type) {
+                        for (std::size_t i = 0; i != n; ++i, out += block_octets) {
+                            ::nil::crypto3::detail::pack<endian_type, endian_type, word_bits, octet_bits>(
+                                batch[i].begin(), batch[i].end(), OutputIterator(out));
+                        }
+                    }
+
+                    static inline void process(const cipher_type &cipher, const block_type *in, block_type *out,
+                                               std::size_t blocks, std::true_type) {
+                        cipher.encrypt_blocks(in, out, blocks);
+                    }
+
+                    static inline void process(const cipher_type &cipher, const block_type *in, block_type *out,
+                                               std::size_t blocks, std::false_type) {
+                        cipher.decrypt_blocks(in, out, blocks);
+                    }
+
+                    template<typename InputIterator, typename OutputIterator>
+                    static OutputIterator run(InputIterator first, InputIterator last, const cipher_type &cipher,
+                                              OutputIterator out, thread_pool &pool) {
+                        typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
+
+                        const std::size_t octets = std::distance(first, last);
+                        if (octets % block_octets != 0) {
+                            throw std::invalid_argument("parallel ECB input is not a whole number of blocks");
+                        }
+
+                        const std::size_t blocks = octets / block_octets;
+                        const std::size_t chunks = (blocks + chunk_blocks - 1) / chunk_blocks;
+
+                        // Every chunk reads and writes its own slice, so workers never share output lines
+                        pool.parallel_for(chunks, [&](std::size_t chunk) {
+                            batch_type batch;
+
+                            std::size_t block = chunk * chunk_blocks;
+                            const std::size_t chunk_end = block + chunk_blocks < blocks ? block + chunk_blocks : blocks;
+
+                            while (block != chunk_end) {
+                                const std::size_t n =
+                                    chunk_end - block < batch_blocks ? chunk_end - block : batch_blocks;
+                                const difference_type offset = static_cast<difference_type>(block * block_octets);
+
+                                load(first + offset, batch, n, octet_words());
+                                process(cipher, batch.data(), batch.data(), n, std::integral_constant<bool, Encrypt>());
+                                store(batch, n, out + offset, octet_words());
+
+                                block += n;
+                            }
+                        });
+
+                        return out + static_cast<difference_type>(octets);
+                    }
+                };
+                /*!
+                 * @endcond
+                 */
+            }    // namespace detail
+        }        // namespace block
+
+        /*!
+         * @brief Encrypts a whole number of blocks in ECB (isomorphic) mode, splitting the buffer into
+         * chunks spread across the pool. Each chunk goes through the cipher's bulk block path.
+         *
+         * @ingroup block_algorithms
+         *
+         * @tparam BlockCipher Block cipher providing encrypt_blocks
+         * @tparam InputIterator Random access iterator over octets
+         * @tparam OutputIterator Random access iterator over octets
+         *
+         * @param first
+         * @param last
+         * @param cipher Keyed cipher, shared read-only by all workers
+         * @param out
+         * @param pool
+         *
+         * @return Iterator past the last written octet
+         *
+         * @throws std::invalid_argument if the input is not a whole number of blocks, nothing is written then
+         */
+        template<typename BlockCipher, typename InputIterator, typename OutputIterator>
+        OutputIterator parallel_encrypt(InputIterator first, InputIterator last, const BlockCipher &cipher,
+                                        OutputIterator out, block::thread_pool &pool) {
+            return block::detail::parallel_ecb_pass<BlockCipher, true>::run(first, last, cipher, out, pool);
+        }
+
+        /*!
+         * @brief Decrypts a whole number of blocks in ECB (isomorphic) mode, see parallel_encrypt.
+         *
+         * @ingroup block_algorithms
+         */
+        template<typename BlockCipher, typename InputIterator, typename OutputIterator>
+        OutputIterator parallel_decrypt(InputIterator first, InputIterator last, const BlockCipher &cipher,
+                                        OutputIterator out, block::thread_pool &pool) {
+            return block::detail::parallel_ecb_pass<BlockCipher, false>::run(first, last, cipher, out, pool);
+        }
+    }    // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_PARALLEL_HPP
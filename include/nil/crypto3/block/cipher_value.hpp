@@ -29,11 +29,15 @@
 //#include <type_traits>
 //#include <iterator>
 
+#include <array>
+
 #include <boost/assert.hpp>
 #include <boost/concept_check.hpp>
 
 #include <boost/range/concepts.hpp>
 
+#include <boost/accumulators/framework/accumulator_set.hpp>
+
 #include <nil/crypto3/block/accumulators/block.hpp>
 #include <nil/crypto3/block/cipher_state.hpp>
 
@@ -161,6 +165,11 @@ namespace nil {
 #endif
                 };
 
+                /*!
+                 * @brief Cipher state writing its output to OutputIterator. The input is consumed in chunks and
+                 * everything processed so far is written out after each chunk, so memory usage does not depend
+                 * on the message length.
+                 */
                 template<typename CipherStateImpl, typename OutputIterator>
                 struct itr_cipher_impl : public CipherStateImpl {
                 private:
@@ -178,6 +187,9 @@ namespace nil {
                     typedef typename boost::mpl::apply<accumulator_set_type, accumulator_type>::type::result_type
                         result_type;
 
+                    /// Amount of input values consumed between output flushes
+                    constexpr static const std::size_t chunk_values = 4096;
+
                     template<typename SinglePassRange>
                     itr_cipher_impl(const SinglePassRange &range, OutputIterator out, const accumulator_set_type &ise) :
                         CipherStateImpl(ise), out(std::move(out)) {
@@ -191,7 +203,7 @@ namespace nil {
                             std::numeric_limits<value_type>::digits + std::numeric_limits<value_type>::is_signed>::type
                             stream_processor;
 
-                        stream_processor(this->accumulator_set)(range.begin(), range.end());
+                        stream<stream_processor>(range.begin(), range.end());
                     }
 
                     template<typename InputIterator>
@@ -208,7 +220,7 @@ namespace nil {
                             std::numeric_limits<value_type>::digits + std::numeric_limits<value_type>::is_signed>::type
                             stream_processor;
 
-                        stream_processor(this->accumulator_set)(first, last);
+                        stream<stream_processor>(first, last);
                     }
 
                     operator OutputIterator() const {
@@ -217,6 +229,50 @@ namespace nil {
 
                         return std::move(result.cbegin(), result.cend(), out);
                     }
+
+                protected:
+                    inline void flush() const {
+                        out = boost::accumulators::find_accumulator<accumulator_type>(this->accumulator_set).flush(out);
+                    }
+
+                    template<typename StreamProcessor, typename InputIterator>
+                    inline void stream(InputIterator first, InputIterator last) {
+                        {
+                            // Stream processor passes the incomplete block to the accumulator on destruction
+                            StreamProcessor processor(this->accumulator_set);
+                            stream_chunks(processor, first, last,
+                                          typename std::iterator_traits<InputIterator>::iterator_category());
+                        }
+                        flush();
+                    }
+
+                    template<typename StreamProcessor, typename InputIterator>
+                    inline void stream_chunks(StreamProcessor &processor, InputIterator first, InputIterator last,
+                                              std::random_access_iterator_tag) {
+                        while (static_cast<std::size_t>(std::distance(first, last)) > chunk_values) {
+                            processor(first, first + chunk_values);
+                            first += chunk_values;
+                            flush();
+                        }
+                        processor(first, last);
+                    }
+
+                    template<typename StreamProcessor, typename InputIterator, typename Category>
+                    inline void stream_chunks(StreamProcessor &processor, InputIterator first, InputIterator last,
+                                              Category) {
+                        // Single-pass input is staged through a local buffer, which also lets the stream
+                        // processor take its contiguous path
+                        std::array<typename std::iterator_traits<InputIterator>::value_type, chunk_values> buffer;
+
+                        while (first != last) {
+                            std::size_t n = 0;
+                            for (; n != chunk_values && first != last; ++n) {
+                                buffer[n] = *first++;
+                            }
+                            processor(buffer.begin(), buffer.begin() + n);
+                            flush();
+                        }
+                    }
                 };
             }    // namespace detail
         }        // namespace block
@@ -0,0 +1,432 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file NIST SP 800-90A CTR_DRBG over AES
+//
+// @brief Deterministic random bit generator in counter mode without derivation
+// function. Output comes from the bulk counter mode pass of the active Rijndael
+// backend, seeds from the system RNG device with RDRAND output mixed in where
+// the CPU has it.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_CTR_DRBG_HPP
+#define CRYPTO3_BLOCK_CTR_DRBG_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/predef/os.h>
+
+#include <nil/crypto3/block/aes.hpp>
+
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+#include <cerrno>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define CRYPTO3_BLOCK_CTR_DRBG_HAS_SYSTEM_RNG_DEVICE
+#endif
+
+#if BOOST_ARCH_X86 && defined(BOOST_ATTRIBUTE_TARGET)
+#include <immintrin.h>
+
+#define CRYPTO3_BLOCK_CTR_DRBG_HAS_RDRAND
+#endif
+
+#ifndef CRYPTO3_RNG_DEFAULT_RESEED_INTERVAL
+#define CRYPTO3_RNG_DEFAULT_RESEED_INTERVAL 1024
+#endif
+
+#ifndef CRYPTO3_RNG_RESEED_POLL_BITS
+#define CRYPTO3_RNG_RESEED_POLL_BITS 256
+#endif
+
+#ifndef CRYPTO3_SYSTEM_RNG_DEVICE
+#define CRYPTO3_SYSTEM_RNG_DEVICE "/dev/urandom"
+#endif
+
+#ifndef CRYPTO3_ENTROPY_INTEL_RNG_POLLS
+#define CRYPTO3_ENTROPY_INTEL_RNG_POLLS 32
+#endif
+
+#ifndef CRYPTO3_ENTROPY_RDRAND_RETRIES
+#define CRYPTO3_ENTROPY_RDRAND_RETRIES 10
+#endif
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                struct system_entropy {
+                    /*
+                     * Fills out from CRYPTO3_SYSTEM_RNG_DEVICE, throws std::runtime_error if the device
+                     * cannot be read.
+                     */
+                    static void read(std::uint8_t *out, std::size_t size) {
+#if defined(CRYPTO3_BLOCK_CTR_DRBG_HAS_SYSTEM_RNG_DEVICE)
+                        const int fd = ::open(CRYPTO3_SYSTEM_RNG_DEVICE, O_RDONLY | O_CLOEXEC);
+                        if (fd < 0) {
+                            throw std::runtime_error("ctr_drbg cannot open " CRYPTO3_SYSTEM_RNG_DEVICE);
+                        }
+                        while (size != 0) {
+                            const ::ssize_t got = ::read(fd, out, size);
+                            if (got < 0 && errno == EINTR) {
+                                continue;
+                            }
+                            if (got <= 0) {
+                                ::close(fd);
+                                throw std::runtime_error("ctr_drbg cannot read " CRYPTO3_SYSTEM_RNG_DEVICE);
+                            }
+                            out += got;
+                            size -= static_cast<std::size_t>(got);
+                        }
+                        ::close(fd);
+#else
+                        throw std::runtime_error("ctr_drbg has no system RNG device on this platform");
+#endif
+                    }
+
+                    /*
+                     * Fills out with RDRAND output, at most CRYPTO3_ENTROPY_INTEL_RNG_POLLS reads of 32
+                     * bits each. Returns the number of bytes written, zero without RDRAND.
+                     */
+                    static std::size_t poll_rdrand(std::uint8_t *out, std::size_t size) {
+#if defined(CRYPTO3_BLOCK_CTR_DRBG_HAS_RDRAND)
+                        if (cpuid::has_rdrand()) {
+                            return rdrand(out, size);
+                        }
+#endif
+                        return 0;
+                    }
+
+                    /*
+                     * Counts forks of the process, so that a generator state inherited by a child gets
+                     * reseeded before the child produces any output.
+                     */
+                    static unsigned fork_generation() {
+                        static std::atomic<unsigned> generation(0);
+#if defined(CRYPTO3_BLOCK_CTR_DRBG_HAS_SYSTEM_RNG_DEVICE)
+                        static const bool registered =
+                            ::pthread_atfork(nullptr, nullptr, [] { generation.fetch_add(1); }) == 0;
+                        (void)registered;
+#endif
+                        return generation.load(std::memory_order_relaxed);
+                    }
+
+                protected:
+#if defined(CRYPTO3_BLOCK_CTR_DRBG_HAS_RDRAND)
+                    BOOST_ATTRIBUTE_TARGET("rdrnd")
+                    static std::size_t rdrand(std::uint8_t *out, std::size_t size) {
+                        std::size_t written = 0;
+                        for (std::size_t poll = 0; poll != CRYPTO3_ENTROPY_INTEL_RNG_POLLS && written != size; ++poll) {
+                            unsigned int word;
+                            bool ok = false;
+                            for (std::size_t retry = 0; retry != CRYPTO3_ENTROPY_RDRAND_RETRIES && !ok; ++retry) {
+                                ok = _rdrand32_step(&word) == 1;
+                            }
+                            if (!ok) {
+                                break;
+                            }
+                            const std::size_t n = size - written < sizeof(word) ? size - written : sizeof(word);
+                            std::memcpy(out + written, &word, n);
+                            written += n;
+                        }
+                        return written;
+                    }
+#endif
+                };
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+
+            /*!
+             * @brief CTR_DRBG of NIST SP 800-90A over AES, without derivation function and
+             * without prediction resistance.
+             *
+             * @ingroup block
+             *
+             * Every request produces its output with one counter mode pass, the state update
+             * after it continues the same counter sequence, so small requests take a single
+             * pass and large ones run at the bulk CTR speed of the backend. Larger outputs are
+             * split into requests of max_request_bytes as the standard limits them.
+             *
+             * The default constructed generator seeds itself from CRYPTO3_SYSTEM_RNG_DEVICE, with
+             * reseed_poll_bytes of RDRAND output as additional input where the CPU has it. It
+             * reseeds the same way after reseed_interval requests, and in a child process after
+             * fork before any output.
+             *
+             * An instance is not synchronized. thread_instance gives every thread its own
+             * generator, so concurrent callers neither lock nor share state.
+             *
+             * @tparam KeyBits AES key length in bits. Available values are: 128, 192, 256
+             */
+            template<std::size_t KeyBits = 256>
+            class ctr_drbg {
+                typedef aes_encryptor<KeyBits> cipher_type;
+
+                typedef typename cipher_type::key_type key_type;
+                typedef typename cipher_type::block_type block_type;
+
+            public:
+                constexpr static const std::size_t key_bits = KeyBits;
+                constexpr static const std::size_t key_bytes = key_bits / CHAR_BIT;
+                constexpr static const std::size_t block_bytes = cipher_type::block_bits / CHAR_BIT;
+
+                /// Length of entropy input, personalization string and additional input
+                constexpr static const std::size_t seed_bytes = key_bytes + block_bytes;
+
+                /// Longest output of a single request, 2^19 bits
+                constexpr static const std::size_t max_request_bytes = 1 << 16;
+
+                /// Requests between automatic reseeds, zero disables them
+                constexpr static const std::size_t reseed_interval = CRYPTO3_RNG_DEFAULT_RESEED_INTERVAL;
+
+                /// RDRAND output mixed into every reseed from the system sources, at most seed_bytes
+                constexpr static const std::size_t reseed_poll_bytes =
+                    CRYPTO3_RNG_RESEED_POLL_BITS / CHAR_BIT < seed_bytes ? CRYPTO3_RNG_RESEED_POLL_BITS / CHAR_BIT :
+                                                                           seed_bytes;
+
+                BOOST_STATIC_ASSERT(key_bits == 128 || key_bits == 192 || key_bits == 256);
+
+                /*!
+                 * @brief Instantiates from the system entropy sources.
+                 */
+                ctr_drbg() : cipher(key_type()), value(), reseed_counter(0), generation(fork_generation()) {
+                    reseed();
+                }
+
+                /*!
+                 * @brief Instantiates from caller supplied entropy, e.g. for known answer tests.
+                 * Automatic reseeds still use the system entropy sources.
+                 * @param entropy seed_bytes of full entropy
+                 * @param personalization Up to seed_bytes, padded with zeros
+                 */
+                ctr_drbg(const std::uint8_t *entropy, std::size_t entropy_size,
+                         const std::uint8_t *personalization = nullptr, std::size_t personalization_size = 0) :
+                    cipher(key_type()),
+                    value(), reseed_counter(0), generation(fork_generation()) {
+                    reseed(entropy, entropy_size, personalization, personalization_size);
+                }
+
+                ~ctr_drbg() {
+                    value.fill(0);
+                }
+
+                ctr_drbg(const ctr_drbg &) = delete;
+                ctr_drbg &operator=(const ctr_drbg &) = delete;
+
+                /*!
+                 * @return Generator of the calling thread, instantiated from the system entropy sources
+                 * on first use
+                 */
+                static ctr_drbg &thread_instance() {
+                    thread_local ctr_drbg instance;
+                    return instance;
+                }
+
+                /*!
+                 * @brief Reseeds from the system entropy sources.
+                 */
+                void reseed() {
+                    std::uint8_t entropy[seed_bytes], additional[seed_bytes];
+                    detail::system_entropy::read(entropy, seed_bytes);
+                    const std::size_t additional_size =
+                        detail::system_entropy::poll_rdrand(additional, reseed_poll_bytes);
+                    reseed(entropy, seed_bytes, additional, additional_size);
+                    std::memset(entropy, 0, seed_bytes);
+                    std::memset(additional, 0, seed_bytes);
+                }
+
+                /*!
+                 * @brief Reseeds from caller supplied entropy.
+                 * @param entropy seed_bytes of full entropy
+                 * @param additional Up to seed_bytes, padded with zeros
+                 */
+                void reseed(const std::uint8_t *entropy, std::size_t entropy_size, const std::uint8_t *additional,
+                            std::size_t additional_size) {
+                    BOOST_ASSERT(entropy_size == seed_bytes && additional_size <= seed_bytes);
+
+                    std::uint8_t seed[seed_bytes];
+                    pad(additional, additional_size, seed);
+                    for (std::size_t i = 0; i != seed_bytes; ++i) {
+                        seed[i] ^= entropy[i];
+                    }
+
+                    block_type temp[seed_blocks];
+                    generate_keystream(temp, seed_blocks);
+                    update(temp, seed);
+                    reseed_counter = 1;
+                    std::memset(seed, 0, seed_bytes);
+                }
+
+                /*!
+                 * @brief Fills out with random bytes, as many requests as its size needs.
+                 * @param additional Up to seed_bytes, padded with zeros, used for every request
+                 */
+                void generate(std::uint8_t *out, std::size_t size, const std::uint8_t *additional = nullptr,
+                              std::size_t additional_size = 0) {
+                    BOOST_ASSERT(additional_size <= seed_bytes);
+                    while (size != 0) {
+                        const std::size_t n = size < max_request_bytes ? size : max_request_bytes;
+                        generate_request(out, n, additional, additional_size);
+                        out += n;
+                        size -= n;
+                    }
+                }
+
+                /*!
+                 * @brief Fills a contiguous range of trivially copyable values, e.g. a std::array of
+                 * nonces, with random bytes.
+                 */
+                template<typename ContiguousRange>
+                void generate(ContiguousRange &range) {
+                    typedef typename std::iterator_traits<decltype(std::begin(range))>::value_type value_type;
+
+                    const std::size_t count =
+                        static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+                    if (count != 0) {
+                        generate(reinterpret_cast<std::uint8_t *>(&*std::begin(range)), count * sizeof(value_type));
+                    }
+                }
+
+            protected:
+                constexpr static const std::size_t seed_blocks = (seed_bytes + block_bytes - 1) / block_bytes;
+
+                // Requests this short take one pass through a stack buffer together with the update
+                constexpr static const std::size_t fused_blocks = 16;
+
+                // Output is zeroed and encrypted in pieces which stay in the L1 cache in between
+                constexpr static const std::size_t chunk_blocks = 512;
+
+                static unsigned fork_generation() {
+                    return detail::system_entropy::fork_generation();
+                }
+
+                static void pad(const std::uint8_t *data, std::size_t size, std::uint8_t *out) {
+                    if (size != 0) {
+                        std::memcpy(out, data, size);
+                    }
+                    std::memset(out + size, 0, seed_bytes - size);
+                }
+
+                // Keystream from counter value + 1 on, value advances past it
+                void generate_keystream(block_type *out, std::size_t blocks) {
+                    block_type counter = value;
+                    increment(counter, 1);
+                    std::memset(static_cast<void *>(out), 0, blocks * block_bytes);
+                    cipher.encrypt_ctr(counter, out, out, blocks);
+                    increment(value, blocks);
+                }
+
+                // CTR_DRBG_Update with temp already holding the next seed_blocks of keystream
+                void update(block_type *temp, const std::uint8_t *provided) {
+                    std::uint8_t *bytes = reinterpret_cast<std::uint8_t *>(temp);
+                    for (std::size_t i = 0; i != seed_bytes; ++i) {
+                        bytes[i] ^= provided[i];
+                    }
+
+                    key_type key;
+                    std::memcpy(key.data(), bytes, key_bytes);
+                    std::memcpy(value.data(), bytes + key_bytes, block_bytes);
+                    cipher = cipher_type(key);
+
+                    key.fill(0);
+                    std::memset(bytes, 0, seed_blocks * block_bytes);
+                }
+
+                void generate_request(std::uint8_t *out, std::size_t size, const std::uint8_t *additional,
+                                      std::size_t additional_size) {
+                    const unsigned current_generation = fork_generation();
+                    if (current_generation != generation ||
+                        (reseed_interval != 0 && reseed_counter > reseed_interval)) {
+                        generation = current_generation;
+                        reseed();
+                    }
+
+                    std::uint8_t provided[seed_bytes];
+                    pad(additional, additional_size, provided);
+                    if (additional_size != 0) {
+                        block_type temp[seed_blocks];
+                        generate_keystream(temp, seed_blocks);
+                        update(temp, provided);
+                    }
+
+                    const std::size_t full = size / block_bytes, blocks = (size + block_bytes - 1) / block_bytes;
+                    block_type buffer[fused_blocks + seed_blocks];
+                    if (blocks <= fused_blocks) {
+                        // Output and the keystream of the update in a single pass
+                        generate_keystream(buffer, blocks + seed_blocks);
+                        std::memcpy(out, buffer, size);
+                        std::memset(static_cast<void *>(buffer), 0, blocks * block_bytes);
+                        update(buffer + blocks, provided);
+                    } else {
+                        // The bulk of the request straight into the output, the tail with the update
+                        for (std::size_t done = 0; done != full;) {
+                            const std::size_t n = full - done < chunk_blocks ? full - done : chunk_blocks;
+                            generate_keystream(reinterpret_cast<block_type *>(out) + done, n);
+                            done += n;
+                        }
+                        const std::size_t tail = blocks - full;
+                        generate_keystream(buffer, tail + seed_blocks);
+                        std::memcpy(out + full * block_bytes, buffer, size - full * block_bytes);
+                        std::memset(static_cast<void *>(buffer), 0, tail * block_bytes);
+                        update(buffer + tail, provided);
+                    }
+                    ++reseed_counter;
+                }
+
+                // Big-endian addition modulo 2^128
+                static void increment(block_type &counter, std::uint64_t n) {
+                    for (std::size_t i = counter.size(); n != 0 && i-- != 0;) {
+                        n += counter[i];
+                        counter[i] = static_cast<std::uint8_t>(n);
+                        n >>= CHAR_BIT;
+                    }
+                }
+
+                cipher_type cipher;
+                block_type value;
+                std::uint64_t reseed_counter;
+                unsigned generation;
+            };
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_CTR_DRBG_HPP
@@ -35,6 +35,7 @@
 
 #include <nil/crypto3/block/accumulators/bits_count.hpp>
 #include <nil/crypto3/block/accumulators/parameters/bits.hpp>
+#include <nil/crypto3/block/accumulators/parameters/expected_bits.hpp>
 
 #include <boost/integer.hpp>
 #include <boost/cstdint.hpp>
@@ -85,6 +86,10 @@ namespace nil {
 
                 BOOST_STATIC_ASSERT(!length_bits || value_bits <= length_bits);
 
+                // Amount of blocks handed to the accumulator at once from contiguous input (about 1 KiB)
+                constexpr static const std::size_t batch_blocks = block_bits >= 8192 ? 1 : 8192 / block_bits;
+                typedef std::array<block_type, batch_blocks> batch_type;
+
                 inline void process_block(std::size_t block_seen = block_bits) {
                     using namespace nil::crypto3::detail;
                     // Convert the input into words
@@ -114,7 +119,31 @@ namespace nil {
 
                 template<typename InputIterator>
                 inline void update_n(InputIterator first, InputIterator last) {
+                    using namespace nil::crypto3::detail;
+
                     std::size_t n = std::distance(first, last);
+
+                    // Complete the partially filled cache first
+                    for (; n && cache_seen; --n) {
+                        update_one(*first++);
+                    }
+
+                    // Whole blocks are converted straight from the input and handed to the accumulator in
+                    // batches, so the cipher is able to process several blocks at once
+                    batch_type batch;
+                    while (n >= block_values) {
+                        std::size_t blocks = n / block_values < batch_blocks ? n / block_values : batch_blocks;
+
+                        for (std::size_t i = 0; i != blocks; ++i, first += block_values) {
+                            pack_to<endian_type, value_bits, actual_bits>(first, first + block_values,
+                                                                          batch[i].begin());
+                        }
+
+                        acc(batch, accumulators::bits = blocks * block_bits,
+                            accumulators::expected_bits = n * value_bits);
+                        n -= blocks * block_values;
+                    }
+
                     update_n(first, n);
                 }
 
@@ -26,8 +26,18 @@
 #ifndef CRYPTO3_CIPHER_MODES_HPP
 #define CRYPTO3_CIPHER_MODES_HPP
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
 #include <nil/crypto3/detail/stream_endian.hpp>
 
+#include <nil/crypto3/block/detail/ghash/ghash.hpp>
+
 namespace nil {
     namespace crypto3 {
         namespace block {
@@ -63,6 +73,11 @@ namespace nil {
                     inline static block_type end_message(const cipher_type &cipher, const block_type &plaintext) {
                         return cipher.encrypt(plaintext);
                     }
+
+                    inline static void process_blocks(const cipher_type &cipher, const block_type *plaintext,
+                                                      block_type *out, std::size_t blocks) {
+                        cipher.encrypt_blocks(plaintext, out, blocks);
+                    }
                 };
 
                 template<typename Cipher, typename Padding>
@@ -81,6 +96,11 @@ namespace nil {
                     inline static block_type end_message(const cipher_type &cipher, const block_type &ciphertext) {
                         return cipher.decrypt(ciphertext);
                     }
+
+                    inline static void process_blocks(const cipher_type &cipher, const block_type *ciphertext,
+                                                      block_type *out, std::size_t blocks) {
+                        cipher.decrypt_blocks(ciphertext, out, blocks);
+                    }
                 };
 
                 template<typename Policy>
@@ -115,6 +135,11 @@ namespace nil {
                         return policy_type::process_block(cipher, plaintext);
                     }
 
+                    void process_blocks(const block_type *plaintext, block_type *out, std::size_t blocks,
+                                        std::size_t total_seen) {
+                        policy_type::process_blocks(cipher, plaintext, out, blocks);
+                    }
+
                     block_type end_message(const block_type &plaintext, std::size_t total_seen) const {
                         return policy_type::end_message(cipher, plaintext);
                     }
@@ -122,21 +147,1903 @@ namespace nil {
                 protected:
                     cipher_type cipher;
                 };
-            }    // namespace detail
 
-            namespace modes {
+                /*!
+                 * @brief Blocks per cipher call of the counter mode pass for ciphers without a dedicated one.
+                 */
+                constexpr static const std::size_t counter_batch_blocks = 16;
 
-                template<typename Cipher, template<typename> class Padding>
-                struct isomorphic {
-                    typedef Cipher cipher_type;
-                    typedef Padding<Cipher> padding_type;
+                /*!
+                 * @brief Adds offset to the counter block, read as a big-endian integer over the
+                 * block words.
+                 */
+                template<typename BlockType>
+                inline BlockType advance_counter(BlockType counter, std::size_t offset) {
+                    typedef typename BlockType::value_type value_type;
+                    constexpr static const std::size_t value_bits = sizeof(value_type) * CHAR_BIT;
 
-                    typedef detail::isomorphic_encryption_policy<cipher_type, padding_type> encryption_policy;
-                    typedef detail::isomorphic_decryption_policy<cipher_type, padding_type> decryption_policy;
+                    unsigned long long carry = offset;
+                    for (std::size_t i = counter.size(); i-- != 0 && carry != 0;) {
+                        const value_type addend = static_cast<value_type>(carry);
+                        counter[i] = static_cast<value_type>(counter[i] + addend);
+                        const unsigned long long overflow = counter[i] < addend ? 1 : 0;
+                        carry = value_bits < sizeof(carry) * CHAR_BIT ?
+                                    (carry >> (value_bits % (sizeof(carry) * CHAR_BIT))) + overflow :
+                                    overflow;
+                    }
+                    return counter;
+                }
 
-                    template<typename Policy>
-                    struct bind {
-                        typedef detail::isomorphic<Policy> type;
+                /*!
+                 * @brief Counter mode pass built on a bulk encryption: batches of counter blocks are
+                 * encrypted in place by encrypt_batch(blocks, n) and XORed into the input. The keystream
+                 * is wiped on return.
+                 */
+                template<typename BlockType, typename EncryptBatch>
+                inline void counter_keystream(const EncryptBatch &encrypt_batch, const BlockType &counter,
+                                              const BlockType *in, BlockType *out, std::size_t blocks) {
+                    BlockType next = counter;
+                    BlockType stream[counter_batch_blocks];
+
+                    while (blocks != 0) {
+                        const std::size_t n = blocks < counter_batch_blocks ? blocks : counter_batch_blocks;
+                        for (std::size_t i = 0; i != n; ++i) {
+                            stream[i] = next;
+                            next = advance_counter(next, 1);
+                        }
+
+                        encrypt_batch(stream, n);
+
+                        for (std::size_t i = 0; i != n; ++i) {
+                            for (std::size_t j = 0; j != stream[i].size(); ++j) {
+                                out[i][j] = in[i][j] ^ stream[i][j];
+                            }
+                        }
+
+                        in += n;
+                        out += n;
+                        blocks -= n;
+                    }
+
+                    for (BlockType &block : stream) {
+                        block.fill(0);
+                    }
+                }
+
+                template<typename Cipher, typename Padding>
+                struct counter_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static block_type advance(const block_type &counter, std::size_t offset) {
+                        return advance_counter(counter, offset);
+                    }
+
+                    template<typename C, typename = void>
+                    struct keystream {
+                        static void process(const C &cipher, const block_type &counter, const block_type *in,
+                                            block_type *out, std::size_t blocks) {
+                            counter_keystream(
+                                [&cipher](block_type *stream, std::size_t n) {
+                                    cipher.encrypt_blocks(stream, stream, n);
+                                },
+                                counter, in, out, blocks);
+                        }
+                    };
+
+                    template<typename C>
+                    struct keystream<C, decltype(void(&C::encrypt_ctr))> {
+                        static void process(const C &cipher, const block_type &counter, const block_type *in,
+                                            block_type *out, std::size_t blocks) {
+                            cipher.encrypt_ctr(counter, in, out, blocks);
+                        }
+                    };
+
+                    inline static void process_blocks(const cipher_type &cipher, const block_type &counter,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        keystream<cipher_type>::process(cipher, counter, in, out, blocks);
+                    }
+                };
+
+                /*!
+                 * @brief Counter (CTR) mode. The keystream block for the block number i of the message
+                 * is the encryption of iv + i, so any part of the message is processed independently
+                 * of the rest. Encryption and decryption are the same operation.
+                 */
+                template<typename Policy>
+                class counter {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    counter(const cipher_type &cipher, const block_type &iv) : cipher(cipher), iv(iv) {
+                    }
+
+                    block_type begin_message(const block_type &plaintext, std::size_t total_seen) {
+                        return process_block(plaintext, total_seen);
+                    }
+
+                    block_type process_block(const block_type &plaintext, std::size_t total_seen) {
+                        block_type out;
+                        process_blocks(&plaintext, &out, 1, total_seen);
+                        return out;
+                    }
+
+                    void process_blocks(const block_type *plaintext, block_type *out, std::size_t blocks,
+                                        std::size_t total_seen) {
+                        process_blocks_at(plaintext, out, blocks, block_index(total_seen));
+                    }
+
+                    block_type end_message(const block_type &plaintext, std::size_t total_seen) const {
+                        block_type out;
+                        process_blocks_at(&plaintext, &out, 1, block_index(total_seen));
+                        return out;
+                    }
+
+                    /*!
+                     * @return Counter block of the block number index of the message
+                     */
+                    block_type counter_at(std::size_t index) const {
+                        return policy_type::advance(iv, index);
+                    }
+
+                    /*!
+                     * @brief Processes blocks starting at the block number first_block of the message,
+                     * without touching anything before it.
+                     */
+                    void process_blocks_at(const block_type *in, block_type *out, std::size_t blocks,
+                                           std::size_t first_block) const {
+                        policy_type::process_blocks(cipher, counter_at(first_block), in, out, blocks);
+                    }
+
+                protected:
+                    // Bits seen so far include the block being processed, which may be incomplete
+                    static std::size_t block_index(std::size_t total_seen) {
+                        return total_seen ? (total_seen - 1) / block_bits : 0;
+                    }
+
+                    cipher_type cipher;
+                    block_type iv;
+                };
+
+                /*!
+                 * @brief Blocks per bulk cipher call in the parallel directions of chained modes. The
+                 * batch stays in L1 and is long enough to fill the widest interleave several times.
+                 */
+                constexpr static const std::size_t chained_batch_blocks = 32;
+
+                /*!
+                 * @brief XORs two blocks 64 bits at a time. Going through memcpy keeps it free of
+                 * aliasing assumptions, so out may be either of the inputs.
+                 */
+                template<typename BlockType>
+                inline void xor_block(const BlockType &a, const BlockType &b, BlockType &out) {
+                    constexpr static const std::size_t lanes = sizeof(BlockType) / sizeof(std::uint64_t);
+                    BOOST_STATIC_ASSERT(sizeof(BlockType) % sizeof(std::uint64_t) == 0);
+
+                    std::uint64_t x[lanes], y[lanes];
+                    std::memcpy(x, a.data(), sizeof(BlockType));
+                    std::memcpy(y, b.data(), sizeof(BlockType));
+                    for (std::size_t i = 0; i != lanes; ++i) {
+                        x[i] ^= y[i];
+                    }
+                    std::memcpy(out.data(), x, sizeof(BlockType));
+                }
+
+                template<typename Cipher, typename Padding>
+                struct cbc_encryption_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    // Every block depends on the previous ciphertext, so this direction stays serial
+                    inline static void process_blocks(const cipher_type &cipher, block_type &previous,
+                                                      const block_type *plaintext, block_type *out,
+                                                      std::size_t blocks) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(plaintext[i], previous, previous);
+                            previous = cipher.encrypt(previous);
+                            out[i] = previous;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct cbc_decryption_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    /*
+                     * Blocks are decrypted independently through the bulk path, then XORed with the
+                     * ciphertext shifted by one block. The XOR runs backwards, so in-place processing
+                     * never overwrites a ciphertext block before it is used.
+                     */
+                    inline static void process_blocks(const cipher_type &cipher, block_type &previous,
+                                                      const block_type *ciphertext, block_type *out,
+                                                      std::size_t blocks) {
+                        block_type decrypted[chained_batch_blocks];
+
+                        while (blocks != 0) {
+                            const std::size_t n = blocks < chained_batch_blocks ? blocks : chained_batch_blocks;
+                            const block_type last = ciphertext[n - 1];
+
+                            cipher.decrypt_blocks(ciphertext, decrypted, n);
+                            for (std::size_t i = n - 1; i != 0; --i) {
+                                xor_block(decrypted[i], ciphertext[i - 1], out[i]);
+                            }
+                            xor_block(decrypted[0], previous, out[0]);
+                            previous = last;
+
+                            ciphertext += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct cfb_encryption_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, block_type &previous,
+                                                      const block_type *plaintext, block_type *out,
+                                                      std::size_t blocks) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(cipher.encrypt(previous), plaintext[i], previous);
+                            out[i] = previous;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct cfb_decryption_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    // Keystream is the encryption of the ciphertext shifted by one block, all known upfront
+                    inline static void process_blocks(const cipher_type &cipher, block_type &previous,
+                                                      const block_type *ciphertext, block_type *out,
+                                                      std::size_t blocks) {
+                        block_type stream[chained_batch_blocks];
+
+                        while (blocks != 0) {
+                            const std::size_t n = blocks < chained_batch_blocks ? blocks : chained_batch_blocks;
+
+                            stream[0] = cipher.encrypt(previous);
+                            cipher.encrypt_blocks(ciphertext, stream + 1, n - 1);
+                            previous = ciphertext[n - 1];
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                xor_block(stream[i], ciphertext[i], out[i]);
+                            }
+
+                            ciphertext += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ofb_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    // Every keystream block is the encryption of the previous one, so both directions stay serial
+                    inline static void process_blocks(const cipher_type &cipher, block_type &previous,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            previous = cipher.encrypt(previous);
+                            xor_block(in[i], previous, out[i]);
+                        }
+                    }
+                };
+
+                /*!
+                 * @brief Mode chaining each block to the previous ciphertext block, starting from the
+                 * initialization vector: CBC and full-block CFB. OFB chains the keystream blocks instead.
+                 */
+                template<typename Policy>
+                class chained {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    chained(const cipher_type &cipher, const block_type &iv) : cipher(cipher), previous(iv) {
+                    }
+
+                    block_type begin_message(const block_type &plaintext, std::size_t total_seen) {
+                        return process_block(plaintext, total_seen);
+                    }
+
+                    block_type process_block(const block_type &plaintext, std::size_t total_seen) {
+                        block_type out;
+                        policy_type::process_blocks(cipher, previous, &plaintext, &out, 1);
+                        return out;
+                    }
+
+                    void process_blocks(const block_type *plaintext, block_type *out, std::size_t blocks,
+                                        std::size_t total_seen) {
+                        policy_type::process_blocks(cipher, previous, plaintext, out, blocks);
+                    }
+
+                    block_type end_message(const block_type &plaintext, std::size_t total_seen) const {
+                        block_type out, last = previous;
+                        policy_type::process_blocks(cipher, last, &plaintext, &out, 1);
+                        return out;
+                    }
+
+                protected:
+                    cipher_type cipher;
+                    block_type previous;
+                };
+
+                /*!
+                 * @brief Extension point for ciphers with a dedicated XTS pass over whole blocks, see
+                 * gcm_backend. Without one the policies run batches of masked blocks through the bulk path.
+                 */
+                template<typename Cipher, typename = void>
+                struct xts_backend {
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &, block_type &, const block_type *, block_type *, std::size_t) {
+                        return false;
+                    }
+
+                    static bool decrypt(const Cipher &, block_type &, const block_type *, block_type *, std::size_t) {
+                        return false;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct xts_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    BOOST_STATIC_ASSERT(cipher_type::block_bits == 128 && sizeof(block_type) == 16);
+
+                    constexpr static const std::size_t block_bytes = sizeof(block_type);
+
+                    /*!
+                     * @brief Multiplies the tweak, a little-endian element of GF(2^128), by the
+                     * primitive element.
+                     */
+                    inline static void multiply_alpha(block_type &tweak) {
+                        const std::uint8_t carry = tweak[block_bytes - 1] >> 7;
+                        for (std::size_t j = block_bytes - 1; j != 0; --j) {
+                            tweak[j] = static_cast<std::uint8_t>((tweak[j] << 1) | (tweak[j - 1] >> 7));
+                        }
+                        tweak[0] = static_cast<std::uint8_t>((tweak[0] << 1) ^ (0x87 & -carry));
+                    }
+
+                    // Ciphers without a dedicated XTS pass run batches of masked blocks through the bulk path
+                    template<typename Process>
+                    inline static void process_masked(const Process &process, block_type &tweak,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        block_type tweaks[chained_batch_blocks], buffer[chained_batch_blocks];
+
+                        while (blocks != 0) {
+                            const std::size_t n = blocks < chained_batch_blocks ? blocks : chained_batch_blocks;
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                tweaks[i] = tweak;
+                                multiply_alpha(tweak);
+                                xor_block(in[i], tweaks[i], buffer[i]);
+                            }
+                            process(buffer, n);
+                            for (std::size_t i = 0; i != n; ++i) {
+                                xor_block(buffer[i], tweaks[i], out[i]);
+                            }
+
+                            in += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct xts_encryption_policy : public xts_policy<Cipher, Padding> {
+                    typedef typename xts_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename xts_policy<Cipher, Padding>::block_type block_type;
+
+                    using xts_policy<Cipher, Padding>::block_bytes;
+
+                    inline static void process_blocks(const cipher_type &cipher, block_type &tweak,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        if (!xts_backend<cipher_type>::encrypt(cipher, tweak, in, out, blocks)) {
+                            xts_policy<Cipher, Padding>::process_masked(
+                                [&cipher](block_type *buffer, std::size_t n) {
+                                    cipher.encrypt_blocks(buffer, buffer, n);
+                                },
+                                tweak, in, out, blocks);
+                        }
+                    }
+
+                    /*!
+                     * @brief Ciphertext stealing over the last full block and the tail bytes after it. The
+                     * full block is encrypted first, its leading bytes become the tail of the output and
+                     * the rest pads the tail of the input, which is encrypted under the next tweak.
+                     */
+                    inline static void process_tail(const cipher_type &cipher, block_type &tweak,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t tail) {
+                        block_type last, stolen;
+                        std::memcpy(last.data(), in, block_bytes);
+                        process_blocks(cipher, tweak, &last, &last, 1);
+
+                        std::memcpy(stolen.data(), in + block_bytes, tail);
+                        std::memcpy(stolen.data() + tail, last.data() + tail, block_bytes - tail);
+                        std::memcpy(out + block_bytes, last.data(), tail);
+
+                        process_blocks(cipher, tweak, &stolen, &stolen, 1);
+                        std::memcpy(out, stolen.data(), block_bytes);
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct xts_decryption_policy : public xts_policy<Cipher, Padding> {
+                    typedef typename xts_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename xts_policy<Cipher, Padding>::block_type block_type;
+
+                    using xts_policy<Cipher, Padding>::block_bytes;
+
+                    inline static void process_blocks(const cipher_type &cipher, block_type &tweak,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        if (!xts_backend<cipher_type>::decrypt(cipher, tweak, in, out, blocks)) {
+                            xts_policy<Cipher, Padding>::process_masked(
+                                [&cipher](block_type *buffer, std::size_t n) {
+                                    cipher.decrypt_blocks(buffer, buffer, n);
+                                },
+                                tweak, in, out, blocks);
+                        }
+                    }
+
+                    // Undoes the stealing of the encryption, which used the two tweaks in the opposite order
+                    inline static void process_tail(const cipher_type &cipher, block_type &tweak,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t tail) {
+                        block_type next = tweak, stolen, last;
+                        xts_policy<Cipher, Padding>::multiply_alpha(next);
+
+                        std::memcpy(stolen.data(), in, block_bytes);
+                        process_blocks(cipher, next, &stolen, &stolen, 1);
+
+                        std::memcpy(last.data(), in + block_bytes, tail);
+                        std::memcpy(last.data() + tail, stolen.data() + tail, block_bytes - tail);
+                        std::memcpy(out + block_bytes, stolen.data(), tail);
+
+                        process_blocks(cipher, tweak, &last, &last, 1);
+                        std::memcpy(out, last.data(), block_bytes);
+                    }
+                };
+
+                /*!
+                 * @brief XTS mode (IEEE 1619) over data units such as disk sectors. The tweak of a data
+                 * unit is the encryption of its sequence number under the tweak cipher, so every sector
+                 * is processed on its own and in any order. Data units need not be a multiple of the
+                 * block size, the last partial block is handled by ciphertext stealing.
+                 */
+                template<typename Policy>
+                class xts {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    constexpr static const size_type block_bytes = policy_type::block_bytes;
+
+                    /*!
+                     * @param cipher Cipher keyed with the first half of the XTS key
+                     * @param tweak_cipher Cipher keyed with the second half of the XTS key
+                     */
+                    xts(const cipher_type &cipher, const cipher_type &tweak_cipher) :
+                        cipher(cipher), tweak_cipher(tweak_cipher) {
+                    }
+
+                    /*!
+                     * @return Tweak of the first block of the data unit number sector
+                     */
+                    block_type tweak_at(std::uint64_t sector) const {
+                        return tweak_cipher.encrypt(sequence_block(sector));
+                    }
+
+                    /*!
+                     * @brief Processes a single data unit.
+                     * @param length Data unit length in bytes, at least one block
+                     */
+                    void process_sector(std::uint64_t sector, const std::uint8_t *in, std::uint8_t *out,
+                                        std::size_t length) const {
+                        block_type tweak = tweak_at(sector);
+                        process_unit(tweak, in, out, length);
+                    }
+
+                    /*!
+                     * @brief Processes consecutive data units of the same size, numbered from first_sector.
+                     * Their tweaks are encrypted in batches through the bulk cipher path.
+                     */
+                    void process_sectors(std::uint64_t first_sector, const std::uint8_t *in, std::uint8_t *out,
+                                         std::size_t sector_size, std::size_t sectors) const {
+                        block_type tweaks[chained_batch_blocks];
+
+                        while (sectors != 0) {
+                            const std::size_t n = sectors < chained_batch_blocks ? sectors : chained_batch_blocks;
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                tweaks[i] = sequence_block(first_sector + i);
+                            }
+                            tweak_cipher.encrypt_blocks(tweaks, tweaks, n);
+
+                            for (std::size_t i = 0; i != n; ++i, in += sector_size, out += sector_size) {
+                                process_unit(tweaks[i], in, out, sector_size);
+                            }
+
+                            first_sector += n;
+                            sectors -= n;
+                        }
+                    }
+
+                protected:
+                    static block_type sequence_block(std::uint64_t sector) {
+                        block_type block = {0};
+                        for (std::size_t j = 0; j != sizeof(sector); ++j) {
+                            block[j] = static_cast<std::uint8_t>(sector >> (8 * j));
+                        }
+                        return block;
+                    }
+
+                    void process_unit(block_type &tweak, const std::uint8_t *in, std::uint8_t *out,
+                                      std::size_t length) const {
+                        BOOST_ASSERT(length >= block_bytes);
+
+                        const std::size_t tail = length % block_bytes;
+                        const std::size_t blocks = length / block_bytes - (tail ? 1 : 0);
+
+                        policy_type::process_blocks(cipher, tweak, reinterpret_cast<const block_type *>(in),
+                                                    reinterpret_cast<block_type *>(out), blocks);
+                        if (tail) {
+                            policy_type::process_tail(cipher, tweak, in + blocks * block_bytes,
+                                                      out + blocks * block_bytes, tail);
+                        }
+                    }
+
+                    cipher_type cipher, tweak_cipher;
+                };
+
+                /*!
+                 * @brief Extension point for ciphers with a fused GCM pass over whole blocks, specialized
+                 * next to the cipher. encrypt and decrypt return false if the cipher at hand has no such
+                 * pass, and the batched one of gcm_policy runs instead.
+                 */
+                template<typename Cipher, typename = void>
+                struct gcm_backend {
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &, const ghash_key &, block_type &, block_type &,
+                                        const block_type *, block_type *, std::size_t) {
+                        return false;
+                    }
+
+                    static bool decrypt(const Cipher &, const ghash_key &, block_type &, block_type &,
+                                        const block_type *, block_type *, std::size_t) {
+                        return false;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct gcm_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    BOOST_STATIC_ASSERT(cipher_type::block_bits == 128 && sizeof(block_type) == 16);
+
+                    constexpr static const std::size_t block_bytes = sizeof(block_type);
+
+                    /*!
+                     * @brief Increments the last 32 bits of the counter block, leaving the rest of it as is.
+                     */
+                    inline static void increment(block_type &counter) {
+                        for (std::size_t j = block_bytes; j-- != block_bytes - 4 && ++counter[j] == 0;) {
+                        }
+                    }
+
+                    // Ciphers without a fused pass hash batches of ciphertext right after the keystream is applied
+                    template<bool Decrypt>
+                    inline static void process_batched(const cipher_type &cipher, const ghash_key &key,
+                                                       block_type &counter, block_type &hash, const block_type *in,
+                                                       block_type *out, std::size_t blocks) {
+                        block_type stream[chained_batch_blocks];
+
+                        while (blocks != 0) {
+                            const std::size_t n = blocks < chained_batch_blocks ? blocks : chained_batch_blocks;
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                stream[i] = counter;
+                                increment(counter);
+                            }
+                            cipher.encrypt_blocks(stream, stream, n);
+
+                            if (Decrypt) {
+                                ghash::update(key, hash.data(), in->data(), n);
+                            }
+                            for (std::size_t i = 0; i != n; ++i) {
+                                xor_block(in[i], stream[i], out[i]);
+                            }
+                            if (!Decrypt) {
+                                ghash::update(key, hash.data(), out->data(), n);
+                            }
+
+                            in += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct gcm_encryption_policy : public gcm_policy<Cipher, Padding> {
+                    typedef typename gcm_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename gcm_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, const ghash_key &key,
+                                                      block_type &counter, block_type &hash, const block_type *in,
+                                                      block_type *out, std::size_t blocks) {
+                        if (!gcm_backend<cipher_type>::encrypt(cipher, key, counter, hash, in, out, blocks)) {
+                            gcm_policy<Cipher, Padding>::template process_batched<false>(cipher, key, counter, hash,
+                                                                                         in, out, blocks);
+                        }
+                    }
+
+                    // The partial ciphertext block is hashed padded with zeros
+                    inline static void process_tail(const cipher_type &cipher, const ghash_key &key,
+                                                    block_type &counter, block_type &hash, const std::uint8_t *in,
+                                                    std::uint8_t *out, std::size_t size) {
+                        const block_type stream = cipher.encrypt(counter);
+                        gcm_policy<Cipher, Padding>::increment(counter);
+
+                        block_type last = {0};
+                        for (std::size_t i = 0; i != size; ++i) {
+                            last[i] = in[i] ^ stream[i];
+                        }
+                        std::memcpy(out, last.data(), size);
+                        ghash::update(key, hash.data(), last.data(), 1);
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct gcm_decryption_policy : public gcm_policy<Cipher, Padding> {
+                    typedef typename gcm_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename gcm_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, const ghash_key &key,
+                                                      block_type &counter, block_type &hash, const block_type *in,
+                                                      block_type *out, std::size_t blocks) {
+                        if (!gcm_backend<cipher_type>::decrypt(cipher, key, counter, hash, in, out, blocks)) {
+                            gcm_policy<Cipher, Padding>::template process_batched<true>(cipher, key, counter, hash,
+                                                                                        in, out, blocks);
+                        }
+                    }
+
+                    inline static void process_tail(const cipher_type &cipher, const ghash_key &key,
+                                                    block_type &counter, block_type &hash, const std::uint8_t *in,
+                                                    std::uint8_t *out, std::size_t size) {
+                        const block_type stream = cipher.encrypt(counter);
+                        gcm_policy<Cipher, Padding>::increment(counter);
+
+                        block_type last = {0};
+                        std::memcpy(last.data(), in, size);
+                        ghash::update(key, hash.data(), last.data(), 1);
+                        for (std::size_t i = 0; i != size; ++i) {
+                            out[i] = last[i] ^ stream[i];
+                        }
+                    }
+                };
+
+                /*!
+                 * @brief Galois/Counter Mode (NIST SP 800-38D). Additional data is absorbed first, then
+                 * the text is processed in one pass which both runs the counter mode and hashes the
+                 * ciphertext. Decryption hashes the ciphertext on the way in, so the tag can be checked
+                 * right after the last call. The output of a failed check must be discarded.
+                 *
+                 * Additional data and text may each be split over several calls, all but the last of
+                 * them a multiple of the block size.
+                 */
+                template<typename Policy>
+                class gcm {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    constexpr static const size_type block_bytes = policy_type::block_bytes;
+
+                    /*!
+                     * @param iv Initialization vector, 96 bits are used as is and other lengths are hashed
+                     */
+                    gcm(const cipher_type &cipher, const std::uint8_t *iv, std::size_t iv_size) :
+                        cipher(cipher), hash(), aad_size(0), text_size(0) {
+                        block_type h = {0};
+                        h = cipher.encrypt(h);
+                        ghash::schedule(h.data(), key);
+
+                        counter.fill(0);
+                        if (iv_size == 12) {
+                            std::memcpy(counter.data(), iv, iv_size);
+                            counter[block_bytes - 1] = 1;
+                        } else {
+                            absorb(counter, iv, iv_size);
+                            absorb_lengths(counter, 0, iv_size);
+                        }
+
+                        mask = cipher.encrypt(counter);
+                        policy_type::increment(counter);
+                    }
+
+                    /*!
+                     * @brief Absorbs additional authenticated data. Must come before any text.
+                     */
+                    void process_aad(const std::uint8_t *aad, std::size_t size) {
+                        BOOST_ASSERT(text_size == 0 && aad_size % block_bytes == 0);
+
+                        absorb(hash, aad, size);
+                        aad_size += size;
+                    }
+
+                    /*!
+                     * @brief Encrypts or decrypts the text and authenticates the ciphertext.
+                     * @param out Output, may be the same as in
+                     */
+                    void process(const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        BOOST_ASSERT(text_size % block_bytes == 0);
+
+                        const std::size_t blocks = size / block_bytes, tail = size % block_bytes;
+                        policy_type::process_blocks(cipher, key, counter, hash,
+                                                    reinterpret_cast<const block_type *>(in),
+                                                    reinterpret_cast<block_type *>(out), blocks);
+                        if (tail) {
+                            policy_type::process_tail(cipher, key, counter, hash, in + blocks * block_bytes,
+                                                      out + blocks * block_bytes, tail);
+                        }
+                        text_size += size;
+                    }
+
+                    /*!
+                     * @brief Computes the authentication tag of everything processed so far.
+                     * @param size Tag length in bytes, the tag being truncated from the right
+                     */
+                    void tag(std::uint8_t *out, std::size_t size = block_bytes) const {
+                        BOOST_ASSERT(size <= block_bytes);
+
+                        block_type final_hash = hash;
+                        absorb_lengths(final_hash, aad_size, text_size);
+                        for (std::size_t i = 0; i != size; ++i) {
+                            out[i] = final_hash[i] ^ mask[i];
+                        }
+                    }
+
+                    /*!
+                     * @brief Compares the tag with the expected one in constant time.
+                     */
+                    bool verify(const std::uint8_t *expected, std::size_t size = block_bytes) const {
+                        block_type computed;
+                        tag(computed.data(), size);
+
+                        std::uint8_t difference = 0;
+                        for (std::size_t i = 0; i != size; ++i) {
+                            difference |= computed[i] ^ expected[i];
+                        }
+                        return size != 0 && difference == 0;
+                    }
+
+                protected:
+                    // Hashes the data padded with zeros to a whole amount of blocks
+                    void absorb(block_type &state, const std::uint8_t *data, std::size_t size) const {
+                        const std::size_t blocks = size / block_bytes, tail = size % block_bytes;
+                        ghash::update(key, state.data(), data, blocks);
+                        if (tail) {
+                            block_type last = {0};
+                            std::memcpy(last.data(), data + blocks * block_bytes, tail);
+                            ghash::update(key, state.data(), last.data(), 1);
+                        }
+                    }
+
+                    // Hashes the bit lengths of the two parts as 64-bit big-endian integers
+                    void absorb_lengths(block_type &state, std::uint64_t first, std::uint64_t second) const {
+                        block_type lengths;
+                        for (std::size_t i = 0; i != 8; ++i) {
+                            lengths[i] = static_cast<std::uint8_t>((first * 8) >> (56 - 8 * i));
+                            lengths[8 + i] = static_cast<std::uint8_t>((second * 8) >> (56 - 8 * i));
+                        }
+                        ghash::update(key, state.data(), lengths.data(), 1);
+                    }
+
+                    cipher_type cipher;
+                    ghash_key key;
+                    block_type counter, mask, hash;
+                    std::uint64_t aad_size, text_size;
+                };
+
+                /*!
+                 * @brief Extension point for ciphers with a fused CCM pass over whole blocks, see
+                 * gcm_backend. Without one the batched pass of ccm_policy runs.
+                 */
+                template<typename Cipher, typename = void>
+                struct ccm_backend {
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &, block_type &, block_type &, const block_type *, block_type *,
+                                        std::size_t) {
+                        return false;
+                    }
+
+                    static bool decrypt(const Cipher &, block_type &, block_type &, const block_type *, block_type *,
+                                        std::size_t) {
+                        return false;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ccm_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    BOOST_STATIC_ASSERT(cipher_type::block_bits == 128 && sizeof(block_type) == 16);
+
+                    constexpr static const std::size_t block_bytes = sizeof(block_type);
+
+                    /*!
+                     * @brief Increments the counter block as a big-endian integer. The counter field never
+                     * overflows for messages within the length the nonce size allows, so the carry stays in it.
+                     */
+                    inline static void increment(block_type &counter) {
+                        for (std::size_t j = block_bytes; j-- != 0 && ++counter[j] == 0;) {
+                        }
+                    }
+
+                    // Ciphers without a fused pass run the MAC chain over a batch after its keystream
+                    template<bool Decrypt>
+                    inline static void process_batched(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                       const block_type *in, block_type *out, std::size_t blocks) {
+                        block_type stream[chained_batch_blocks];
+
+                        while (blocks != 0) {
+                            const std::size_t n = blocks < chained_batch_blocks ? blocks : chained_batch_blocks;
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                stream[i] = counter;
+                                increment(counter);
+                            }
+                            cipher.encrypt_blocks(stream, stream, n);
+
+                            for (std::size_t i = 0; i != n; ++i) {
+                                // Input and output may alias, the plaintext is MACed while it is in either
+                                if (!Decrypt) {
+                                    xor_block(mac, in[i], mac);
+                                }
+                                xor_block(in[i], stream[i], out[i]);
+                                if (Decrypt) {
+                                    xor_block(mac, out[i], mac);
+                                }
+                                mac = cipher.encrypt(mac);
+                            }
+
+                            in += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+
+                    // The partial block is MACed padded with zeros
+                    template<bool Decrypt>
+                    inline static void process_tail(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        const block_type stream = cipher.encrypt(counter);
+                        increment(counter);
+
+                        for (std::size_t i = 0; i != size; ++i) {
+                            const std::uint8_t plaintext = Decrypt ? in[i] ^ stream[i] : in[i];
+                            out[i] = in[i] ^ stream[i];
+                            mac[i] ^= plaintext;
+                        }
+                        mac = cipher.encrypt(mac);
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ccm_encryption_policy : public ccm_policy<Cipher, Padding> {
+                    typedef typename ccm_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename ccm_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        if (!ccm_backend<cipher_type>::encrypt(cipher, counter, mac, in, out, blocks)) {
+                            ccm_policy<Cipher, Padding>::template process_batched<false>(cipher, counter, mac, in, out,
+                                                                                         blocks);
+                        }
+                    }
+
+                    inline static void process_tail(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        ccm_policy<Cipher, Padding>::template process_tail<false>(cipher, counter, mac, in, out, size);
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ccm_decryption_policy : public ccm_policy<Cipher, Padding> {
+                    typedef typename ccm_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename ccm_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                      const block_type *in, block_type *out, std::size_t blocks) {
+                        if (!ccm_backend<cipher_type>::decrypt(cipher, counter, mac, in, out, blocks)) {
+                            ccm_policy<Cipher, Padding>::template process_batched<true>(cipher, counter, mac, in, out,
+                                                                                        blocks);
+                        }
+                    }
+
+                    inline static void process_tail(const cipher_type &cipher, block_type &counter, block_type &mac,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        ccm_policy<Cipher, Padding>::template process_tail<true>(cipher, counter, mac, in, out, size);
+                    }
+                };
+
+                /*!
+                 * @brief Counter with CBC-MAC (NIST SP 800-38C, RFC 3610). The lengths of the additional
+                 * data and of the text are part of the first MAC block, so both are fixed on construction.
+                 * The text is encrypted and MACed in one pass. Decryption MACs the recovered plaintext,
+                 * and its output must be discarded if the tag does not verify.
+                 *
+                 * Additional data may be split over calls arbitrarily, text over calls all but the last
+                 * of them a multiple of the block size.
+                 */
+                template<typename Policy>
+                class ccm {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    constexpr static const size_type block_bytes = policy_type::block_bytes;
+
+                    /*!
+                     * @param nonce Nonce of 7 to 13 bytes, the rest of the counter block encodes lengths
+                     * @param aad_size Total size of the additional data
+                     * @param text_size Total size of the text
+                     * @param tag_size Tag length, an even number of bytes from 4 to 16
+                     */
+                    ccm(const cipher_type &cipher, const std::uint8_t *nonce, std::size_t nonce_size,
+                        std::uint64_t aad_size, std::uint64_t text_size, std::size_t tag_size = block_bytes) :
+                        cipher(cipher),
+                        aad_size(aad_size), text_size(text_size), tag_size(tag_size), aad_processed(0),
+                        text_processed(0), aad_fill(0) {
+                        BOOST_ASSERT(nonce_size >= 7 && nonce_size <= 13);
+                        BOOST_ASSERT(tag_size >= 4 && tag_size <= block_bytes && tag_size % 2 == 0);
+
+                        // The length field takes the rest of the block and has to hold the text size
+                        const std::size_t length_size = block_bytes - 1 - nonce_size;
+                        BOOST_ASSERT(length_size >= 8 || (text_size >> (8 * length_size)) == 0);
+
+                        counter.fill(0);
+                        counter[0] = static_cast<std::uint8_t>(length_size - 1);
+                        std::memcpy(counter.data() + 1, nonce, nonce_size);
+
+                        mac = counter;
+                        mac[0] |= static_cast<std::uint8_t>((aad_size != 0 ? 0x40 : 0) | (((tag_size - 2) / 2) << 3));
+                        store_be(text_size, mac.data() + 1 + nonce_size, length_size);
+                        mac = cipher.encrypt(mac);
+
+                        mask = cipher.encrypt(counter);
+                        policy_type::increment(counter);
+
+                        // The additional data is preceded by its length in 2, 6 or 10 bytes
+                        aad_buffer.fill(0);
+                        if (aad_size != 0 && aad_size < 0xff00) {
+                            store_be(aad_size, aad_buffer.data(), 2);
+                            aad_fill = 2;
+                        } else if (aad_size != 0) {
+                            const bool wide = (aad_size >> 32) != 0;
+                            aad_buffer[0] = 0xff;
+                            aad_buffer[1] = wide ? 0xff : 0xfe;
+                            store_be(aad_size, aad_buffer.data() + 2, wide ? 8 : 4);
+                            aad_fill = wide ? 10 : 6;
+                        }
+                    }
+
+                    /*!
+                     * @brief Absorbs additional authenticated data. Must come before any text.
+                     */
+                    void process_aad(const std::uint8_t *aad, std::size_t size) {
+                        BOOST_ASSERT(text_processed == 0 && aad_processed + size <= aad_size);
+
+                        aad_processed += size;
+                        while (size != 0) {
+                            const std::size_t n = size < block_bytes - aad_fill ? size : block_bytes - aad_fill;
+                            std::memcpy(aad_buffer.data() + aad_fill, aad, n);
+                            aad_fill += n;
+                            aad += n;
+                            size -= n;
+
+                            if (aad_fill == block_bytes) {
+                                xor_block(mac, aad_buffer, mac);
+                                mac = cipher.encrypt(mac);
+                                aad_buffer.fill(0);
+                                aad_fill = 0;
+                            }
+                        }
+                    }
+
+                    /*!
+                     * @brief Encrypts or decrypts the text and MACs the plaintext.
+                     * @param out Output, may be the same as in
+                     */
+                    void process(const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        BOOST_ASSERT(aad_processed == aad_size && text_processed % block_bytes == 0);
+                        BOOST_ASSERT(text_processed + size <= text_size);
+
+                        if (aad_fill != 0) {
+                            xor_block(mac, aad_buffer, mac);
+                            mac = cipher.encrypt(mac);
+                            aad_fill = 0;
+                        }
+
+                        const std::size_t blocks = size / block_bytes, tail = size % block_bytes;
+                        policy_type::process_blocks(cipher, counter, mac, reinterpret_cast<const block_type *>(in),
+                                                    reinterpret_cast<block_type *>(out), blocks);
+                        if (tail) {
+                            policy_type::process_tail(cipher, counter, mac, in + blocks * block_bytes,
+                                                      out + blocks * block_bytes, tail);
+                        }
+                        text_processed += size;
+                    }
+
+                    /*!
+                     * @brief Computes the authentication tag, once all the additional data and text
+                     * announced on construction have been processed.
+                     */
+                    void tag(std::uint8_t *out) const {
+                        BOOST_ASSERT(aad_processed == aad_size && text_processed == text_size);
+
+                        block_type final_mac = mac;
+                        if (aad_fill != 0) {
+                            xor_block(final_mac, aad_buffer, final_mac);
+                            final_mac = cipher.encrypt(final_mac);
+                        }
+                        for (std::size_t i = 0; i != tag_size; ++i) {
+                            out[i] = final_mac[i] ^ mask[i];
+                        }
+                    }
+
+                    /*!
+                     * @brief Compares the tag with the expected one in constant time.
+                     */
+                    bool verify(const std::uint8_t *expected) const {
+                        block_type computed;
+                        tag(computed.data());
+
+                        std::uint8_t difference = 0;
+                        for (std::size_t i = 0; i != tag_size; ++i) {
+                            difference |= computed[i] ^ expected[i];
+                        }
+                        return difference == 0;
+                    }
+
+                protected:
+                    static void store_be(std::uint64_t value, std::uint8_t *out, std::size_t size) {
+                        for (std::size_t i = size; i-- != 0; value >>= 8) {
+                            out[i] = static_cast<std::uint8_t>(value);
+                        }
+                    }
+
+                    cipher_type cipher;
+                    block_type counter, mask, mac, aad_buffer;
+                    std::uint64_t aad_size, text_size;
+                    std::size_t tag_size;
+                    std::uint64_t aad_processed, text_processed;
+                    std::size_t aad_fill;
+                };
+
+                /*!
+                 * @brief Extension point for ciphers with a dedicated OCB pass over whole blocks with
+                 * precomputed offsets, see gcm_backend. Without one the policies whiten a batch of blocks
+                 * around a single bulk cipher call.
+                 */
+                template<typename Cipher, typename = void>
+                struct ocb_backend {
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &, const block_type *, const block_type *, block_type *,
+                                        std::size_t, block_type &) {
+                        return false;
+                    }
+
+                    static bool decrypt(const Cipher &, const block_type *, const block_type *, block_type *,
+                                        std::size_t, block_type &) {
+                        return false;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ocb_policy : public isomorphic_policy<Cipher, Padding> {
+                    typedef typename isomorphic_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename isomorphic_policy<Cipher, Padding>::block_type block_type;
+
+                    BOOST_STATIC_ASSERT(cipher_type::block_bits == 128 && sizeof(block_type) == 16);
+
+                    constexpr static const std::size_t block_bytes = sizeof(block_type);
+
+                    /*!
+                     * @brief Multiplies the block by x in GF(2^128), big-endian as OCB defines it.
+                     */
+                    inline static block_type multiply_x(const block_type &block) {
+                        block_type out;
+                        for (std::size_t i = 0; i != block_bytes - 1; ++i) {
+                            out[i] = static_cast<std::uint8_t>((block[i] << 1) | (block[i + 1] >> 7));
+                        }
+                        out[block_bytes - 1] =
+                            static_cast<std::uint8_t>((block[block_bytes - 1] << 1) ^ (0x87 & -(block[0] >> 7)));
+                        return out;
+                    }
+                };
+
+                /*!
+                 * @brief Offsets of the OCB and PMAC block sequences, where offset i is offset i - 1
+                 * XORed with L_ntz(i) and L_k is the first mask doubled k times. Within a group of
+                 * group_blocks blocks ntz(i) only depends on the position, so the offsets of a group
+                 * are one XOR of a precomputed sum away from the offset the previous group ended with.
+                 */
+                template<typename Policy>
+                class gray_code_offsets {
+                    typedef typename Policy::block_type block_type;
+
+                public:
+                    constexpr static const std::size_t group_blocks = 8;
+
+                    void schedule(const block_type &first) {
+                        l[0] = first;
+                        for (std::size_t i = 1; i != l_count; ++i) {
+                            l[i] = Policy::multiply_x(l[i - 1]);
+                        }
+
+                        // group_sums[k] is L_ntz(1) ^ ... ^ L_ntz(k)
+                        group_sums[0].fill(0);
+                        for (std::size_t k = 1; k != group_blocks; ++k) {
+                            xor_block(group_sums[k - 1], l[ntz(k)], group_sums[k]);
+                        }
+                    }
+
+                    // Offset of the last processed block, given the offset of the last complete group
+                    block_type current(const block_type &group_offset, std::uint64_t index) const {
+                        block_type offset;
+                        xor_block(group_offset, group_sums[index % group_blocks], offset);
+                        return offset;
+                    }
+
+                    // Offsets of the next blocks, advancing the group offset at every multiple of group_blocks
+                    void next(block_type &group_offset, std::uint64_t &index, block_type *offsets,
+                              std::size_t blocks) const {
+                        std::size_t i = 0;
+
+                        // Whole groups need neither a position check nor more than one ntz
+                        if (index % group_blocks == 0) {
+                            for (; blocks - i >= group_blocks; i += group_blocks) {
+                                for (std::size_t k = 1; k != group_blocks; ++k) {
+                                    xor_block(group_offset, group_sums[k], offsets[i + k - 1]);
+                                }
+                                index += group_blocks;
+                                xor_block(offsets[i + group_blocks - 2], l[ntz(index)], group_offset);
+                                offsets[i + group_blocks - 1] = group_offset;
+                            }
+                        }
+
+                        for (; i != blocks; ++i) {
+                            const std::size_t position = static_cast<std::size_t>(++index % group_blocks);
+                            if (position != 0) {
+                                xor_block(group_offset, group_sums[position], offsets[i]);
+                            } else {
+                                xor_block(group_offset, group_sums[group_blocks - 1], group_offset);
+                                xor_block(group_offset, l[ntz(index)], group_offset);
+                                offsets[i] = group_offset;
+                            }
+                        }
+                    }
+
+                protected:
+                    constexpr static const std::size_t l_count = 64;
+
+                    static std::size_t ntz(std::uint64_t i) {
+                        std::size_t zeros = 0;
+                        for (; (i & 1) == 0; i >>= 1) {
+                            ++zeros;
+                        }
+                        return zeros;
+                    }
+
+                    block_type l[l_count], group_sums[group_blocks];
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ocb_encryption_policy : public ocb_policy<Cipher, Padding> {
+                    typedef typename ocb_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename ocb_policy<Cipher, Padding>::block_type block_type;
+
+                    // Blocks come in batches of at most chained_batch_blocks
+                    inline static void process_blocks(const cipher_type &cipher, const block_type *offsets,
+                                                      const block_type *in, block_type *out, std::size_t blocks,
+                                                      block_type &checksum) {
+                        if (ocb_backend<cipher_type>::encrypt(cipher, offsets, in, out, blocks, checksum)) {
+                            return;
+                        }
+
+                        block_type buffer[chained_batch_blocks];
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(checksum, in[i], checksum);
+                            xor_block(in[i], offsets[i], buffer[i]);
+                        }
+                        cipher.encrypt_blocks(buffer, buffer, blocks);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(buffer[i], offsets[i], out[i]);
+                        }
+                    }
+
+                    // The checksum covers the plaintext, padded with a one bit and zeros
+                    inline static void process_tail(const block_type &pad, block_type &checksum,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        for (std::size_t i = 0; i != size; ++i) {
+                            checksum[i] ^= in[i];
+                            out[i] = in[i] ^ pad[i];
+                        }
+                        checksum[size] ^= 0x80;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct ocb_decryption_policy : public ocb_policy<Cipher, Padding> {
+                    typedef typename ocb_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename ocb_policy<Cipher, Padding>::block_type block_type;
+
+                    inline static void process_blocks(const cipher_type &cipher, const block_type *offsets,
+                                                      const block_type *in, block_type *out, std::size_t blocks,
+                                                      block_type &checksum) {
+                        if (ocb_backend<cipher_type>::decrypt(cipher, offsets, in, out, blocks, checksum)) {
+                            return;
+                        }
+
+                        block_type buffer[chained_batch_blocks];
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(in[i], offsets[i], buffer[i]);
+                        }
+                        cipher.decrypt_blocks(buffer, buffer, blocks);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(buffer[i], offsets[i], out[i]);
+                            xor_block(checksum, out[i], checksum);
+                        }
+                    }
+
+                    inline static void process_tail(const block_type &pad, block_type &checksum,
+                                                    const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        for (std::size_t i = 0; i != size; ++i) {
+                            out[i] = in[i] ^ pad[i];
+                            checksum[i] ^= out[i];
+                        }
+                        checksum[size] ^= 0x80;
+                    }
+                };
+
+                /*!
+                 * @brief Offset Codebook mode (RFC 7253). Every block is whitened with its own offset
+                 * and the blocks are independent. Offsets are computed for a batch of blocks at a time,
+                 * then the batch goes through the cipher in one multi-block pass. Ciphers with a
+                 * dedicated OCB pass apply the offsets and accumulate the checksum in registers.
+                 * Decryption output must be discarded if the tag does not verify.
+                 *
+                 * Additional data and text may each be split over several calls, all but the last of
+                 * them a multiple of the block size.
+                 */
+                template<typename Policy>
+                class ocb {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    constexpr static const size_type block_bytes = policy_type::block_bytes;
+
+
+                    /*!
+                     * @param nonce Nonce of 1 to 15 bytes
+                     * @param tag_size Tag length in bytes
+                     */
+                    ocb(const cipher_type &cipher, const std::uint8_t *nonce, std::size_t nonce_size,
+                        std::size_t tag_size = block_bytes) :
+                        cipher(cipher),
+                        tag_size(tag_size), text_index(0), aad_index(0), text_tail(false), aad_tail(false) {
+                        BOOST_ASSERT(nonce_size != 0 && nonce_size < block_bytes);
+                        BOOST_ASSERT(tag_size != 0 && tag_size <= block_bytes);
+
+                        block_type zero = {0};
+                        l_star = cipher.encrypt(zero);
+                        l_dollar = policy_type::multiply_x(l_star);
+                        offset_table.schedule(policy_type::multiply_x(l_dollar));
+
+                        // The nonce is preceded by the tag length in 7 bits and a one bit
+                        block_type nonce_block = zero;
+                        nonce_block[0] = static_cast<std::uint8_t>(((tag_size * 8) % 128) << 1);
+                        nonce_block[block_bytes - 1 - nonce_size] |= 1;
+                        std::memcpy(nonce_block.data() + block_bytes - nonce_size, nonce, nonce_size);
+
+                        const std::size_t bottom = nonce_block[block_bytes - 1] & 0x3f;
+                        nonce_block[block_bytes - 1] &= 0xc0;
+                        const block_type top = cipher.encrypt(nonce_block);
+
+                        std::uint8_t stretch[block_bytes + 9];
+                        std::memcpy(stretch, top.data(), block_bytes);
+                        for (std::size_t i = 0; i != 8; ++i) {
+                            stretch[block_bytes + i] = top[i] ^ top[i + 1];
+                        }
+                        stretch[block_bytes + 8] = 0;
+
+                        const std::size_t byte_shift = bottom / 8, bit_shift = bottom % 8;
+                        for (std::size_t i = 0; i != block_bytes; ++i) {
+                            text_offset[i] = static_cast<std::uint8_t>(
+                                (stretch[i + byte_shift] << bit_shift) |
+                                (bit_shift != 0 ? stretch[i + byte_shift + 1] >> (8 - bit_shift) : 0));
+                        }
+
+                        checksum = aad_offset = aad_sum = zero;
+                    }
+
+                    /*!
+                     * @brief Absorbs additional authenticated data.
+                     */
+                    void process_aad(const std::uint8_t *aad, std::size_t size) {
+                        BOOST_ASSERT(!aad_tail);
+
+                        const std::size_t blocks = size / block_bytes, tail = size % block_bytes;
+                        block_type buffer[chained_batch_blocks], offsets[chained_batch_blocks];
+                        const block_type *in = reinterpret_cast<const block_type *>(aad);
+
+                        for (std::size_t done = 0; done != blocks;) {
+                            const std::size_t n =
+                                blocks - done < chained_batch_blocks ? blocks - done : chained_batch_blocks;
+                            offset_table.next(aad_offset, aad_index, offsets, n);
+                            for (std::size_t i = 0; i != n; ++i) {
+                                xor_block(in[done + i], offsets[i], buffer[i]);
+                            }
+                            cipher.encrypt_blocks(buffer, buffer, n);
+                            for (std::size_t i = 0; i != n; ++i) {
+                                xor_block(aad_sum, buffer[i], aad_sum);
+                            }
+                            done += n;
+                        }
+
+                        if (tail) {
+                            block_type last = offset_table.current(aad_offset, aad_index);
+                            xor_block(last, l_star, last);
+                            for (std::size_t i = 0; i != tail; ++i) {
+                                last[i] ^= aad[blocks * block_bytes + i];
+                            }
+                            last[tail] ^= 0x80;
+                            xor_block(aad_sum, cipher.encrypt(last), aad_sum);
+                            aad_tail = true;
+                        }
+                    }
+
+                    /*!
+                     * @brief Encrypts or decrypts the text.
+                     * @param out Output, may be the same as in
+                     */
+                    void process(const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                        BOOST_ASSERT(!text_tail);
+
+                        const std::size_t blocks = size / block_bytes, tail = size % block_bytes;
+                        const block_type *in_blocks = reinterpret_cast<const block_type *>(in);
+                        block_type *out_blocks = reinterpret_cast<block_type *>(out);
+                        block_type offsets[chained_batch_blocks];
+
+                        for (std::size_t done = 0; done != blocks;) {
+                            const std::size_t n =
+                                blocks - done < chained_batch_blocks ? blocks - done : chained_batch_blocks;
+                            offset_table.next(text_offset, text_index, offsets, n);
+                            policy_type::process_blocks(cipher, offsets, in_blocks + done, out_blocks + done, n,
+                                                        checksum);
+                            done += n;
+                        }
+
+                        if (tail) {
+                            block_type offset = offset_table.current(text_offset, text_index);
+                            xor_block(offset, l_star, offset);
+                            const block_type pad = cipher.encrypt(offset);
+                            policy_type::process_tail(pad, checksum, in + blocks * block_bytes,
+                                                      out + blocks * block_bytes, tail);
+                            text_tail = true;
+                        }
+                    }
+
+                    /*!
+                     * @brief Computes the authentication tag of everything processed so far.
+                     */
+                    void tag(std::uint8_t *out) const {
+                        block_type final_block = offset_table.current(text_offset, text_index);
+                        if (text_tail) {
+                            xor_block(final_block, l_star, final_block);
+                        }
+                        xor_block(final_block, checksum, final_block);
+                        xor_block(final_block, l_dollar, final_block);
+                        final_block = cipher.encrypt(final_block);
+
+                        for (std::size_t i = 0; i != tag_size; ++i) {
+                            out[i] = final_block[i] ^ aad_sum[i];
+                        }
+                    }
+
+                    /*!
+                     * @brief Compares the tag with the expected one in constant time.
+                     */
+                    bool verify(const std::uint8_t *expected) const {
+                        block_type computed;
+                        tag(computed.data());
+
+                        std::uint8_t difference = 0;
+                        for (std::size_t i = 0; i != tag_size; ++i) {
+                            difference |= computed[i] ^ expected[i];
+                        }
+                        return difference == 0;
+                    }
+
+                protected:
+                    cipher_type cipher;
+                    block_type l_star, l_dollar;
+                    gray_code_offsets<policy_type> offset_table;
+                    // Offsets of the last complete groups of blocks, see gray_code_offsets::current
+                    block_type text_offset, checksum, aad_offset, aad_sum;
+                    std::size_t tag_size;
+                    std::uint64_t text_index, aad_index;
+                    bool text_tail, aad_tail;
+                };
+
+                /*!
+                 * @brief Extension point for ciphers with a dedicated PMAC pass over whole blocks with
+                 * precomputed offsets, see gcm_backend. Without one pmac_policy enciphers a batch of
+                 * whitened blocks in a single bulk call.
+                 */
+                template<typename Cipher, typename = void>
+                struct pmac_backend {
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &, const block_type *, const block_type *, std::size_t,
+                                        block_type &) {
+                        return false;
+                    }
+                };
+
+                template<typename Cipher, typename Padding>
+                struct pmac_policy : public ocb_policy<Cipher, Padding> {
+                    typedef typename ocb_policy<Cipher, Padding>::cipher_type cipher_type;
+                    typedef typename ocb_policy<Cipher, Padding>::block_type block_type;
+
+                    constexpr static const std::size_t block_bytes = sizeof(block_type);
+
+                    /*!
+                     * @brief Divides the block by x in GF(2^128), the inverse of multiply_x.
+                     */
+                    inline static block_type divide_x(const block_type &block) {
+                        block_type out;
+                        const std::uint8_t carry = -(block[block_bytes - 1] & 1);
+                        out[0] = static_cast<std::uint8_t>((block[0] >> 1) ^ (0x80 & carry));
+                        for (std::size_t i = 1; i != block_bytes; ++i) {
+                            out[i] = static_cast<std::uint8_t>((block[i] >> 1) | (block[i - 1] << 7));
+                        }
+                        out[block_bytes - 1] ^= 0x43 & carry;
+                        return out;
+                    }
+
+                    // Blocks come in batches of at most chained_batch_blocks
+                    inline static void process_blocks(const cipher_type &cipher, const block_type *offsets,
+                                                      const block_type *in, std::size_t blocks, block_type &sum) {
+                        if (pmac_backend<cipher_type>::encrypt(cipher, offsets, in, blocks, sum)) {
+                            return;
+                        }
+
+                        block_type buffer[chained_batch_blocks];
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(in[i], offsets[i], buffer[i]);
+                        }
+                        cipher.encrypt_blocks(buffer, buffer, blocks);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            xor_block(sum, buffer[i], sum);
+                        }
+                    }
+                };
+
+                /*!
+                 * @brief Parallelizable MAC (PMAC1). Unlike CMAC every block but the last is enciphered
+                 * independently under its own offset, so the message goes through the cipher in batches
+                 * of blocks on the bulk path and only the sum of the results is kept. Ciphers with a
+                 * dedicated PMAC pass apply the offsets and accumulate the sum in registers.
+                 *
+                 * The message may be split over any amount of calls of any length. The last block is
+                 * finished differently, so up to one block is held back until the tag is requested.
+                 */
+                template<typename Policy>
+                class pmac {
+                    typedef Policy policy_type;
+
+                public:
+                    typedef typename policy_type::cipher_type cipher_type;
+                    typedef typename policy_type::padding_type padding_type;
+
+                    typedef typename policy_type::size_type size_type;
+
+                    typedef typename cipher_type::key_type key_type;
+
+                    typedef typename policy_type::endian_type endian_type;
+
+                    typedef typename cipher_type::block_type block_type;
+                    typedef typename cipher_type::word_type word_type;
+
+                    constexpr static const size_type block_bits = policy_type::block_bits;
+                    constexpr static const size_type block_words = policy_type::block_words;
+                    constexpr static const size_type word_bits = cipher_type::word_bits;
+
+                    constexpr static const size_type block_bytes = policy_type::block_bytes;
+
+                    /*!
+                     * @param tag_size Tag length in bytes
+                     */
+                    pmac(const cipher_type &cipher, std::size_t tag_size = block_bytes) :
+                        cipher(cipher), tag_size(tag_size), index(0), held_size(0) {
+                        BOOST_ASSERT(tag_size != 0 && tag_size <= block_bytes);
+
+                        block_type zero = {0};
+                        const block_type l = cipher.encrypt(zero);
+                        l_inverse = policy_type::divide_x(l);
+                        offset_table.schedule(l);
+
+                        offset = sum = held = zero;
+                    }
+
+                    /*!
+                     * @brief Absorbs the next part of the message.
+                     */
+                    void process(const std::uint8_t *in, std::size_t size) {
+                        if (held_size != block_bytes) {
+                            const std::size_t n = size < block_bytes - held_size ? size : block_bytes - held_size;
+                            std::memcpy(held.data() + held_size, in, n);
+                            held_size += n;
+                            in += n;
+                            size -= n;
+                        }
+                        if (size == 0) {
+                            return;
+                        }
+
+                        // More follows, so neither the held block nor the blocks before the last one are final
+                        absorb(&held, 1);
+                        const std::size_t blocks = (size - 1) / block_bytes;
+                        absorb(reinterpret_cast<const block_type *>(in), blocks);
+
+                        held_size = size - blocks * block_bytes;
+                        std::memcpy(held.data(), in + blocks * block_bytes, held_size);
+                    }
+
+                    /*!
+                     * @brief Computes the authentication tag of everything processed so far.
+                     */
+                    void tag(std::uint8_t *out) const {
+                        block_type last = sum;
+                        for (std::size_t i = 0; i != held_size; ++i) {
+                            last[i] ^= held[i];
+                        }
+                        if (held_size == block_bytes) {
+                            xor_block(last, l_inverse, last);
+                        } else {
+                            last[held_size] ^= 0x80;
+                        }
+                        last = cipher.encrypt(last);
+
+                        std::memcpy(out, last.data(), tag_size);
+                    }
+
+                    /*!
+                     * @brief Compares the tag with the expected one in constant time.
+                     */
+                    bool verify(const std::uint8_t *expected) const {
+                        block_type computed;
+                        tag(computed.data());
+
+                        std::uint8_t difference = 0;
+                        for (std::size_t i = 0; i != tag_size; ++i) {
+                            difference |= computed[i] ^ expected[i];
+                        }
+                        return difference == 0;
+                    }
+
+                protected:
+                    void absorb(const block_type *in, std::size_t blocks) {
+                        block_type offsets[chained_batch_blocks];
+
+                        for (std::size_t done = 0; done != blocks;) {
+                            const std::size_t n =
+                                blocks - done < chained_batch_blocks ? blocks - done : chained_batch_blocks;
+                            offset_table.next(offset, index, offsets, n);
+                            policy_type::process_blocks(cipher, offsets, in + done, n, sum);
+                            done += n;
+                        }
+                    }
+
+                    cipher_type cipher;
+                    block_type l_inverse;
+                    gray_code_offsets<policy_type> offset_table;
+                    // Offset of the last complete group of blocks, see gray_code_offsets::current
+                    block_type offset, sum, held;
+                    std::size_t tag_size;
+                    std::uint64_t index;
+                    std::size_t held_size;
+                };
+            }    // namespace detail
+
+            namespace modes {
+
+                template<typename Cipher, template<typename> class Padding>
+                struct isomorphic {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::isomorphic_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::isomorphic_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::isomorphic<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Cipher block chaining mode. Decryption runs through the bulk cipher path. The
+                 * bound mode is constructed from the keyed cipher and the initialization vector.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct cbc {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::cbc_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::cbc_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::chained<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Full-block cipher feedback mode. Decryption runs through the bulk cipher path.
+                 * The bound mode is constructed from the keyed cipher and the initialization vector.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct cfb {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::cfb_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::cfb_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::chained<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Output feedback mode. The keystream does not depend on the data, so encryption
+                 * and decryption are the same operation. The bound mode is constructed from the keyed
+                 * cipher and the initialization vector.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct ofb {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::ofb_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::ofb_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::chained<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Counter mode. The bound mode is constructed from the keyed cipher and the
+                 * initial counter block.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct counter {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::counter_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::counter_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::counter<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief XTS mode for 128-bit block ciphers. The bound mode is constructed from the data
+                 * and tweak ciphers, keyed with the two halves of the XTS key, and processes whole data
+                 * units through its sector entry points rather than a block stream.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct xts {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::xts_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::xts_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::xts<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Galois/Counter Mode for 128-bit block ciphers. The bound mode is constructed from
+                 * the keyed cipher and the initialization vector, and handles one message.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct gcm {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::gcm_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::gcm_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::gcm<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Counter with CBC-MAC mode for 128-bit block ciphers. The bound mode is constructed
+                 * from the keyed cipher, the nonce and the message lengths, and handles one message.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct ccm {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::ccm_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::ccm_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::ccm<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Offset Codebook mode for 128-bit block ciphers. The bound mode is constructed from
+                 * the keyed cipher and the nonce, and handles one message.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct ocb {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::ocb_encryption_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::ocb_decryption_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::ocb<Policy> type;
+                    };
+                };
+
+                /*!
+                 * @brief Parallelizable MAC for 128-bit block ciphers. There is a single direction, both
+                 * policies compute the tag. The bound mode is constructed from the keyed cipher and
+                 * handles one message.
+                 */
+                template<typename Cipher, template<typename> class Padding>
+                struct pmac {
+                    typedef Cipher cipher_type;
+                    typedef Padding<Cipher> padding_type;
+
+                    typedef detail::pmac_policy<cipher_type, padding_type> encryption_policy;
+                    typedef detail::pmac_policy<cipher_type, padding_type> decryption_policy;
+
+                    template<typename Policy>
+                    struct bind {
+                        typedef detail::pmac<Policy> type;
                     };
                 };
             }    // namespace modes
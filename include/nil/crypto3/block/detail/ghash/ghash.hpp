@@ -0,0 +1,201 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+// @file GHASH universal hash of the Galois/Counter Mode
+//
+// @brief Multiplication by the hash key H in GF(2^128). The portable variant walks
+// the input four bits at a time over a 16-entry table of multiples of H. On x86
+// hosts with PCLMULQDQ, blocks are multiplied carry-less by precomputed powers of
+// H and eight of them share one reduction.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_GHASH_HPP
+#define CRYPTO3_BLOCK_GHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/predef/architecture.h>
+#include <boost/static_assert.hpp>
+
+#include <nil/crypto3/detail/config.hpp>
+
+// Follows the selection of the Rijndael backends, the AES-NI one being built together with PCLMULQDQ
+#if BOOST_ARCH_X86 && defined(BOOST_ATTRIBUTE_TARGET) && !defined(CRYPTO3_BLOCK_RIJNDAEL_NO_RUNTIME_DISPATCH)
+
+#include <nil/crypto3/block/detail/ghash/ghash_clmul_impl.hpp>
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#define CRYPTO3_BLOCK_GHASH_HAS_CLMUL
+#define CRYPTO3_BLOCK_GHASH_RUNTIME_DISPATCH
+
+#elif defined(CRYPTO3_HAS_RIJNDAEL_NI)
+
+#include <nil/crypto3/block/detail/ghash/ghash_clmul_impl.hpp>
+
+#define CRYPTO3_BLOCK_GHASH_HAS_CLMUL
+
+#endif
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                /*!
+                 * @brief Precomputed multiples of the hash key H for both GHASH variants.
+                 */
+                struct ghash_key {
+                    constexpr static const std::size_t powers_count = 8;
+
+                    // i * H for every 4-bit i, read most significant bit first, as big-endian halves
+                    std::uint64_t table_hi[16];
+                    std::uint64_t table_lo[16];
+
+                    // H, H^2, ... H^8 in the byte-reflected form of the carry-less variant
+                    std::uint8_t powers[powers_count][16];
+                };
+
+#if defined(CRYPTO3_BLOCK_GHASH_HAS_CLMUL)
+                BOOST_STATIC_ASSERT(ghash_key::powers_count == ghash_clmul_aggregated_blocks);
+#endif
+
+                class ghash {
+                    static std::uint64_t load_be(const std::uint8_t *in) {
+                        std::uint64_t out = 0;
+                        for (std::size_t i = 0; i != 8; ++i) {
+                            out = (out << 8) | in[i];
+                        }
+                        return out;
+                    }
+
+                    static void store_be(std::uint64_t in, std::uint8_t *out) {
+                        for (std::size_t i = 8; i-- != 0; in >>= 8) {
+                            out[i] = static_cast<std::uint8_t>(in);
+                        }
+                    }
+
+                public:
+                    /*!
+                     * @return true if the carry-less multiplication variant is compiled in and
+                     * supported by the host CPU
+                     */
+                    static bool has_clmul() {
+#if defined(CRYPTO3_BLOCK_GHASH_RUNTIME_DISPATCH)
+                        static const bool available = cpuid::has_clmul() && cpuid::has_ssse3();
+                        return available;
+#elif defined(CRYPTO3_BLOCK_GHASH_HAS_CLMUL)
+                        return true;
+#else
+                        return false;
+#endif
+                    }
+
+                    /*!
+                     * @brief Precomputes the multiples of the hash key.
+                     * @param h Hash key, the encryption of the zero block
+                     */
+                    static void schedule(const std::uint8_t *h, ghash_key &key) {
+                        std::uint64_t hi = load_be(h), lo = load_be(h + 8);
+
+                        // Bit 3 of the index stands for H itself, every lower bit for one more factor of x
+                        key.table_hi[0] = key.table_lo[0] = 0;
+                        for (std::size_t i = 8; i != 0; i >>= 1) {
+                            key.table_hi[i] = hi;
+                            key.table_lo[i] = lo;
+                            const std::uint64_t carry = lo & 1;
+                            lo = (lo >> 1) | (hi << 63);
+                            hi = (hi >> 1) ^ (UINT64_C(0xe100000000000000) & (0 - carry));
+                        }
+                        for (std::size_t i = 2; i != 16; i <<= 1) {
+                            for (std::size_t j = 1; j != i; ++j) {
+                                key.table_hi[i + j] = key.table_hi[i] ^ key.table_hi[j];
+                                key.table_lo[i + j] = key.table_lo[i] ^ key.table_lo[j];
+                            }
+                        }
+
+#if defined(CRYPTO3_BLOCK_GHASH_HAS_CLMUL)
+                        if (has_clmul()) {
+                            ghash_clmul_schedule(h, key.powers);
+                        }
+#endif
+                    }
+
+                    /*!
+                     * @brief Absorbs whole blocks into the running hash.
+                     * @param hash Running hash, 16 bytes
+                     */
+                    static void update(const ghash_key &key, std::uint8_t *hash, const std::uint8_t *data,
+                                       std::size_t blocks) {
+#if defined(CRYPTO3_BLOCK_GHASH_HAS_CLMUL)
+                        if (has_clmul()) {
+                            return ghash_clmul_update(key.powers, hash, data, blocks);
+                        }
+#endif
+                        update_table(key, hash, data, blocks);
+                    }
+
+                    /*!
+                     * @brief Portable variant of update. Table lookups are indexed by the hashed data,
+                     * so unlike the carry-less variant it is not constant-time.
+                     */
+                    static void update_table(const ghash_key &key, std::uint8_t *hash, const std::uint8_t *data,
+                                             std::size_t blocks) {
+                        // Reduction of the four bits shifted out of the low end by a multiplication by x^4
+                        static const std::uint16_t reduction[16] = {0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0,
+                                                                    0x48c0, 0x54e0, 0xe100, 0xfd20, 0xd940, 0xc560,
+                                                                    0x9180, 0x8da0, 0xa9c0, 0xb5e0};
+
+                        std::uint64_t hi = load_be(hash), lo = load_be(hash + 8);
+
+                        for (; blocks != 0; --blocks, data += 16) {
+                            const std::uint64_t x_hi = hi ^ load_be(data), x_lo = lo ^ load_be(data + 8);
+                            hi = lo = 0;
+
+                            // Horner's scheme from the last nibble, which holds the highest powers of x
+                            for (std::size_t n = 32; n-- != 0;) {
+                                const std::size_t nibble =
+                                    static_cast<std::size_t>((n < 16 ? x_hi : x_lo) >> (60 - 4 * (n % 16))) & 0xf;
+                                const std::size_t rem = static_cast<std::size_t>(lo & 0xf);
+                                lo = (lo >> 4) | (hi << 60);
+                                hi = (hi >> 4) ^ (static_cast<std::uint64_t>(reduction[rem]) << 48);
+                                hi ^= key.table_hi[nibble];
+                                lo ^= key.table_lo[nibble];
+                            }
+                        }
+
+                        store_be(hi, hash);
+                        store_be(lo, hash + 8);
+                    }
+                };
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_GHASH_HPP
@@ -0,0 +1,169 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_GHASH_CLMUL_IMPL_HPP
+#define CRYPTO3_BLOCK_GHASH_CLMUL_IMPL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include <nil/crypto3/detail/config.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                /*!
+                 * @brief Amount of blocks hashed with a single reduction, which is also the amount of
+                 * precomputed powers of H.
+                 */
+                constexpr static const std::size_t ghash_clmul_aggregated_blocks = 8;
+
+                /*!
+                 * @brief Reverses the byte order of a block. GHASH works on byte-reflected blocks, the
+                 * remaining bit reflection is undone by a single shift after the multiplication.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline __m128i ghash_clmul_byte_reverse(__m128i block) {
+                    return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+                }
+
+                /*!
+                 * @brief Adds the unreduced 256-bit carry-less product of a and b to lo, mid and hi.
+                 * Products of several blocks are summed up before a single reduction.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline void ghash_clmul_accumulate(__m128i a, __m128i b, __m128i &lo, __m128i &mid, __m128i &hi) {
+                    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+                    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+                    mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                                                           _mm_clmulepi64_si128(a, b, 0x01)));
+                }
+
+                /*!
+                 * @brief Reduces an accumulated product modulo x^128 + x^7 + x^2 + x + 1. The product
+                 * is shifted left by one bit to account for the bit reflection, then folded twice.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline __m128i ghash_clmul_reduce(__m128i lo, __m128i mid, __m128i hi) {
+                    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+                    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+                    const __m128i lo_carry = _mm_srli_epi32(lo, 31);
+                    const __m128i hi_carry = _mm_srli_epi32(hi, 31);
+                    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(lo_carry, 4));
+                    hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(hi_carry, 4)),
+                                      _mm_srli_si128(lo_carry, 12));
+
+                    __m128i fold = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)),
+                                                 _mm_slli_epi32(lo, 25));
+                    const __m128i fold_hi = _mm_srli_si128(fold, 4);
+                    lo = _mm_xor_si128(lo, _mm_slli_si128(fold, 12));
+
+                    fold = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)),
+                                         _mm_srli_epi32(lo, 7));
+                    fold = _mm_xor_si128(fold, fold_hi);
+                    return _mm_xor_si128(hi, _mm_xor_si128(lo, fold));
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline __m128i ghash_clmul_multiply(__m128i a, __m128i b) {
+                    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                    ghash_clmul_accumulate(a, b, lo, mid, hi);
+                    return ghash_clmul_reduce(lo, mid, hi);
+                }
+
+                /*!
+                 * @brief Computes H, H^2, ... H^8 in the byte-reflected form.
+                 * @param h Hash key, the encryption of the zero block
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline void ghash_clmul_schedule(const std::uint8_t *h, std::uint8_t (*powers)[16]) {
+                    const __m128i H = ghash_clmul_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h)));
+                    __m128i P = H;
+                    for (std::size_t i = 0; i != ghash_clmul_aggregated_blocks; ++i) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(powers[i]), P);
+                        P = ghash_clmul_multiply(P, H);
+                    }
+                }
+
+                /*!
+                 * @brief Hashes up to eight byte-reflected blocks with one reduction: the first block,
+                 * XORed with the running hash, is multiplied by H^blocks and the last one by H.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline __m128i ghash_clmul_aggregate(const std::uint8_t (*powers)[16], __m128i hash,
+                                                     const __m128i *blocks, std::size_t count) {
+                    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                    ghash_clmul_accumulate(_mm_xor_si128(blocks[0], hash),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(powers[count - 1])),
+                                           lo, mid, hi);
+                    for (std::size_t i = 1; i != count; ++i) {
+                        ghash_clmul_accumulate(
+                            blocks[i], _mm_loadu_si128(reinterpret_cast<const __m128i *>(powers[count - 1 - i])), lo,
+                            mid, hi);
+                    }
+                    return ghash_clmul_reduce(lo, mid, hi);
+                }
+
+                /*!
+                 * @brief Absorbs whole blocks into the hash, eight at a time.
+                 * @param hash Running hash in the byte order of the specification
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,pclmul")
+                inline void ghash_clmul_update(const std::uint8_t (*powers)[16], std::uint8_t *hash,
+                                               const std::uint8_t *data, std::size_t blocks) {
+                    const __m128i *data_mm = reinterpret_cast<const __m128i *>(data);
+                    __m128i Y = ghash_clmul_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)));
+                    __m128i X[ghash_clmul_aggregated_blocks];
+
+                    while (blocks != 0) {
+                        const std::size_t n =
+                            blocks < ghash_clmul_aggregated_blocks ? blocks : ghash_clmul_aggregated_blocks;
+                        for (std::size_t i = 0; i != n; ++i) {
+                            X[i] = ghash_clmul_byte_reverse(_mm_loadu_si128(data_mm + i));
+                        }
+                        Y = ghash_clmul_aggregate(powers, Y, X, n);
+
+                        data_mm += n;
+                        blocks -= n;
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), ghash_clmul_byte_reverse(Y));
+                }
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_GHASH_CLMUL_IMPL_HPP
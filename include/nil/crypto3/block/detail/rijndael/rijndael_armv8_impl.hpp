@@ -177,6 +177,20 @@ namespace nil {
 
                     return out;
                 }
+
+                static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &encryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = encrypt_block(in[i], encryption_key);
+                    }
+                }
+
+                static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &decryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = decrypt_block(in[i], decryption_key);
+                    }
+                }
             };
 
             template<typename PolicyType>
@@ -256,6 +270,20 @@ namespace nil {
 
                     return out;
                 }
+
+                static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &encryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = encrypt_block(in[i], encryption_key);
+                    }
+                }
+
+                static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &decryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = decrypt_block(in[i], decryption_key);
+                    }
+                }
             };
 
             template<typename PolicyType>
@@ -341,6 +369,20 @@ namespace nil {
 
                     return out;
                 }
+
+                static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &encryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = encrypt_block(in[i], encryption_key);
+                    }
+                }
+
+                static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                           const key_schedule_type &decryption_key) {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        out[i] = decrypt_block(in[i], decryption_key);
+                    }
+                }
             };
         }    // namespace block
     }        // namespace crypto3
@@ -0,0 +1,622 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file Constant-time bitsliced AES
+//
+// @brief Follows the 64-bit bitsliced layout of Thomas Pornin's aes_ct64
+// from BearSSL: four blocks are processed at once in eight 64-bit words, each
+// holding one bit of every state byte. The S-box is the Boyar-Peralta circuit.
+// Bulk calls run two such states interleaved to hide the latency of the circuit.
+// No table lookups and no data dependent branches are used.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BITSLICED_RIJNDAEL_IMPL_HPP
+#define CRYPTO3_BITSLICED_RIJNDAEL_IMPL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/static_assert.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                struct rijndael_bitsliced_functions {
+                    typedef std::uint64_t slice_type;
+                    typedef std::uint32_t word_type;
+
+                    constexpr static const std::size_t slices = 8;
+                    constexpr static const std::size_t parallel_blocks = 4;
+
+                    typedef std::array<slice_type, slices> state_type;
+
+                    static inline void swap_bits(slice_type &x, slice_type &y, slice_type low_mask, unsigned shift) {
+                        slice_type a = x, b = y;
+                        x = (a & low_mask) | ((b & low_mask) << shift);
+                        y = ((a >> shift) & low_mask) | (b & ~low_mask);
+                    }
+
+                    /*
+                     * Transposes between the interleaved byte layout and the bitsliced one,
+                     * the transformation is an involution.
+                     */
+                    static inline void ortho(state_type &q) {
+                        swap_bits(q[0], q[1], 0x5555555555555555, 1);
+                        swap_bits(q[2], q[3], 0x5555555555555555, 1);
+                        swap_bits(q[4], q[5], 0x5555555555555555, 1);
+                        swap_bits(q[6], q[7], 0x5555555555555555, 1);
+
+                        swap_bits(q[0], q[2], 0x3333333333333333, 2);
+                        swap_bits(q[1], q[3], 0x3333333333333333, 2);
+                        swap_bits(q[4], q[6], 0x3333333333333333, 2);
+                        swap_bits(q[5], q[7], 0x3333333333333333, 2);
+
+                        swap_bits(q[0], q[4], 0x0F0F0F0F0F0F0F0F, 4);
+                        swap_bits(q[1], q[5], 0x0F0F0F0F0F0F0F0F, 4);
+                        swap_bits(q[2], q[6], 0x0F0F0F0F0F0F0F0F, 4);
+                        swap_bits(q[3], q[7], 0x0F0F0F0F0F0F0F0F, 4);
+                    }
+
+                    /*
+                     * Spreads four little-endian column words of a block over two slices
+                     */
+                    static inline void interleave_in(slice_type &q0, slice_type &q1, const word_type *w) {
+                        slice_type x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+
+                        x0 = (x0 | (x0 << 16)) & 0x0000FFFF0000FFFF;
+                        x1 = (x1 | (x1 << 16)) & 0x0000FFFF0000FFFF;
+                        x2 = (x2 | (x2 << 16)) & 0x0000FFFF0000FFFF;
+                        x3 = (x3 | (x3 << 16)) & 0x0000FFFF0000FFFF;
+
+                        x0 = (x0 | (x0 << 8)) & 0x00FF00FF00FF00FF;
+                        x1 = (x1 | (x1 << 8)) & 0x00FF00FF00FF00FF;
+                        x2 = (x2 | (x2 << 8)) & 0x00FF00FF00FF00FF;
+                        x3 = (x3 | (x3 << 8)) & 0x00FF00FF00FF00FF;
+
+                        q0 = x0 | (x2 << 8);
+                        q1 = x1 | (x3 << 8);
+                    }
+
+                    static inline void interleave_out(word_type *w, slice_type q0, slice_type q1) {
+                        slice_type x0 = q0 & 0x00FF00FF00FF00FF;
+                        slice_type x1 = q1 & 0x00FF00FF00FF00FF;
+                        slice_type x2 = (q0 >> 8) & 0x00FF00FF00FF00FF;
+                        slice_type x3 = (q1 >> 8) & 0x00FF00FF00FF00FF;
+
+                        x0 = (x0 | (x0 >> 8)) & 0x0000FFFF0000FFFF;
+                        x1 = (x1 | (x1 >> 8)) & 0x0000FFFF0000FFFF;
+                        x2 = (x2 | (x2 >> 8)) & 0x0000FFFF0000FFFF;
+                        x3 = (x3 | (x3 >> 8)) & 0x0000FFFF0000FFFF;
+
+                        w[0] = static_cast<word_type>(x0 | (x0 >> 16));
+                        w[1] = static_cast<word_type>(x1 | (x1 >> 16));
+                        w[2] = static_cast<word_type>(x2 | (x2 >> 16));
+                        w[3] = static_cast<word_type>(x3 | (x3 >> 16));
+                    }
+
+                    /*
+                     * Boyar-Peralta S-box circuit: 32 AND, 83 XOR and 4 NOT gates
+                     */
+                    static inline void sub_bytes(state_type &q) {
+                        const slice_type x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2],
+                                         x6 = q[1], x7 = q[0];
+
+                        // Top linear transformation
+                        const slice_type y14 = x3 ^ x5;
+                        const slice_type y13 = x0 ^ x6;
+                        const slice_type y9 = x0 ^ x3;
+                        const slice_type y8 = x0 ^ x5;
+                        const slice_type t0 = x1 ^ x2;
+                        const slice_type y1 = t0 ^ x7;
+                        const slice_type y4 = y1 ^ x3;
+                        const slice_type y12 = y13 ^ y14;
+                        const slice_type y2 = y1 ^ x0;
+                        const slice_type y5 = y1 ^ x6;
+                        const slice_type y3 = y5 ^ y8;
+                        const slice_type t1 = x4 ^ y12;
+                        const slice_type y15 = t1 ^ x5;
+                        const slice_type y20 = t1 ^ x1;
+                        const slice_type y6 = y15 ^ x7;
+                        const slice_type y10 = y15 ^ t0;
+                        const slice_type y11 = y20 ^ y9;
+                        const slice_type y7 = x7 ^ y11;
+                        const slice_type y17 = y10 ^ y11;
+                        const slice_type y19 = y10 ^ y8;
+                        const slice_type y16 = t0 ^ y11;
+                        const slice_type y21 = y13 ^ y16;
+                        const slice_type y18 = x0 ^ y16;
+
+                        // Non-linear section
+                        const slice_type t2 = y12 & y15;
+                        const slice_type t3 = y3 & y6;
+                        const slice_type t4 = t3 ^ t2;
+                        const slice_type t5 = y4 & x7;
+                        const slice_type t6 = t5 ^ t2;
+                        const slice_type t7 = y13 & y16;
+                        const slice_type t8 = y5 & y1;
+                        const slice_type t9 = t8 ^ t7;
+                        const slice_type t10 = y2 & y7;
+                        const slice_type t11 = t10 ^ t7;
+                        const slice_type t12 = y9 & y11;
+                        const slice_type t13 = y14 & y17;
+                        const slice_type t14 = t13 ^ t12;
+                        const slice_type t15 = y8 & y10;
+                        const slice_type t16 = t15 ^ t12;
+                        const slice_type t17 = t4 ^ t14;
+                        const slice_type t18 = t6 ^ t16;
+                        const slice_type t19 = t9 ^ t14;
+                        const slice_type t20 = t11 ^ t16;
+                        const slice_type t21 = t17 ^ y20;
+                        const slice_type t22 = t18 ^ y19;
+                        const slice_type t23 = t19 ^ y21;
+                        const slice_type t24 = t20 ^ y18;
+
+                        const slice_type t25 = t21 ^ t22;
+                        const slice_type t26 = t21 & t23;
+                        const slice_type t27 = t24 ^ t26;
+                        const slice_type t28 = t25 & t27;
+                        const slice_type t29 = t28 ^ t22;
+                        const slice_type t30 = t23 ^ t24;
+                        const slice_type t31 = t22 ^ t26;
+                        const slice_type t32 = t31 & t30;
+                        const slice_type t33 = t32 ^ t24;
+                        const slice_type t34 = t23 ^ t33;
+                        const slice_type t35 = t27 ^ t33;
+                        const slice_type t36 = t24 & t35;
+                        const slice_type t37 = t36 ^ t34;
+                        const slice_type t38 = t27 ^ t36;
+                        const slice_type t39 = t29 & t38;
+                        const slice_type t40 = t25 ^ t39;
+
+                        const slice_type t41 = t40 ^ t37;
+                        const slice_type t42 = t29 ^ t33;
+                        const slice_type t43 = t29 ^ t40;
+                        const slice_type t44 = t33 ^ t37;
+                        const slice_type t45 = t42 ^ t41;
+                        const slice_type z0 = t44 & y15;
+                        const slice_type z1 = t37 & y6;
+                        const slice_type z2 = t33 & x7;
+                        const slice_type z3 = t43 & y16;
+                        const slice_type z4 = t40 & y1;
+                        const slice_type z5 = t29 & y7;
+                        const slice_type z6 = t42 & y11;
+                        const slice_type z7 = t45 & y17;
+                        const slice_type z8 = t41 & y10;
+                        const slice_type z9 = t44 & y12;
+                        const slice_type z10 = t37 & y3;
+                        const slice_type z11 = t33 & y4;
+                        const slice_type z12 = t43 & y13;
+                        const slice_type z13 = t40 & y5;
+                        const slice_type z14 = t29 & y2;
+                        const slice_type z15 = t42 & y9;
+                        const slice_type z16 = t45 & y14;
+                        const slice_type z17 = t41 & y8;
+
+                        // Bottom linear transformation
+                        const slice_type t46 = z15 ^ z16;
+                        const slice_type t47 = z10 ^ z11;
+                        const slice_type t48 = z5 ^ z13;
+                        const slice_type t49 = z9 ^ z10;
+                        const slice_type t50 = z2 ^ z12;
+                        const slice_type t51 = z2 ^ z5;
+                        const slice_type t52 = z7 ^ z8;
+                        const slice_type t53 = z0 ^ z3;
+                        const slice_type t54 = z6 ^ z7;
+                        const slice_type t55 = z16 ^ z17;
+                        const slice_type t56 = z12 ^ t48;
+                        const slice_type t57 = t50 ^ t53;
+                        const slice_type t58 = z4 ^ t46;
+                        const slice_type t59 = z3 ^ t54;
+                        const slice_type t60 = t46 ^ t57;
+                        const slice_type t61 = z14 ^ t57;
+                        const slice_type t62 = t52 ^ t58;
+                        const slice_type t63 = t49 ^ t58;
+                        const slice_type t64 = z4 ^ t59;
+                        const slice_type t65 = t61 ^ t62;
+                        const slice_type t66 = z1 ^ t63;
+                        const slice_type s0 = t59 ^ t63;
+                        const slice_type s6 = t56 ^ ~t62;
+                        const slice_type s7 = t48 ^ ~t60;
+                        const slice_type t67 = t64 ^ t65;
+                        const slice_type s3 = t53 ^ t66;
+                        const slice_type s4 = t51 ^ t66;
+                        const slice_type s5 = t47 ^ t65;
+                        const slice_type s1 = t64 ^ ~s3;
+                        const slice_type s2 = t55 ^ ~t67;
+
+                        q[7] = s0;
+                        q[6] = s1;
+                        q[5] = s2;
+                        q[4] = s3;
+                        q[3] = s4;
+                        q[2] = s5;
+                        q[1] = s6;
+                        q[0] = s7;
+                    }
+
+                    /*
+                     * Affine map x -> A^-1(x ^ 0x63). Wrapping the forward S-box into it on both
+                     * sides yields the inverse S-box.
+                     */
+                    static inline void inverse_affine(state_type &q) {
+                        const slice_type q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = ~q[5],
+                                         q6 = ~q[6], q7 = q[7];
+
+                        q[7] = q1 ^ q4 ^ q6;
+                        q[6] = q0 ^ q3 ^ q5;
+                        q[5] = q7 ^ q2 ^ q4;
+                        q[4] = q6 ^ q1 ^ q3;
+                        q[3] = q5 ^ q0 ^ q2;
+                        q[2] = q4 ^ q7 ^ q1;
+                        q[1] = q3 ^ q6 ^ q0;
+                        q[0] = q2 ^ q5 ^ q7;
+                    }
+
+                    static inline void inverse_sub_bytes(state_type &q) {
+                        inverse_affine(q);
+                        sub_bytes(q);
+                        inverse_affine(q);
+                    }
+
+                    static inline void shift_rows(state_type &q) {
+                        for (slice_type &x : q) {
+                            x = (x & 0x000000000000FFFF) | ((x & 0x00000000FFF00000) >> 4) |
+                                ((x & 0x00000000000F0000) << 12) | ((x & 0x0000FF0000000000) >> 8) |
+                                ((x & 0x000000FF00000000) << 8) | ((x & 0xF000000000000000) >> 12) |
+                                ((x & 0x0FFF000000000000) << 4);
+                        }
+                    }
+
+                    static inline void inverse_shift_rows(state_type &q) {
+                        for (slice_type &x : q) {
+                            x = (x & 0x000000000000FFFF) | ((x & 0x000000000FFF0000) << 4) |
+                                ((x & 0x00000000F0000000) >> 12) | ((x & 0x000000FF00000000) << 8) |
+                                ((x & 0x0000FF0000000000) >> 8) | ((x & 0x000F000000000000) << 12) |
+                                ((x & 0xFFF0000000000000) >> 4);
+                        }
+                    }
+
+                    static inline slice_type rotate_row(slice_type x) {
+                        return (x >> 16) | (x << 48);
+                    }
+
+                    static inline slice_type rotate_two_rows(slice_type x) {
+                        return (x << 32) | (x >> 32);
+                    }
+
+                    static inline void mix_columns(state_type &q) {
+                        const slice_type q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5],
+                                         q6 = q[6], q7 = q[7];
+                        const slice_type r0 = rotate_row(q0), r1 = rotate_row(q1), r2 = rotate_row(q2),
+                                         r3 = rotate_row(q3), r4 = rotate_row(q4), r5 = rotate_row(q5),
+                                         r6 = rotate_row(q6), r7 = rotate_row(q7);
+
+                        q[0] = q7 ^ r7 ^ r0 ^ rotate_two_rows(q0 ^ r0);
+                        q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotate_two_rows(q1 ^ r1);
+                        q[2] = q1 ^ r1 ^ r2 ^ rotate_two_rows(q2 ^ r2);
+                        q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotate_two_rows(q3 ^ r3);
+                        q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotate_two_rows(q4 ^ r4);
+                        q[5] = q4 ^ r4 ^ r5 ^ rotate_two_rows(q5 ^ r5);
+                        q[6] = q5 ^ r5 ^ r6 ^ rotate_two_rows(q6 ^ r6);
+                        q[7] = q6 ^ r6 ^ r7 ^ rotate_two_rows(q7 ^ r7);
+                    }
+
+                    /*
+                     * Multiplication of every byte by x, i.e. xtime on bit slices
+                     */
+                    static inline void multiply_by_x(state_type &q) {
+                        const slice_type carry = q[7];
+                        q[7] = q[6];
+                        q[6] = q[5];
+                        q[5] = q[4];
+                        q[4] = q[3] ^ carry;
+                        q[3] = q[2] ^ carry;
+                        q[2] = q[1];
+                        q[1] = q[0] ^ carry;
+                        q[0] = carry;
+                    }
+
+                    /*
+                     * InvMixColumns is MixColumns after multiplying every column by {04}x^2 + {05}
+                     */
+                    static inline void inverse_mix_columns(state_type &q) {
+                        state_type u;
+                        for (std::size_t i = 0; i != slices; ++i) {
+                            u[i] = q[i] ^ rotate_two_rows(q[i]);
+                        }
+                        multiply_by_x(u);
+                        multiply_by_x(u);
+                        for (std::size_t i = 0; i != slices; ++i) {
+                            q[i] ^= u[i];
+                        }
+                        mix_columns(q);
+                    }
+
+                    static inline void add_round_key(state_type &q, const slice_type *round_key) {
+                        for (std::size_t i = 0; i != slices; ++i) {
+                            q[i] ^= round_key[i];
+                        }
+                    }
+
+                    static inline word_type sub_word(word_type x) {
+                        state_type q = {{x, 0, 0, 0, 0, 0, 0, 0}};
+                        ortho(q);
+                        sub_bytes(q);
+                        ortho(q);
+                        return static_cast<word_type>(q[0]);
+                    }
+                };
+
+                template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
+                class rijndael_bitsliced_impl {
+                    typedef PolicyType policy_type;
+                    typedef rijndael_bitsliced_functions functions_type;
+
+                    typedef typename policy_type::key_type key_type;
+                    typedef typename policy_type::key_schedule_type key_schedule_type;
+                    typedef typename policy_type::block_type block_type;
+
+                    typedef typename functions_type::slice_type slice_type;
+                    typedef typename functions_type::word_type word_type;
+                    typedef typename functions_type::state_type state_type;
+
+                    BOOST_STATIC_ASSERT(KeyBitsImpl == PolicyType::key_bits);
+                    BOOST_STATIC_ASSERT(BlockBitsImpl == PolicyType::block_bits);
+                    BOOST_STATIC_ASSERT(BlockBitsImpl == 128);
+
+                    constexpr static const std::size_t rounds = policy_type::rounds;
+                    constexpr static const std::size_t parallel_blocks = functions_type::parallel_blocks;
+
+                    /*
+                     * Every round key takes eight slices once expanded, but only two are stored
+                     */
+                    typedef std::array<slice_type, functions_type::slices *(rounds + 1)> expanded_key_type;
+
+                    static inline word_type load_word(const std::uint8_t *p) {
+                        return static_cast<word_type>(p[0]) | static_cast<word_type>(p[1]) << 8 |
+                               static_cast<word_type>(p[2]) << 16 | static_cast<word_type>(p[3]) << 24;
+                    }
+
+                    static inline void store_word(word_type x, std::uint8_t *p) {
+                        p[0] = static_cast<std::uint8_t>(x);
+                        p[1] = static_cast<std::uint8_t>(x >> 8);
+                        p[2] = static_cast<std::uint8_t>(x >> 16);
+                        p[3] = static_cast<std::uint8_t>(x >> 24);
+                    }
+
+                    static inline void expand_key(const key_schedule_type &key, expanded_key_type &expanded) {
+                        for (std::size_t i = 0; i != 2 * (rounds + 1); ++i) {
+                            const slice_type compressed =
+                                static_cast<slice_type>(key[2 * i]) | static_cast<slice_type>(key[2 * i + 1]) << 32;
+
+                            for (std::size_t bit = 0; bit != 4; ++bit) {
+                                const slice_type x = (compressed >> bit) & 0x1111111111111111;
+                                expanded[4 * i + bit] = (x << 4) - x;
+                            }
+                        }
+                    }
+
+                    static inline void load_blocks(const block_type *in, std::size_t blocks, state_type &q) {
+                        q.fill(0);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            word_type w[4];
+                            for (std::size_t j = 0; j != 4; ++j) {
+                                w[j] = load_word(in[i].data() + 4 * j);
+                            }
+                            functions_type::interleave_in(q[i], q[i + 4], w);
+                        }
+                        functions_type::ortho(q);
+                    }
+
+                    static inline void store_blocks(state_type &q, block_type *out, std::size_t blocks) {
+                        functions_type::ortho(q);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            word_type w[4];
+                            functions_type::interleave_out(w, q[i], q[i + 4]);
+                            for (std::size_t j = 0; j != 4; ++j) {
+                                store_word(w[j], out[i].data() + 4 * j);
+                            }
+                        }
+                    }
+
+                    /*
+                     * Runs N independent four-block states through the rounds in lockstep. Every bitsliced
+                     * step is a long dependency chain, interleaving two states keeps the pipeline busy.
+                     */
+                    template<std::size_t N>
+                    static inline void encrypt_states(std::array<state_type, N> &q, const expanded_key_type &key) {
+                        for (state_type &s : q) {
+                            functions_type::add_round_key(s, key.data());
+                        }
+                        for (std::size_t round = 1; round != rounds; ++round) {
+                            for (state_type &s : q) {
+                                functions_type::sub_bytes(s);
+                                functions_type::shift_rows(s);
+                                functions_type::mix_columns(s);
+                                functions_type::add_round_key(s, key.data() + functions_type::slices * round);
+                            }
+                        }
+                        for (state_type &s : q) {
+                            functions_type::sub_bytes(s);
+                            functions_type::shift_rows(s);
+                            functions_type::add_round_key(s, key.data() + functions_type::slices * rounds);
+                        }
+                    }
+
+                    template<std::size_t N>
+                    static inline void decrypt_states(std::array<state_type, N> &q, const expanded_key_type &key) {
+                        for (state_type &s : q) {
+                            functions_type::add_round_key(s, key.data() + functions_type::slices * rounds);
+                        }
+                        for (std::size_t round = rounds - 1; round != 0; --round) {
+                            for (state_type &s : q) {
+                                functions_type::inverse_shift_rows(s);
+                                functions_type::inverse_sub_bytes(s);
+                                functions_type::add_round_key(s, key.data() + functions_type::slices * round);
+                                functions_type::inverse_mix_columns(s);
+                            }
+                        }
+                        for (state_type &s : q) {
+                            functions_type::inverse_shift_rows(s);
+                            functions_type::inverse_sub_bytes(s);
+                            functions_type::add_round_key(s, key.data());
+                        }
+                    }
+
+                    template<std::size_t N, bool Decrypt>
+                    static inline std::size_t process_interleaved(const block_type *in, block_type *out,
+                                                                  std::size_t blocks, const expanded_key_type &key) {
+                        std::size_t done = 0;
+                        for (; blocks - done >= N * parallel_blocks; done += N * parallel_blocks) {
+                            std::array<state_type, N> q;
+                            for (std::size_t i = 0; i != N; ++i) {
+                                load_blocks(in + done + i * parallel_blocks, parallel_blocks, q[i]);
+                            }
+                            if (Decrypt) {
+                                decrypt_states(q, key);
+                            } else {
+                                encrypt_states(q, key);
+                            }
+                            for (std::size_t i = 0; i != N; ++i) {
+                                store_blocks(q[i], out + done + i * parallel_blocks, parallel_blocks);
+                            }
+                        }
+                        return done;
+                    }
+
+                    template<bool Decrypt>
+                    static inline void process_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                                      const key_schedule_type &key_schedule) {
+                        expanded_key_type key;
+                        expand_key(key_schedule, key);
+
+                        const std::size_t done = process_interleaved<2, Decrypt>(in, out, blocks, key);
+                        in += done;
+                        out += done;
+                        blocks -= done;
+
+                        while (blocks) {
+                            const std::size_t n = blocks < parallel_blocks ? blocks : parallel_blocks;
+                            std::array<state_type, 1> q;
+
+                            load_blocks(in, n, q[0]);
+                            if (Decrypt) {
+                                decrypt_states(q, key);
+                            } else {
+                                encrypt_states(q, key);
+                            }
+                            store_blocks(q[0], out, n);
+
+                            in += n;
+                            out += n;
+                            blocks -= n;
+                        }
+                    }
+
+                public:
+                    static block_type encrypt_block(const block_type &plaintext,
+                                                    const key_schedule_type &encryption_key) {
+                        block_type out;
+                        encrypt_blocks(&plaintext, &out, 1, encryption_key);
+                        return out;
+                    }
+
+                    static block_type decrypt_block(const block_type &ciphertext,
+                                                    const key_schedule_type &decryption_key) {
+                        block_type out;
+                        decrypt_blocks(&ciphertext, &out, 1, decryption_key);
+                        return out;
+                    }
+
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        process_blocks<false>(in, out, blocks, encryption_key);
+                    }
+
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        process_blocks<true>(in, out, blocks, decryption_key);
+                    }
+
+                    /*
+                     * Round keys are kept bitsliced in the compressed form: the four copies of a key
+                     * bit within a slice nibble are reduced to one, so a round key fits two slices.
+                     * Decryption uses the same schedule.
+                     */
+                    static void schedule_key(const key_type &key, key_schedule_type &encryption_key,
+                                             key_schedule_type &decryption_key) {
+                        constexpr const std::size_t key_words = policy_type::key_words;
+                        constexpr const std::size_t schedule_words = policy_type::key_schedule_words;
+
+                        std::array<word_type, schedule_words> words;
+                        for (std::size_t i = 0; i != key_words; ++i) {
+                            words[i] = load_word(key.data() + 4 * i);
+                        }
+
+                        for (std::size_t i = key_words; i != schedule_words; ++i) {
+                            word_type tmp = words[i - 1];
+                            if (i % key_words == 0) {
+                                tmp = functions_type::sub_word((tmp << 24) | (tmp >> 8)) ^
+                                      policy_type::round_constants[i / key_words - 1];
+                            } else if (key_words > 6 && i % key_words == 4) {
+                                tmp = functions_type::sub_word(tmp);
+                            }
+                            words[i] = words[i - key_words] ^ tmp;
+                        }
+
+                        for (std::size_t i = 0; i != rounds + 1; ++i) {
+                            state_type q;
+                            functions_type::interleave_in(q[0], q[4], words.data() + 4 * i);
+                            q[1] = q[2] = q[3] = q[0];
+                            q[5] = q[6] = q[7] = q[4];
+                            functions_type::ortho(q);
+
+                            const slice_type low = (q[0] & 0x1111111111111111) | (q[1] & 0x2222222222222222) |
+                                                   (q[2] & 0x4444444444444444) | (q[3] & 0x8888888888888888);
+                            const slice_type high = (q[4] & 0x1111111111111111) | (q[5] & 0x2222222222222222) |
+                                                    (q[6] & 0x4444444444444444) | (q[7] & 0x8888888888888888);
+
+                            encryption_key[4 * i] = static_cast<word_type>(low);
+                            encryption_key[4 * i + 1] = static_cast<word_type>(low >> 32);
+                            encryption_key[4 * i + 2] = static_cast<word_type>(high);
+                            encryption_key[4 * i + 3] = static_cast<word_type>(high >> 32);
+                        }
+
+                        decryption_key = encryption_key;
+                    }
+                };
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BITSLICED_RIJNDAEL_IMPL_HPP
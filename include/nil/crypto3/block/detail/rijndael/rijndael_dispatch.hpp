@@ -0,0 +1,537 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_RIJNDAEL_DISPATCH_HPP
+#define CRYPTO3_RIJNDAEL_DISPATCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <boost/predef/architecture.h>
+#include <boost/predef/compiler.h>
+#include <boost/predef/hardware/simd.h>
+
+#include <nil/crypto3/detail/config.hpp>
+
+#include <nil/crypto3/block/detail/cipher_modes.hpp>
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_impl.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_bitsliced_impl.hpp>
+
+/*!
+ * On x86 every accelerated backend is compiled in with per-function target attributes and the one
+ * to use is picked at runtime from cpuid. Define CRYPTO3_BLOCK_RIJNDAEL_NO_RUNTIME_DISPATCH to get
+ * back the compile-time selection driven by CRYPTO3_HAS_RIJNDAEL_* macros.
+ */
+#if BOOST_ARCH_X86 && defined(BOOST_ATTRIBUTE_TARGET) && !defined(CRYPTO3_BLOCK_RIJNDAEL_NO_RUNTIME_DISPATCH)
+#define CRYPTO3_BLOCK_RIJNDAEL_RUNTIME_DISPATCH
+#endif
+
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_RUNTIME_DISPATCH)
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_ni_impl.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_ni_wide_impl.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_ssse3_impl.hpp>
+
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_NI_BACKEND
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_SSSE3_BACKEND
+
+// VAES intrinsics and target attribute appeared in GCC 8 and Clang 6
+#if BOOST_COMP_GNUC >= BOOST_VERSION_NUMBER(8, 0, 0) || BOOST_COMP_CLANG >= BOOST_VERSION_NUMBER(6, 0, 0)
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_vaes_impl.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_VAES_BACKEND
+
+#endif
+
+#elif defined(CRYPTO3_HAS_RIJNDAEL_NI)
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_ni_impl.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_ni_wide_impl.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_NI_BACKEND
+
+#elif defined(CRYPTO3_HAS_RIJNDAEL_SSSE3) || BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSSE3_VERSION
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_ssse3_impl.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_SSSE3_BACKEND
+
+#elif defined(CRYPTO3_HAS_RIJNDAEL_ARMV8)
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_armv8_impl.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_ARMV8_BACKEND
+
+#elif defined(CRYPTO3_HAS_RIJNDAEL_POWER8)
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_power8_impl.hpp>
+
+#define CRYPTO3_BLOCK_RIJNDAEL_HAS_POWER8_BACKEND
+
+#endif
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @brief Rijndael implementation backend selection.
+             *
+             * @ingroup block
+             *
+             * Every rijndael instance binds to the backend which is active at the moment
+             * its key gets scheduled, so one binary runs the fastest code the host supports.
+             * For benchmarking and testing a particular backend can be forced for instances
+             * created afterwards.
+             */
+            class rijndael_backend {
+            public:
+                enum type { generic, ssse3, aes_ni, armv8, power8, vaes_avx2, vaes_avx512, bitsliced };
+
+                /*!
+                 * @return true if the backend is compiled in and supported by the host CPU
+                 */
+                static bool is_available(type backend) {
+                    switch (backend) {
+                        case generic:
+                        case bitsliced:
+                            return true;
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_SSSE3_BACKEND)
+                        case ssse3:
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_RUNTIME_DISPATCH)
+                            return cpuid::has_ssse3();
+#else
+                            return true;
+#endif
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_NI_BACKEND)
+                        case aes_ni:
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_RUNTIME_DISPATCH)
+                            return cpuid::has_aes_ni() && cpuid::has_ssse3();
+#else
+                            return true;
+#endif
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_VAES_BACKEND)
+                        case vaes_avx2:
+                            return is_available(aes_ni) && cpuid::has_avx2() && cpuid::has_vaes();
+                        case vaes_avx512:
+                            return is_available(aes_ni) && cpuid::has_avx512f() && cpuid::has_vaes();
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_ARMV8_BACKEND)
+                        case armv8:
+                            return true;
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_POWER8_BACKEND)
+                        case power8:
+                            return true;
+#endif
+                        default:
+                            return false;
+                    }
+                }
+
+                /*!
+                 * @return Fastest backend available on the host, detected once
+                 */
+                static type best() {
+                    static const type detected = detect();
+                    return detected;
+                }
+
+                /*!
+                 * @return Backend new rijndael instances are going to use
+                 */
+                static type active() {
+                    int backend = forced().load(std::memory_order_relaxed);
+                    return backend < 0 ? best() : static_cast<type>(backend);
+                }
+
+                /*!
+                 * @brief Makes rijndael instances created afterwards use the given backend.
+                 * @return false and leaves the selection unchanged if the backend is not available
+                 */
+                static bool force(type backend) {
+                    if (!is_available(backend)) {
+                        return false;
+                    }
+                    forced().store(backend, std::memory_order_relaxed);
+                    return true;
+                }
+
+                /*!
+                 * @brief Returns to the automatic backend selection
+                 */
+                static void reset() {
+                    forced().store(-1, std::memory_order_relaxed);
+                }
+
+                static const char *name(type backend) {
+                    switch (backend) {
+                        case ssse3:
+                            return "ssse3";
+                        case aes_ni:
+                            return "aes_ni";
+                        case armv8:
+                            return "armv8";
+                        case power8:
+                            return "power8";
+                        case vaes_avx2:
+                            return "vaes_avx2";
+                        case vaes_avx512:
+                            return "vaes_avx512";
+                        case bitsliced:
+                            return "bitsliced";
+                        default:
+                            return "generic";
+                    }
+                }
+
+            private:
+                static type detect() {
+                    for (type backend : {vaes_avx512, vaes_avx2, aes_ni, armv8, power8, ssse3}) {
+                        if (is_available(backend)) {
+                            return backend;
+                        }
+                    }
+                    // Constant-time fallback, though on 32-bit hosts 64-bit slices are too slow to be the default
+                    return sizeof(void *) >= 8 ? bitsliced : generic;
+                }
+
+                static std::atomic<int> &forced() {
+                    static std::atomic<int> backend(-1);
+                    return backend;
+                }
+            };
+
+            namespace detail {
+                /*!
+                 * @brief Expands a batch of keys, skipping decryption schedules if decryption_keys is null.
+                 * Backends without a dedicated batched key schedule expand the keys one by one.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_batch_key_schedule {
+                    typedef typename PolicyType::key_type key_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void schedule(const key_type *keys, key_schedule_type *encryption_keys,
+                                         key_schedule_type *decryption_keys, std::size_t count) {
+                        key_schedule_type discarded;
+                        for (std::size_t i = 0; i != count; ++i) {
+                            Impl::schedule_key(keys[i], encryption_keys[i],
+                                               decryption_keys ? decryption_keys[i] : discarded);
+                        }
+                        discarded.fill(0);
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_batch_key_schedule<Impl, PolicyType, decltype(void(&Impl::schedule_keys))> {
+                    typedef typename PolicyType::key_type key_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void schedule(const key_type *keys, key_schedule_type *encryption_keys,
+                                         key_schedule_type *decryption_keys, std::size_t count) {
+                        Impl::schedule_keys(keys, encryption_keys, decryption_keys, count);
+                    }
+                };
+
+                /*!
+                 * @brief Encrypts a block iterations times in a row. Backends without a dedicated
+                 * iterated pass call encrypt_block in a loop.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_iterated_encrypt {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static block_type encrypt(const block_type &plaintext, std::size_t iterations,
+                                              const key_schedule_type &encryption_key) {
+                        block_type block = plaintext;
+                        for (; iterations != 0; --iterations) {
+                            block = Impl::encrypt_block(block, encryption_key);
+                        }
+                        return block;
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_iterated_encrypt<Impl, PolicyType, decltype(void(&Impl::encrypt_iterated))> {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static block_type encrypt(const block_type &plaintext, std::size_t iterations,
+                                              const key_schedule_type &encryption_key) {
+                        return Impl::encrypt_iterated(plaintext, iterations, encryption_key);
+                    }
+                };
+
+                /*!
+                 * @brief Encrypts each block under the key schedule selected by its index. Backends
+                 * without a dedicated multi-key pass fall back to block-by-block processing.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_multi_key_encrypt {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void encrypt(const key_schedule_type *schedules, const std::size_t *indices,
+                                        const block_type *in, block_type *out, std::size_t blocks) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = Impl::encrypt_block(in[i], schedules[indices[i]]);
+                        }
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_multi_key_encrypt<Impl, PolicyType, decltype(void(&Impl::encrypt_multi_key))> {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void encrypt(const key_schedule_type *schedules, const std::size_t *indices,
+                                        const block_type *in, block_type *out, std::size_t blocks) {
+                        Impl::encrypt_multi_key(schedules, indices, in, out, blocks);
+                    }
+                };
+
+                /*!
+                 * @brief XORs the input with the encrypted counter blocks, the counter being a big-endian
+                 * integer over the whole block. Backends without a dedicated CTR pass go through the
+                 * counter mode pass of the modes on top of encrypt_blocks.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_ctr_encrypt {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void encrypt(const block_type &counter, const block_type *in, block_type *out,
+                                        std::size_t blocks, const key_schedule_type &encryption_key) {
+                        counter_keystream(
+                            [&encryption_key](block_type *stream, std::size_t n) {
+                                Impl::encrypt_blocks(stream, stream, n, encryption_key);
+                            },
+                            counter, in, out, blocks);
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_ctr_encrypt<Impl, PolicyType, decltype(void(&Impl::encrypt_ctr))> {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void encrypt(const block_type &counter, const block_type *in, block_type *out,
+                                        std::size_t blocks, const key_schedule_type &encryption_key) {
+                        Impl::encrypt_ctr(counter, in, out, blocks, encryption_key);
+                    }
+                };
+
+                /*!
+                 * @brief Advances independent CBC streams by the same amount of blocks, each under the
+                 * key schedule selected by its index. The chaining values are read and updated in place.
+                 * Backends without a dedicated pass run one multi-key call per step.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_cbc_multi_key_encrypt {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    constexpr static const std::size_t batch_lanes = 16;
+
+                    static void encrypt(const key_schedule_type *schedules, const std::size_t *indices,
+                                        block_type *chains, const block_type *const *in, block_type *const *out,
+                                        std::size_t lanes, std::size_t steps) {
+                        block_type blocks[batch_lanes];
+
+                        while (lanes != 0) {
+                            const std::size_t n = lanes < batch_lanes ? lanes : batch_lanes;
+
+                            for (std::size_t step = 0; step != steps; ++step) {
+                                for (std::size_t l = 0; l != n; ++l) {
+                                    for (std::size_t j = 0; j != blocks[l].size(); ++j) {
+                                        blocks[l][j] = chains[l][j] ^ in[l][step][j];
+                                    }
+                                }
+                                rijndael_multi_key_encrypt<Impl, PolicyType>::encrypt(schedules, indices, blocks,
+                                                                                      chains, n);
+                                for (std::size_t l = 0; l != n; ++l) {
+                                    out[l][step] = chains[l];
+                                }
+                            }
+
+                            indices += n;
+                            chains += n;
+                            in += n;
+                            out += n;
+                            lanes -= n;
+                        }
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_cbc_multi_key_encrypt<Impl, PolicyType,
+                                                      decltype(void(&Impl::encrypt_cbc_multi_key))> {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    static void encrypt(const key_schedule_type *schedules, const std::size_t *indices,
+                                        block_type *chains, const block_type *const *in, block_type *const *out,
+                                        std::size_t lanes, std::size_t steps) {
+                        Impl::encrypt_cbc_multi_key(schedules, indices, chains, in, out, lanes, steps);
+                    }
+                };
+
+                /*!
+                 * @brief Function table of a single Rijndael backend for the particular key and block size.
+                 */
+                template<typename PolicyType>
+                struct rijndael_backend_table {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_type key_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    rijndael_backend::type backend;
+
+                    void (*schedule_key)(const key_type &, key_schedule_type &, key_schedule_type &);
+                    void (*schedule_keys)(const key_type *, key_schedule_type *, key_schedule_type *, std::size_t);
+                    block_type (*encrypt_block)(const block_type &, const key_schedule_type &);
+                    block_type (*decrypt_block)(const block_type &, const key_schedule_type &);
+                    void (*encrypt_blocks)(const block_type *, block_type *, std::size_t, const key_schedule_type &);
+                    void (*decrypt_blocks)(const block_type *, block_type *, std::size_t, const key_schedule_type &);
+                    block_type (*encrypt_iterated)(const block_type &, std::size_t, const key_schedule_type &);
+                    void (*encrypt_multi_key)(const key_schedule_type *, const std::size_t *, const block_type *,
+                                              block_type *, std::size_t);
+                    void (*encrypt_ctr)(const block_type &, const block_type *, block_type *, std::size_t,
+                                        const key_schedule_type &);
+                    void (*encrypt_cbc_multi_key)(const key_schedule_type *, const std::size_t *, block_type *,
+                                                  const block_type *const *, block_type *const *, std::size_t,
+                                                  std::size_t);
+
+                    template<typename Impl>
+                    static const rijndael_backend_table &of(rijndael_backend::type backend) {
+                        static const rijndael_backend_table functions = {
+                            backend,
+                            &Impl::schedule_key,
+                            &rijndael_batch_key_schedule<Impl, PolicyType>::schedule,
+                            &Impl::encrypt_block,
+                            &Impl::decrypt_block,
+                            &Impl::encrypt_blocks,
+                            &Impl::decrypt_blocks,
+                            &rijndael_iterated_encrypt<Impl, PolicyType>::encrypt,
+                            &rijndael_multi_key_encrypt<Impl, PolicyType>::encrypt,
+                            &rijndael_ctr_encrypt<Impl, PolicyType>::encrypt,
+                            &rijndael_cbc_multi_key_encrypt<Impl, PolicyType>::encrypt};
+                        return functions;
+                    }
+                };
+
+                template<std::size_t KeyBits, std::size_t BlockBits, typename PolicyType>
+                class rijndael_dispatch {
+                    typedef rijndael_impl<KeyBits, BlockBits, PolicyType> generic_impl_type;
+
+                    /*
+                     * Most accelerated backends only implement AES, other key and block sizes fall back
+                     * to the generic implementation unless AES-NI is usable.
+                     */
+                    constexpr static const bool is_aes =
+                        BlockBits == 128 && (KeyBits == 128 || KeyBits == 192 || KeyBits == 256);
+
+                    template<template<std::size_t, std::size_t, typename> class Impl>
+                    using accelerated = typename std::conditional<is_aes, Impl<KeyBits, BlockBits, PolicyType>,
+                                                                  generic_impl_type>::type;
+
+                    template<template<std::size_t, std::size_t, typename> class Impl>
+                    using extended = typename std::conditional<is_aes, generic_impl_type,
+                                                               Impl<KeyBits, BlockBits, PolicyType>>::type;
+
+                public:
+                    typedef rijndael_backend_table<PolicyType> table_type;
+
+                    static const table_type &resolve(rijndael_backend::type backend) {
+                        return select<table_type>(backend);
+                    }
+
+                    /*!
+                     * @brief Picks the implementation for the backend and returns Table::of<Impl>. Both the
+                     * block function table and the mode pass tables go through it, so they always agree.
+                     */
+                    template<typename Table>
+                    static const Table &select(rijndael_backend::type backend) {
+                        if (is_aes) {
+                            switch (backend) {
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_NI_BACKEND)
+                                case rijndael_backend::aes_ni:
+                                    return Table::template of<accelerated<rijndael_ni_impl>>(backend);
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_VAES_BACKEND)
+                                case rijndael_backend::vaes_avx2:
+                                    return Table::template of<accelerated<rijndael_vaes_avx2_impl>>(backend);
+                                case rijndael_backend::vaes_avx512:
+                                    return Table::template of<accelerated<rijndael_vaes_avx512_impl>>(backend);
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_SSSE3_BACKEND)
+                                case rijndael_backend::ssse3:
+                                    return Table::template of<accelerated<rijndael_ssse3_impl>>(backend);
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_ARMV8_BACKEND)
+                                case rijndael_backend::armv8:
+                                    return Table::template of<accelerated<rijndael_armv8_impl>>(backend);
+#endif
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_POWER8_BACKEND)
+                                case rijndael_backend::power8:
+                                    return Table::template of<accelerated<rijndael_power8_impl>>(backend);
+#endif
+                                case rijndael_backend::bitsliced:
+                                    return Table::template of<accelerated<rijndael_bitsliced_impl>>(backend);
+                                default:
+                                    break;
+                            }
+                        } else {
+                            switch (backend) {
+#if defined(CRYPTO3_BLOCK_RIJNDAEL_HAS_NI_BACKEND)
+                                // Wider AES-NI backends only differ in bulk AES processing
+                                case rijndael_backend::aes_ni:
+                                case rijndael_backend::vaes_avx2:
+                                case rijndael_backend::vaes_avx512:
+                                    return Table::template of<extended<rijndael_ni_wide_impl>>(
+                                        rijndael_backend::aes_ni);
+#endif
+                                default:
+                                    break;
+                            }
+                        }
+                        return Table::template of<generic_impl_type>(rijndael_backend::generic);
+                    }
+                };
+            }    // namespace detail
+        }        // namespace block
+    }            // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_RIJNDAEL_DISPATCH_HPP
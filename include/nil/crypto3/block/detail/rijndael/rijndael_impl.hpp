@@ -22,13 +22,18 @@
 // SOFTWARE.
 //---------------------------------------------------------------------------//
 
+
 #ifndef CRYPTO3_RIJNDAEL_IMPL_HPP
 #define CRYPTO3_RIJNDAEL_IMPL_HPP
 
-#include <nil/crypto3/block/algorithm/move.hpp>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include <boost/config.hpp>
+#include <boost/static_assert.hpp>
 
-#include <nil/crypto3/detail/stream_endian.hpp>
-#include <nil/crypto3/detail/pack.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_policy.hpp>
 
 namespace nil {
     namespace crypto3 {
@@ -37,6 +42,69 @@ namespace nil {
              * @cond DETAIL_IMPL
              */
             namespace detail {
+                /*!
+                 * @brief Word-oriented lookup tables for the portable Rijndael implementation.
+                 * A single 256-word table per direction merges SubBytes with MixColumns for one
+                 * column byte, the other three positions are obtained with rotations. Tables are
+                 * generated at compile time from the S-boxes of PolicyType.
+                 */
+                template<typename PolicyType>
+                struct rijndael_tables {
+                    typedef std::uint32_t word_type;
+                    typedef std::uint8_t byte_type;
+
+                    constexpr static const std::size_t table_size = 256;
+                    typedef std::array<word_type, table_size> table_type;
+
+                    constexpr static byte_type xtime(byte_type s) {
+                        return static_cast<byte_type>((s << 1) ^ ((s >> 7) * 0x1B));
+                    }
+
+                    constexpr static byte_type mul(byte_type s, byte_type m) {
+                        return (m & 1 ? s : 0) ^ (m & 2 ? xtime(s) : 0) ^ (m & 4 ? xtime(xtime(s)) : 0) ^
+                               (m & 8 ? xtime(xtime(xtime(s))) : 0);
+                    }
+
+                    /*
+                     * Column words keep row 0 in the least significant byte
+                     */
+                    constexpr static word_type make_word(byte_type b0, byte_type b1, byte_type b2, byte_type b3) {
+                        return static_cast<word_type>(b0) | static_cast<word_type>(b1) << 8 |
+                               static_cast<word_type>(b2) << 16 | static_cast<word_type>(b3) << 24;
+                    }
+
+                    constexpr static word_type encryption_word(byte_type s) {
+                        return make_word(mul(s, 2), s, s, mul(s, 3));
+                    }
+
+                    constexpr static word_type decryption_word(byte_type s) {
+                        return make_word(mul(s, 14), mul(s, 9), mul(s, 13), mul(s, 11));
+                    }
+
+                    template<std::size_t... I>
+                    constexpr static table_type make_encryption_table(std::index_sequence<I...>) {
+                        return {{encryption_word(PolicyType::constants[I])...}};
+                    }
+
+                    template<std::size_t... I>
+                    constexpr static table_type make_decryption_table(std::index_sequence<I...>) {
+                        return {{decryption_word(PolicyType::inverted_constants[I])...}};
+                    }
+
+                    BOOST_ALIGNMENT(64) constexpr static const table_type te =
+                        make_encryption_table(std::make_index_sequence<table_size>());
+                    BOOST_ALIGNMENT(64) constexpr static const table_type td =
+                        make_decryption_table(std::make_index_sequence<table_size>());
+                };
+
+                template<typename PolicyType>
+                BOOST_ALIGNMENT(64) constexpr typename rijndael_tables<PolicyType>::table_type const
+                    rijndael_tables<PolicyType>::te;
+
+                template<typename PolicyType>
+                BOOST_ALIGNMENT(64) constexpr typename rijndael_tables<PolicyType>::table_type const
+                    rijndael_tables<PolicyType>::td;
+
                 template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
                 class rijndael_impl {
                     typedef PolicyType policy_type;
@@ -47,182 +115,262 @@ namespace nil {
 
                     typedef typename policy_type::block_type block_type;
 
-                    typedef typename policy_type::constants_type constants_type;
-                    typedef typename policy_type::shift_offsets_type shift_offsets_type;
-                    typedef typename policy_type::mm_type mm_type;
+                    // S-boxes do not depend on key and block sizes, so every variant shares one set of tables
+                    typedef rijndael_tables<rijndael_policy<128, 128>> tables_type;
+                    typedef typename tables_type::word_type word_type;
+                    typedef typename tables_type::byte_type byte_type;
+
+                    constexpr static const std::size_t block_words = policy_type::block_words;
+                    constexpr static const std::size_t rounds = policy_type::rounds;
+
+                    typedef std::array<word_type, block_words> state_type;
 
                     BOOST_STATIC_ASSERT(KeyBitsImpl == PolicyType::key_bits);
                     BOOST_STATIC_ASSERT(BlockBitsImpl == PolicyType::block_bits);
+                    BOOST_STATIC_ASSERT(sizeof(key_schedule_word_type) == sizeof(word_type));
 
-                    static inline key_schedule_word_type sub_word(const key_schedule_word_type &x,
-                                                                  const constants_type &constants) {
-                        key_schedule_word_type result = {0};
+                    /*
+                     * ShiftRows offsets: row r of output column j comes from input column j + shift_r
+                     */
+                    constexpr static const std::size_t shift1 = policy_type::shift_offsets[0];
+                    constexpr static const std::size_t shift2 = policy_type::shift_offsets[1];
+                    constexpr static const std::size_t shift3 = policy_type::shift_offsets[2];
 
-                        for (std::size_t i = 0; i < policy_type::word_bytes; ++i) {
-                            result =
-                                result << CHAR_BIT | constants[::nil::crypto3::detail::extract_uint_t<CHAR_BIT>(x, i)];
-                        }
+                    constexpr static const std::size_t inverse_shift1 = block_words - shift1;
+                    constexpr static const std::size_t inverse_shift2 = block_words - shift2;
+                    constexpr static const std::size_t inverse_shift3 = block_words - shift3;
 
-                        return result;
+                    static inline word_type rotate(word_type x, std::size_t bytes) {
+                        return bytes == 0 ? x : static_cast<word_type>(x << (8 * bytes) | x >> (32 - 8 * bytes));
                     }
 
-                    static inline void sub_bytes(block_type &state, const constants_type &sbox) {
-
-                        for (std::size_t i = 0; i < policy_type::word_bytes * policy_type::block_words; ++i) {
-                            state[i] = sbox[state[i]];
-                        }
+                    static inline byte_type get_byte(word_type x, std::size_t i) {
+                        return static_cast<byte_type>(x >> (8 * i));
                     }
 
-                    static inline void shift_rows(block_type &state, const shift_offsets_type &offset) {
-                        std::array<typename policy_type::byte_type, policy_type::block_words> tmp = {0};
-
-                        // row 0 never gets shifted
+                    static inline word_type load_word(const byte_type *p) {
+                        return tables_type::make_word(p[0], p[1], p[2], p[3]);
+                    }
 
-                        for (std::size_t row = 1; row < policy_type::word_bytes; ++row) {
-                            const std::size_t off = offset[row - 1];
+                    static inline void store_word(word_type x, byte_type *p) {
+                        p[0] = get_byte(x, 0);
+                        p[1] = get_byte(x, 1);
+                        p[2] = get_byte(x, 2);
+                        p[3] = get_byte(x, 3);
+                    }
 
-                            for (std::size_t i = 0; i < off; ++i) {
-                                tmp[i] = state[i * policy_type::word_bytes + row];
-                            }
+                    static inline word_type sub_word(word_type x) {
+                        return tables_type::make_word(
+                            policy_type::constants[get_byte(x, 0)], policy_type::constants[get_byte(x, 1)],
+                            policy_type::constants[get_byte(x, 2)], policy_type::constants[get_byte(x, 3)]);
+                    }
 
-                            for (std::size_t i = 0; i < policy_type::block_words - 1; ++i) {
-                                state[i * policy_type::word_bytes + row] =
-                                    state[(i + off) * policy_type::word_bytes + row];
-                            }
+                    static inline word_type inverse_mix_column(word_type x) {
+                        return tables_type::td[policy_type::constants[get_byte(x, 0)]] ^
+                               rotate(tables_type::td[policy_type::constants[get_byte(x, 1)]], 1) ^
+                               rotate(tables_type::td[policy_type::constants[get_byte(x, 2)]], 2) ^
+                               rotate(tables_type::td[policy_type::constants[get_byte(x, 3)]], 3);
+                    }
 
-                            for (std::size_t i = 0; i < off; ++i) {
-                                state[(policy_type::block_words - 1 - i) * policy_type::word_bytes + row] =
-                                    tmp[off - 1 - i];
-                            }
+                    /*
+                     * Reads one word from every cache line of the tables, so that the subsequent
+                     * key-dependent lookups don't reveal which lines were cold. The result is always
+                     * zero, reading through volatile keeps the compiler from proving that. Zero is the
+                     * index whose S-box entry, and so the table entry, is zero.
+                     */
+                    template<typename Table, typename SBox>
+                    static inline word_type touch_tables(const Table &table, const SBox &sbox, std::size_t zero) {
+                        const volatile word_type *words = table.data();
+                        const volatile byte_type *bytes = sbox.data();
+
+                        word_type z = 0;
+                        for (std::size_t i = 0; i < table.size(); i += 64 / sizeof(word_type)) {
+                            z |= words[i];
+                        }
+                        for (std::size_t i = 0; i < sbox.size(); i += 64) {
+                            z |= bytes[i];
                         }
+                        return z & words[zero] & bytes[zero];
                     }
 
-                    template<typename StateType>
-                    static inline block_type mix_columns(const StateType &state, const mm_type &mm) {
-                        block_type tmp = {0};
+                    /*
+                     * Output column J of a round. Shift offsets are passed already reduced modulo the
+                     * block width, so decryption reuses the same code with inverted offsets.
+                     */
+                    template<std::size_t J, std::size_t S1, std::size_t S2, std::size_t S3, typename Table>
+                    static inline word_type round_column(const state_type &state, const Table &table,
+                                                         const key_schedule_word_type *round_key) {
+                        return table[get_byte(state[J], 0)] ^
+                               rotate(table[get_byte(state[(J + S1) % block_words], 1)], 1) ^
+                               rotate(table[get_byte(state[(J + S2) % block_words], 2)], 2) ^
+                               rotate(table[get_byte(state[(J + S3) % block_words], 3)], 3) ^ round_key[J];
+                    }
 
+                    template<std::size_t J, std::size_t S1, std::size_t S2, std::size_t S3, typename SBox>
+                    static inline word_type final_column(const state_type &state, const SBox &sbox,
+                                                         const key_schedule_word_type *round_key) {
+                        return tables_type::make_word(sbox[get_byte(state[J], 0)],
+                                                      sbox[get_byte(state[(J + S1) % block_words], 1)],
+                                                      sbox[get_byte(state[(J + S2) % block_words], 2)],
+                                                      sbox[get_byte(state[(J + S3) % block_words], 3)]) ^
+                               round_key[J];
+                    }
 
-                        for (std::size_t col = 0; col < policy_type::block_words; ++col) {
+                    template<std::size_t S1, std::size_t S2, std::size_t S3, typename Table, std::size_t... J>
+                    static inline state_type round(const state_type &state, const Table &table,
+                                                   const key_schedule_word_type *round_key,
+                                                   std::index_sequence<J...>) {
+                        return {{round_column<J, S1, S2, S3>(state, table, round_key)...}};
+                    }
 
-                            for (std::size_t row = 0; row < policy_type::word_bytes; ++row) {
+                    template<std::size_t S1, std::size_t S2, std::size_t S3, typename SBox, std::size_t... J>
+                    static inline state_type final_round(const state_type &state, const SBox &sbox,
+                                                         const key_schedule_word_type *round_key,
+                                                         std::index_sequence<J...>) {
+                        return {{final_column<J, S1, S2, S3>(state, sbox, round_key)...}};
+                    }
 
-                                for (std::size_t k = 0; k < policy_type::word_bytes; ++k) {
-                                    tmp[col * policy_type::word_bytes + row] ^=
-                                        policy_type::mul(mm[row * policy_type::word_bytes + k],
-                                                         state[col * policy_type::word_bytes + k]);
-                                }
-                            }
-                        }
+                    static inline void encrypt_state(state_type &state, const key_schedule_type &key) {
+                        typedef std::make_index_sequence<block_words> columns;
 
-                        return tmp;
+                        for (std::size_t r = 1; r != rounds; ++r) {
+                            state = round<shift1, shift2, shift3>(state, tables_type::te,
+                                                                  key.data() + r * block_words, columns());
+                        }
+                        state = final_round<shift1, shift2, shift3>(state, policy_type::constants,
+                                                                    key.data() + rounds * block_words, columns());
                     }
 
-                    template<typename InputIterator>
-                    static inline void add_round_key(block_type &state, InputIterator first, InputIterator last) {
-                        BOOST_ASSERT(std::distance(first, last) == policy_type::block_words &&
-                                     state.size() == policy_type::block_bytes);
+                    static inline void decrypt_state(state_type &state, const key_schedule_type &key) {
+                        typedef std::make_index_sequence<block_words> columns;
 
+                        for (std::size_t r = rounds - 1; r != 0; --r) {
+                            state = round<inverse_shift1, inverse_shift2, inverse_shift3>(
+                                state, tables_type::td, key.data() + r * block_words, columns());
+                        }
+                        state = final_round<inverse_shift1, inverse_shift2, inverse_shift3>(
+                            state, policy_type::inverted_constants, key.data(), columns());
+                    }
 
-                        for (std::size_t i = 0; i < policy_type::block_words && first != last; ++i && ++first) {
-
-                            for (std::size_t j = 0; j < policy_type::word_bytes; ++j) {
-                                state[i * policy_type::word_bytes + j] ^=
-                                    ::nil::crypto3::detail::extract_uint_t<CHAR_BIT>(*first,
-                                                                                     policy_type::word_bytes - (j + 1));
-                            }
+                    static inline state_type load_state(const block_type &block, const key_schedule_word_type *key,
+                                                        word_type z) {
+                        state_type state;
+                        for (std::size_t j = 0; j != block_words; ++j) {
+                            state[j] = load_word(block.data() + 4 * j) ^ key[j] ^ z;
                         }
+                        return state;
                     }
 
-                    static inline void apply_round(std::uint8_t round, block_type &state, const key_schedule_type &w,
-                                                   const constants_type &sbox, const shift_offsets_type &offsets,
-                                                   const mm_type &mm) {
-                        sub_bytes(state, sbox);
-                        shift_rows(state, offsets);
-                        state = mix_columns(state, mm);
-                        add_round_key(state, w.begin() + round * policy_type::block_words,
-                                      w.begin() + (round + 1) * policy_type::block_words);
+                    static inline void store_state(const state_type &state, block_type &block) {
+                        for (std::size_t j = 0; j != block_words; ++j) {
+                            store_word(state[j], block.data() + 4 * j);
+                        }
                     }
 
                 public:
-                    static typename policy_type::block_type encrypt_block(const block_type &plaintext,
-                                                                          const key_schedule_type &encryption_key) {
-                        block_type state = plaintext;
+                    static block_type encrypt_block(const block_type &plaintext,
+                                                    const key_schedule_type &encryption_key) {
+                        block_type out;
+                        encrypt_blocks(&plaintext, &out, 1, encryption_key);
+                        return out;
+                    }
 
-                        add_round_key(state, encryption_key.begin(), encryption_key.begin() + policy_type::block_words);
+                    static block_type decrypt_block(const block_type &ciphertext,
+                                                    const key_schedule_type &decryption_key) {
+                        block_type out;
+                        decrypt_blocks(&ciphertext, &out, 1, decryption_key);
+                        return out;
+                    }
 
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        const word_type z = touch_tables(tables_type::te, policy_type::constants, 0x52);
 
-                        for (std::size_t round = 1; round < policy_type::rounds; ++round) {
-                            apply_round(round, state, encryption_key, policy_type::constants,
-                                        policy_type::shift_offsets, policy_type::mm);
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            state_type state = load_state(in[i], encryption_key.data(), z);
+                            encrypt_state(state, encryption_key);
+                            store_state(state, out[i]);
                         }
-
-                        sub_bytes(state, policy_type::constants);
-                        shift_rows(state, policy_type::shift_offsets);
-                        add_round_key(state, encryption_key.begin() + policy_type::rounds * policy_type::block_words,
-                                      encryption_key.begin() + (policy_type::rounds + 1) * policy_type::block_words);
-
-                        return state;
                     }
 
-                    static typename policy_type::block_type decrypt_block(const block_type &plaintext,
-                                                                          const key_schedule_type &decryption_key) {
-                        block_type state = plaintext;
-
-                        add_round_key(state, decryption_key.begin() + policy_type::rounds * policy_type::block_words,
-                                      decryption_key.begin() + (policy_type::rounds + 1) * policy_type::block_words);
+                    static block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations,
+                                                       const key_schedule_type &encryption_key) {
+                        if (iterations == 0) {
+                            return plaintext;
+                        }
 
+                        const word_type z = touch_tables(tables_type::te, policy_type::constants, 0x52);
 
-                        for (std::size_t round = policy_type::rounds - 1; round > 0; --round) {
-                            apply_round(round, state, decryption_key, policy_type::inverted_constants,
-                                        policy_type::inverted_shift_offsets, policy_type::inverted_mm);
+                        state_type state = load_state(plaintext, encryption_key.data(), z);
+                        encrypt_state(state, encryption_key);
+                        for (std::size_t i = 1; i != iterations; ++i) {
+                            for (std::size_t j = 0; j != block_words; ++j) {
+                                state[j] ^= encryption_key[j];
+                            }
+                            encrypt_state(state, encryption_key);
                         }
 
-                        sub_bytes(state, policy_type::inverted_constants);
-                        shift_rows(state, policy_type::inverted_shift_offsets);
-                        add_round_key(state, decryption_key.begin(), decryption_key.begin() + policy_type::block_words);
-
-                        return state;
+                        block_type out;
+                        store_state(state, out);
+                        return out;
                     }
 
-                    static void schedule_key(const key_type &key, key_schedule_type &encryption_key,
-                                             key_schedule_type &decryption_key) {
-                        // the first key_words words are the original key
-                        ::nil::crypto3::detail::pack<stream_endian::big_octet_big_bit,
-                                                     stream_endian::little_octet_big_bit, CHAR_BIT,
-                                                     policy_type::word_bits>(
-                            key.begin(), key.begin() + policy_type::key_words * policy_type::word_bytes,
-                            encryption_key.begin());
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        const word_type z = touch_tables(tables_type::td, policy_type::inverted_constants, 0x63);
 
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            state_type state =
+                                load_state(in[i], decryption_key.data() + rounds * block_words, z);
+                            decrypt_state(state, decryption_key);
+                            store_state(state, out[i]);
+                        }
+                    }
+
+                    static void expand_key(const key_type &key, key_schedule_type &encryption_key) {
+                        for (std::size_t i = 0; i != policy_type::key_words; ++i) {
+                            encryption_key[i] = load_word(key.data() + 4 * i);
+                        }
 
-                        for (std::size_t i = policy_type::key_words; i < policy_type::key_schedule_words; ++i) {
-                            typename policy_type::key_schedule_word_type tmp = encryption_key[i - 1];
+                        for (std::size_t i = policy_type::key_words; i != policy_type::key_schedule_words; ++i) {
+                            word_type tmp = encryption_key[i - 1];
                             if (i % policy_type::key_words == 0) {
-                                tmp = sub_word(policy_type::rotate_left(tmp), policy_type::constants) ^
+                                tmp = sub_word(rotate(tmp, 3)) ^
                                       policy_type::round_constants[i / policy_type::key_words - 1];
                             } else if (policy_type::key_words > 6 && i % policy_type::key_words == 4) {
-                                tmp = sub_word(tmp, policy_type::constants);
+                                tmp = sub_word(tmp);
                             }
                             encryption_key[i] = encryption_key[i - policy_type::key_words] ^ tmp;
                         }
+                    }
 
-                        std::array<typename policy_type::byte_type, policy_type::key_schedule_bytes> bekey = {0};
-                        ::nil::crypto3::detail::pack<stream_endian::little_octet_big_bit,
-                                                     stream_endian::big_octet_big_bit, policy_type::word_bits,
-                                                     CHAR_BIT>(encryption_key.begin(), encryption_key.end(),
-                                                               bekey.begin());
+                    // Equivalent inverse cipher: inner round keys go through InvMixColumns
+                    static void inverse_key(const key_schedule_type &encryption_key,
+                                            key_schedule_type &decryption_key) {
+                        decryption_key = encryption_key;
+                        for (std::size_t i = block_words; i != rounds * block_words; ++i) {
+                            decryption_key[i] = inverse_mix_column(encryption_key[i]);
+                        }
+                    }
 
+                    static void schedule_key(const key_type &key, key_schedule_type &encryption_key,
+                                             key_schedule_type &decryption_key) {
+                        expand_key(key, encryption_key);
+                        inverse_key(encryption_key, decryption_key);
+                    }
 
-                        for (std::uint8_t round = 1; round < policy_type::rounds; ++round) {
-                            move(mix_columns(boost::adaptors::slice(bekey, round * policy_type::block_bytes,
-                                                                    (round + 1) * policy_type::block_bytes),
-                                             policy_type::inverted_mm),
-                                 bekey.begin() + round * policy_type::block_bytes);
+                    /*!
+                     * @brief Expands a batch of keys. Decryption schedules are skipped if decryption_keys is null,
+                     * which saves the InvMixColumns pass, the larger part of the key setup cost.
+                     */
+                    static void schedule_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                              key_schedule_type *decryption_keys, std::size_t count) {
+                        for (std::size_t i = 0; i != count; ++i) {
+                            expand_key(keys[i], encryption_keys[i]);
+                            if (decryption_keys) {
+                                inverse_key(encryption_keys[i], decryption_keys[i]);
+                            }
                         }
-
-                        ::nil::crypto3::detail::pack<stream_endian::big_octet_big_bit,
-                                                     stream_endian::little_octet_big_bit, CHAR_BIT,
-                                                     policy_type::word_bits>(bekey.begin(), bekey.end(),
-                                                                             decryption_key.begin());
                     }
                 };
             }    // namespace detail
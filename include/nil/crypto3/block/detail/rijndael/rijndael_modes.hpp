@@ -0,0 +1,346 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_RIJNDAEL_MODES_HPP
+#define CRYPTO3_RIJNDAEL_MODES_HPP
+
+#include <cstddef>
+
+#include <nil/crypto3/block/detail/cipher_modes.hpp>
+#include <nil/crypto3/block/detail/ghash/ghash.hpp>
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_policy.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_dispatch.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael;
+
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael_encryptor;
+
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael_decryptor;
+
+            namespace detail {
+                /*!
+                 * @brief Fused mode passes of a single Rijndael backend. A pass is null if the backend has
+                 * none, and the mode then runs its own code on top of the bulk block functions.
+                 */
+                template<typename PolicyType>
+                struct rijndael_mode_table {
+                    typedef typename PolicyType::block_type block_type;
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+
+                    typedef void (*xts_pass)(block_type &, const block_type *, block_type *, std::size_t,
+                                             const key_schedule_type &);
+                    typedef void (*ccm_pass)(block_type &, const block_type *, block_type *, std::size_t,
+                                             const key_schedule_type &, block_type &);
+                    typedef void (*ocb_pass)(const block_type *, const block_type *, block_type *, std::size_t,
+                                             const key_schedule_type &, block_type &);
+                    typedef void (*pmac_pass)(const block_type *, const block_type *, std::size_t,
+                                              const key_schedule_type &, block_type &);
+                    typedef void (*gcm_pass)(block_type &, const block_type *, block_type *, std::size_t,
+                                             const key_schedule_type &, const ghash_key &, block_type &);
+
+                    xts_pass encrypt_xts, decrypt_xts;
+                    gcm_pass encrypt_gcm, decrypt_gcm;
+                    ccm_pass encrypt_ccm, decrypt_ccm;
+                    ocb_pass encrypt_ocb, decrypt_ocb;
+                    pmac_pass encrypt_pmac;
+
+                    template<typename Impl>
+                    static const rijndael_mode_table &of(rijndael_backend::type backend);
+                };
+
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_xts_passes {
+                    static void fill(rijndael_mode_table<PolicyType> &) {
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_xts_passes<Impl, PolicyType, decltype(void(&Impl::encrypt_xts))> {
+                    static void fill(rijndael_mode_table<PolicyType> &passes) {
+                        passes.encrypt_xts = &Impl::encrypt_xts;
+                        passes.decrypt_xts = &Impl::decrypt_xts;
+                    }
+                };
+
+                /*!
+                 * @brief GCM passes of a backend. The fused ones multiply with carry-less instructions
+                 * and are left out on hosts without them.
+                 */
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_gcm_passes {
+                    static void fill(rijndael_mode_table<PolicyType> &) {
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_gcm_passes<Impl, PolicyType, decltype(void(&Impl::encrypt_gcm))> {
+                    static void fill(rijndael_mode_table<PolicyType> &passes) {
+                        if (ghash::has_clmul()) {
+                            passes.encrypt_gcm = &Impl::encrypt_gcm;
+                            passes.decrypt_gcm = &Impl::decrypt_gcm;
+                        }
+                    }
+                };
+
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_ccm_passes {
+                    static void fill(rijndael_mode_table<PolicyType> &) {
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_ccm_passes<Impl, PolicyType, decltype(void(&Impl::encrypt_ccm))> {
+                    static void fill(rijndael_mode_table<PolicyType> &passes) {
+                        passes.encrypt_ccm = &Impl::encrypt_ccm;
+                        passes.decrypt_ccm = &Impl::decrypt_ccm;
+                    }
+                };
+
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_ocb_passes {
+                    static void fill(rijndael_mode_table<PolicyType> &) {
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_ocb_passes<Impl, PolicyType, decltype(void(&Impl::encrypt_ocb))> {
+                    static void fill(rijndael_mode_table<PolicyType> &passes) {
+                        passes.encrypt_ocb = &Impl::encrypt_ocb;
+                        passes.decrypt_ocb = &Impl::decrypt_ocb;
+                    }
+                };
+
+                template<typename Impl, typename PolicyType, typename = void>
+                struct rijndael_pmac_passes {
+                    static void fill(rijndael_mode_table<PolicyType> &) {
+                    }
+                };
+
+                template<typename Impl, typename PolicyType>
+                struct rijndael_pmac_passes<Impl, PolicyType, decltype(void(&Impl::encrypt_pmac))> {
+                    static void fill(rijndael_mode_table<PolicyType> &passes) {
+                        passes.encrypt_pmac = &Impl::encrypt_pmac;
+                    }
+                };
+
+                template<typename PolicyType>
+                template<typename Impl>
+                const rijndael_mode_table<PolicyType> &rijndael_mode_table<PolicyType>::of(rijndael_backend::type) {
+                    static const rijndael_mode_table passes = []() {
+                        rijndael_mode_table filled = {};
+                        rijndael_xts_passes<Impl, PolicyType>::fill(filled);
+                        rijndael_gcm_passes<Impl, PolicyType>::fill(filled);
+                        rijndael_ccm_passes<Impl, PolicyType>::fill(filled);
+                        rijndael_ocb_passes<Impl, PolicyType>::fill(filled);
+                        rijndael_pmac_passes<Impl, PolicyType>::fill(filled);
+                        return filled;
+                    }();
+                    return passes;
+                }
+
+                /*!
+                 * @brief Gives the mode backends below access to the key schedules of a Rijndael
+                 * instance and to the mode passes of the backend it was scheduled for.
+                 */
+                template<typename Cipher, typename PolicyType>
+                struct rijndael_mode_access {
+                    typedef void enabled;
+
+                    typedef typename PolicyType::key_schedule_type key_schedule_type;
+                    typedef rijndael_mode_table<PolicyType> table_type;
+                    typedef rijndael_dispatch<PolicyType::key_bits, PolicyType::block_bits, PolicyType> dispatch_type;
+
+                    static const table_type &passes(const Cipher &cipher) {
+                        return dispatch_type::template select<table_type>(cipher.impl->backend);
+                    }
+
+                    static const key_schedule_type &encryption_key(const Cipher &cipher) {
+                        return cipher.encryption_key;
+                    }
+
+                    static const key_schedule_type &decryption_key(const Cipher &cipher) {
+                        return cipher.decryption_key;
+                    }
+                };
+
+                template<typename Cipher>
+                struct rijndael_mode_backend { };
+
+                template<std::size_t KeyBits, std::size_t BlockBits>
+                struct rijndael_mode_backend<rijndael<KeyBits, BlockBits>>
+                    : public rijndael_mode_access<rijndael<KeyBits, BlockBits>,
+                                                  rijndael_policy<KeyBits, BlockBits>> { };
+
+                template<std::size_t KeyBits, std::size_t BlockBits>
+                struct rijndael_mode_backend<rijndael_encryptor<KeyBits, BlockBits>>
+                    : public rijndael_mode_access<rijndael_encryptor<KeyBits, BlockBits>,
+                                                  rijndael_policy<KeyBits, BlockBits>> { };
+
+                template<std::size_t KeyBits, std::size_t BlockBits>
+                struct rijndael_mode_backend<rijndael_decryptor<KeyBits, BlockBits>>
+                    : public rijndael_mode_access<rijndael_decryptor<KeyBits, BlockBits>,
+                                                  rijndael_policy<KeyBits, BlockBits>> { };
+
+                template<typename Cipher>
+                struct xts_backend<Cipher, typename rijndael_mode_backend<Cipher>::enabled> {
+                    typedef rijndael_mode_backend<Cipher> access_type;
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &cipher, block_type &tweak, const block_type *in, block_type *out,
+                                        std::size_t blocks) {
+                        const typename access_type::table_type::xts_pass pass =
+                            access_type::passes(cipher).encrypt_xts;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(tweak, in, out, blocks, access_type::encryption_key(cipher));
+                        return true;
+                    }
+
+                    static bool decrypt(const Cipher &cipher, block_type &tweak, const block_type *in, block_type *out,
+                                        std::size_t blocks) {
+                        const typename access_type::table_type::xts_pass pass =
+                            access_type::passes(cipher).decrypt_xts;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(tweak, in, out, blocks, access_type::decryption_key(cipher));
+                        return true;
+                    }
+                };
+
+                template<typename Cipher>
+                struct gcm_backend<Cipher, typename rijndael_mode_backend<Cipher>::enabled> {
+                    typedef rijndael_mode_backend<Cipher> access_type;
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &cipher, const ghash_key &key, block_type &counter,
+                                        block_type &hash, const block_type *in, block_type *out, std::size_t blocks) {
+                        const typename access_type::table_type::gcm_pass pass =
+                            access_type::passes(cipher).encrypt_gcm;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(counter, in, out, blocks, access_type::encryption_key(cipher), key, hash);
+                        return true;
+                    }
+
+                    static bool decrypt(const Cipher &cipher, const ghash_key &key, block_type &counter,
+                                        block_type &hash, const block_type *in, block_type *out, std::size_t blocks) {
+                        const typename access_type::table_type::gcm_pass pass =
+                            access_type::passes(cipher).decrypt_gcm;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        // GCM runs the cipher forwards in both directions
+                        pass(counter, in, out, blocks, access_type::encryption_key(cipher), key, hash);
+                        return true;
+                    }
+                };
+
+                template<typename Cipher>
+                struct ccm_backend<Cipher, typename rijndael_mode_backend<Cipher>::enabled> {
+                    typedef rijndael_mode_backend<Cipher> access_type;
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &cipher, block_type &counter, block_type &mac,
+                                        const block_type *in, block_type *out, std::size_t blocks) {
+                        const typename access_type::table_type::ccm_pass pass =
+                            access_type::passes(cipher).encrypt_ccm;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(counter, in, out, blocks, access_type::encryption_key(cipher), mac);
+                        return true;
+                    }
+
+                    static bool decrypt(const Cipher &cipher, block_type &counter, block_type &mac,
+                                        const block_type *in, block_type *out, std::size_t blocks) {
+                        const typename access_type::table_type::ccm_pass pass =
+                            access_type::passes(cipher).decrypt_ccm;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(counter, in, out, blocks, access_type::encryption_key(cipher), mac);
+                        return true;
+                    }
+                };
+
+                template<typename Cipher>
+                struct ocb_backend<Cipher, typename rijndael_mode_backend<Cipher>::enabled> {
+                    typedef rijndael_mode_backend<Cipher> access_type;
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &cipher, const block_type *offsets, const block_type *in,
+                                        block_type *out, std::size_t blocks, block_type &checksum) {
+                        const typename access_type::table_type::ocb_pass pass =
+                            access_type::passes(cipher).encrypt_ocb;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(offsets, in, out, blocks, access_type::encryption_key(cipher), checksum);
+                        return true;
+                    }
+
+                    static bool decrypt(const Cipher &cipher, const block_type *offsets, const block_type *in,
+                                        block_type *out, std::size_t blocks, block_type &checksum) {
+                        const typename access_type::table_type::ocb_pass pass =
+                            access_type::passes(cipher).decrypt_ocb;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(offsets, in, out, blocks, access_type::decryption_key(cipher), checksum);
+                        return true;
+                    }
+                };
+
+                template<typename Cipher>
+                struct pmac_backend<Cipher, typename rijndael_mode_backend<Cipher>::enabled> {
+                    typedef rijndael_mode_backend<Cipher> access_type;
+                    typedef typename Cipher::block_type block_type;
+
+                    static bool encrypt(const Cipher &cipher, const block_type *offsets, const block_type *in,
+                                        std::size_t blocks, block_type &sum) {
+                        const typename access_type::table_type::pmac_pass pass =
+                            access_type::passes(cipher).encrypt_pmac;
+                        if (pass == nullptr) {
+                            return false;
+                        }
+                        pass(offsets, in, blocks, access_type::encryption_key(cipher), sum);
+                        return true;
+                    }
+                };
+            }    // namespace detail
+        }        // namespace block
+    }            // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_RIJNDAEL_MODES_HPP
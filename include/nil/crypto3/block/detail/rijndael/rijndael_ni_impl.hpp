@@ -26,13 +26,23 @@
 #define CRYPTO3_RIJNDAEL_NI_IMPL_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <utility>
 
+#include <tmmintrin.h>
 #include <wmmintrin.h>
 
 #include <nil/crypto3/detail/make_uint_t.hpp>
 #include <nil/crypto3/detail/pack.hpp>
 #include <nil/crypto3/detail/config.hpp>
 
+#include <nil/crypto3/block/detail/ghash/ghash.hpp>
+#include <nil/crypto3/block/detail/ghash/ghash_clmul_impl.hpp>
+
+#ifndef CRYPTO3_BLOCK_CIPHER_PAR_MULT
+#define CRYPTO3_BLOCK_CIPHER_PAR_MULT 4
+#endif
+
 namespace nil {
     namespace crypto3 {
         namespace block {
@@ -40,26 +50,54 @@ namespace nil {
              * @cond DETAIL_IMPL
              */
             namespace detail {
+                /*!
+                 * @brief Amount of blocks processed simultaneously by bulk AES-NI routines.
+                 * AES-NI native parallelism is two blocks (two AES units per core), scaled
+                 * with CRYPTO3_BLOCK_CIPHER_PAR_MULT.
+                 */
+                constexpr static const std::size_t rijndael_ni_parallel_blocks = 2 * CRYPTO3_BLOCK_CIPHER_PAR_MULT;
+
+                /*!
+                 * @brief Keys expanded in lockstep by the batched key schedule. Each expansion step
+                 * waits for SubWord of the previous round key, independent keys fill that gap.
+                 */
+                constexpr static const std::size_t rijndael_ni_key_lanes = 4;
+
+                /*
+                 * pshufb masks broadcasting a key word, optionally rotated, to all four columns
+                 */
+                constexpr static const int aes_ni_rot_word1 = 0x04070605;
+                constexpr static const int aes_ni_rot_word3 = 0x0c0f0e0d;
+                constexpr static const int aes_ni_word3 = 0x0f0e0d0c;
+
+                /*!
+                 * @brief SubWord of a key word broadcast to all columns, xored with the round constant.
+                 * With equal columns ShiftRows is a no-op, so aesenclast computes exactly that. This
+                 * replaces aeskeygenassist, which is microcoded and several times slower on recent cores.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline __m128i aes_ni_sub_word(__m128i key, int shuffle, int rcon) {
+                    return _mm_aesenclast_si128(_mm_shuffle_epi8(key, _mm_set1_epi32(shuffle)), _mm_set1_epi32(rcon));
+                }
+
                 BOOST_ATTRIBUTE_TARGET("ssse3,aes")
-                __m128i aes_128_key_expansion(__m128i key, __m128i key_with_rcon) {
-                    key_with_rcon = _mm_shuffle_epi32(key_with_rcon, _MM_SHUFFLE(3, 3, 3, 3));
+                inline __m128i aes_128_key_expansion(__m128i key, __m128i sub_word) {
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
-                    return _mm_xor_si128(key, key_with_rcon);
+                    return _mm_xor_si128(key, sub_word);
                 }
 
                 BOOST_ATTRIBUTE_TARGET("ssse3,aes")
-                void aes_192_key_expansion(__m128i *K1, __m128i *K2, __m128i key2_with_rcon, uint32_t out[],
-                                           bool last) {
+                inline void aes_192_key_expansion(__m128i *K1, __m128i *K2, __m128i sub_word, uint32_t out[],
+                                                  bool last) {
                     __m128i key1 = *K1;
                     __m128i key2 = *K2;
 
-                    key2_with_rcon = _mm_shuffle_epi32(key2_with_rcon, _MM_SHUFFLE(1, 1, 1, 1));
                     key1 = _mm_xor_si128(key1, _mm_slli_si128(key1, 4));
                     key1 = _mm_xor_si128(key1, _mm_slli_si128(key1, 4));
                     key1 = _mm_xor_si128(key1, _mm_slli_si128(key1, 4));
-                    key1 = _mm_xor_si128(key1, key2_with_rcon);
+                    key1 = _mm_xor_si128(key1, sub_word);
 
                     *K1 = key1;
                     _mm_storeu_si128(reinterpret_cast<__m128i *>(out), key1);
@@ -80,14 +118,839 @@ namespace nil {
                  * The second half of the AES-256 key expansion (other half same as AES-128)
                  */
                 BOOST_ATTRIBUTE_TARGET("ssse3,aes")
-                __m128i aes_256_key_expansion(__m128i key, __m128i key2) {
-                    __m128i key_with_rcon = _mm_aeskeygenassist_si128(key2, 0x00);
-                    key_with_rcon = _mm_shuffle_epi32(key_with_rcon, _MM_SHUFFLE(2, 2, 2, 2));
+                inline __m128i aes_256_key_expansion(__m128i key, __m128i key2) {
+                    const __m128i sub_word = aes_ni_sub_word(key2, aes_ni_word3, 0x00);
 
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
                     key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
-                    return _mm_xor_si128(key, key_with_rcon);
+                    return _mm_xor_si128(key, sub_word);
+                }
+
+                /*!
+                 * @brief Builds equivalent inverse cipher schedules for a batch of keys. The aesimc
+                 * calls of a schedule do not depend on each other, so they are issued back to back.
+                 */
+                template<std::size_t Rounds, typename KeySchedule>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_inverse_key_schedules(const KeySchedule *encryption_keys,
+                                                         KeySchedule *decryption_keys, std::size_t count) {
+                    for (std::size_t k = 0; k != count; ++k) {
+                        const __m128i *EK_mm = reinterpret_cast<const __m128i *>(encryption_keys[k].data());
+                        __m128i *DK_mm = reinterpret_cast<__m128i *>(decryption_keys[k].data());
+
+                        _mm_storeu_si128(DK_mm, _mm_loadu_si128(EK_mm + Rounds));
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            _mm_storeu_si128(DK_mm + r, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + Rounds - r)));
+                        }
+                        _mm_storeu_si128(DK_mm + Rounds, _mm_loadu_si128(EK_mm));
+                    }
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_enc_4(__m128i &B0, __m128i &B1, __m128i &B2, __m128i &B3, const __m128i &K) {
+                    B0 = _mm_aesenc_si128(B0, K);
+                    B1 = _mm_aesenc_si128(B1, K);
+                    B2 = _mm_aesenc_si128(B2, K);
+                    B3 = _mm_aesenc_si128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_enclast_4(__m128i &B0, __m128i &B1, __m128i &B2, __m128i &B3, const __m128i &K) {
+                    B0 = _mm_aesenclast_si128(B0, K);
+                    B1 = _mm_aesenclast_si128(B1, K);
+                    B2 = _mm_aesenclast_si128(B2, K);
+                    B3 = _mm_aesenclast_si128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_dec_4(__m128i &B0, __m128i &B1, __m128i &B2, __m128i &B3, const __m128i &K) {
+                    B0 = _mm_aesdec_si128(B0, K);
+                    B1 = _mm_aesdec_si128(B1, K);
+                    B2 = _mm_aesdec_si128(B2, K);
+                    B3 = _mm_aesdec_si128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_declast_4(__m128i &B0, __m128i &B1, __m128i &B2, __m128i &B3, const __m128i &K) {
+                    B0 = _mm_aesdeclast_si128(B0, K);
+                    B1 = _mm_aesdeclast_si128(B1, K);
+                    B2 = _mm_aesdeclast_si128(B2, K);
+                    B3 = _mm_aesdeclast_si128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_xor_4(__m128i &B0, __m128i &B1, __m128i &B2, __m128i &B3, const __m128i &K) {
+                    B0 = _mm_xor_si128(B0, K);
+                    B1 = _mm_xor_si128(B1, K);
+                    B2 = _mm_xor_si128(B2, K);
+                    B3 = _mm_xor_si128(B3, K);
+                }
+
+                /*!
+                 * @brief Interleaved AES-NI pass over contiguous blocks. Up to
+                 * rijndael_ni_parallel_blocks independent aesenc/aesdec chains are kept
+                 * in flight, so the round latency is hidden behind the other blocks.
+                 * @tparam Rounds Cipher rounds count
+                 * @tparam Decrypt Use aesdec/aesdeclast with an inverse key schedule
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_blocks(const uint8_t *in, uint8_t *out, std::size_t blocks,
+                                                  const __m128i *key_mm) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    while (rijndael_ni_parallel_blocks >= 8 && blocks >= 8) {
+                        __m128i B0 = _mm_loadu_si128(in_mm);
+                        __m128i B1 = _mm_loadu_si128(in_mm + 1);
+                        __m128i B2 = _mm_loadu_si128(in_mm + 2);
+                        __m128i B3 = _mm_loadu_si128(in_mm + 3);
+                        __m128i B4 = _mm_loadu_si128(in_mm + 4);
+                        __m128i B5 = _mm_loadu_si128(in_mm + 5);
+                        __m128i B6 = _mm_loadu_si128(in_mm + 6);
+                        __m128i B7 = _mm_loadu_si128(in_mm + 7);
+
+                        __m128i K = _mm_loadu_si128(key_mm);
+                        aes_ni_xor_4(B0, B1, B2, B3, K);
+                        aes_ni_xor_4(B4, B5, B6, B7, K);
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            K = _mm_loadu_si128(key_mm + r);
+                            if (Decrypt) {
+                                aes_ni_dec_4(B0, B1, B2, B3, K);
+                                aes_ni_dec_4(B4, B5, B6, B7, K);
+                            } else {
+                                aes_ni_enc_4(B0, B1, B2, B3, K);
+                                aes_ni_enc_4(B4, B5, B6, B7, K);
+                            }
+                        }
+
+                        K = _mm_loadu_si128(key_mm + Rounds);
+                        if (Decrypt) {
+                            aes_ni_declast_4(B0, B1, B2, B3, K);
+                            aes_ni_declast_4(B4, B5, B6, B7, K);
+                        } else {
+                            aes_ni_enclast_4(B0, B1, B2, B3, K);
+                            aes_ni_enclast_4(B4, B5, B6, B7, K);
+                        }
+
+                        _mm_storeu_si128(out_mm, B0);
+                        _mm_storeu_si128(out_mm + 1, B1);
+                        _mm_storeu_si128(out_mm + 2, B2);
+                        _mm_storeu_si128(out_mm + 3, B3);
+                        _mm_storeu_si128(out_mm + 4, B4);
+                        _mm_storeu_si128(out_mm + 5, B5);
+                        _mm_storeu_si128(out_mm + 6, B6);
+                        _mm_storeu_si128(out_mm + 7, B7);
+
+                        in_mm += 8;
+                        out_mm += 8;
+                        blocks -= 8;
+                    }
+
+                    while (rijndael_ni_parallel_blocks >= 4 && blocks >= 4) {
+                        __m128i B0 = _mm_loadu_si128(in_mm);
+                        __m128i B1 = _mm_loadu_si128(in_mm + 1);
+                        __m128i B2 = _mm_loadu_si128(in_mm + 2);
+                        __m128i B3 = _mm_loadu_si128(in_mm + 3);
+
+                        aes_ni_xor_4(B0, B1, B2, B3, _mm_loadu_si128(key_mm));
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            if (Decrypt) {
+                                aes_ni_dec_4(B0, B1, B2, B3, _mm_loadu_si128(key_mm + r));
+                            } else {
+                                aes_ni_enc_4(B0, B1, B2, B3, _mm_loadu_si128(key_mm + r));
+                            }
+                        }
+
+                        if (Decrypt) {
+                            aes_ni_declast_4(B0, B1, B2, B3, _mm_loadu_si128(key_mm + Rounds));
+                        } else {
+                            aes_ni_enclast_4(B0, B1, B2, B3, _mm_loadu_si128(key_mm + Rounds));
+                        }
+
+                        _mm_storeu_si128(out_mm, B0);
+                        _mm_storeu_si128(out_mm + 1, B1);
+                        _mm_storeu_si128(out_mm + 2, B2);
+                        _mm_storeu_si128(out_mm + 3, B3);
+
+                        in_mm += 4;
+                        out_mm += 4;
+                        blocks -= 4;
+                    }
+
+                    for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                        __m128i B = _mm_xor_si128(_mm_loadu_si128(in_mm), _mm_loadu_si128(key_mm));
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = Decrypt ? _mm_aesdec_si128(B, _mm_loadu_si128(key_mm + r)) :
+                                          _mm_aesenc_si128(B, _mm_loadu_si128(key_mm + r));
+                        }
+
+                        B = Decrypt ? _mm_aesdeclast_si128(B, _mm_loadu_si128(key_mm + Rounds)) :
+                                      _mm_aesenclast_si128(B, _mm_loadu_si128(key_mm + Rounds));
+
+                        _mm_storeu_si128(out_mm, B);
+                    }
+                }
+
+                /*!
+                 * @brief Encrypts the block iterations times in a row. Round keys are loaded once
+                 * and stay in registers along with the state for the whole chain.
+                 */
+                template<std::size_t Rounds, std::size_t... R>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_iterated(const uint8_t *in, uint8_t *out, std::size_t iterations,
+                                                    const __m128i *key_mm, std::index_sequence<R...>) {
+                    typedef int expand[];
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    const __m128i K[] = {_mm_loadu_si128(key_mm + 1 + R)...};
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+
+                    __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                    for (; iterations != 0; --iterations) {
+                        B = _mm_xor_si128(B, K0);
+                        (void)expand {0, (B = _mm_aesenc_si128(B, K[R]), 0)...};
+                        B = _mm_aesenclast_si128(B, KN);
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), B);
+                }
+
+                /*!
+                 * @brief Encrypts count blocks, each under its own key schedule. Every block
+                 * is an independent aesenc chain, so the lanes overlap like in the single-key
+                 * bulk pass and only the round key loads differ.
+                 */
+                template<std::size_t Rounds, typename KeySchedule, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_multi_key(const KeySchedule *schedules, const std::size_t *indices,
+                                                     const uint8_t *in, uint8_t *out, std::index_sequence<I...>) {
+                    typedef int expand[];
+
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    const __m128i *keys[sizeof...(I)] = {
+                        reinterpret_cast<const __m128i *>(schedules[indices[I]].data())...};
+                    __m128i B[sizeof...(I)] = {_mm_xor_si128(_mm_loadu_si128(in_mm + I), _mm_loadu_si128(keys[I]))...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], _mm_loadu_si128(keys[I] + r)), 0)...};
+                    }
+                    (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], _mm_loadu_si128(keys[I] + Rounds)), 0)...};
+
+                    (void)expand {0, (_mm_storeu_si128(out_mm + I, B[I]), 0)...};
+                }
+
+                template<std::size_t Rounds, typename KeySchedule>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_multi_key(const KeySchedule *schedules, const std::size_t *indices,
+                                                     const uint8_t *in, uint8_t *out, std::size_t blocks) {
+                    for (; blocks >= rijndael_ni_parallel_blocks; blocks -= rijndael_ni_parallel_blocks) {
+                        aes_ni_encrypt_multi_key<Rounds>(schedules, indices, in, out,
+                                                         std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        indices += rijndael_ni_parallel_blocks;
+                        in += 16 * rijndael_ni_parallel_blocks;
+                        out += 16 * rijndael_ni_parallel_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_encrypt_multi_key<Rounds>(schedules, indices, in, out, std::make_index_sequence<4>());
+                        blocks -= 4;
+                        indices += 4;
+                        in += 64;
+                        out += 64;
+                    }
+                    if (blocks >= 2) {
+                        aes_ni_encrypt_multi_key<Rounds>(schedules, indices, in, out, std::make_index_sequence<2>());
+                        blocks -= 2;
+                        indices += 2;
+                        in += 32;
+                        out += 32;
+                    }
+                    if (blocks) {
+                        aes_ni_encrypt_multi_key<Rounds>(schedules, indices, in, out, std::make_index_sequence<1>());
+                    }
+                }
+
+                /*!
+                 * @brief Advances sizeof...(I) independent CBC streams by steps blocks, each under
+                 * its own key schedule. Chaining values stay in registers for the whole run and the
+                 * lanes overlap like in the multi-key pass.
+                 */
+                template<std::size_t Rounds, typename KeySchedule, typename Block, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_cbc_multi_key(const KeySchedule *schedules, const std::size_t *indices,
+                                                         Block *chains, const Block *const *in, Block *const *out,
+                                                         std::size_t steps, std::index_sequence<I...>) {
+                    typedef int expand[];
+
+                    const __m128i *keys[sizeof...(I)] = {
+                        reinterpret_cast<const __m128i *>(schedules[indices[I]].data())...};
+                    const __m128i *in_mm[sizeof...(I)] = {reinterpret_cast<const __m128i *>(in[I])...};
+                    __m128i *out_mm[sizeof...(I)] = {reinterpret_cast<__m128i *>(out[I])...};
+                    __m128i B[sizeof...(I)] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(chains[I].data()))...};
+
+                    for (std::size_t step = 0; step != steps; ++step) {
+                        (void)expand {0, (B[I] = _mm_xor_si128(_mm_xor_si128(B[I], _mm_loadu_si128(in_mm[I] + step)),
+                                                               _mm_loadu_si128(keys[I])),
+                                          0)...};
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], _mm_loadu_si128(keys[I] + r)), 0)...};
+                        }
+                        (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], _mm_loadu_si128(keys[I] + Rounds)), 0)...};
+                        (void)expand {0, (_mm_storeu_si128(out_mm[I] + step, B[I]), 0)...};
+                    }
+
+                    (void)expand {0, (_mm_storeu_si128(reinterpret_cast<__m128i *>(chains[I].data()), B[I]), 0)...};
+                }
+
+                template<std::size_t Rounds, typename KeySchedule, typename Block>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_cbc_multi_key(const KeySchedule *schedules, const std::size_t *indices,
+                                                         Block *chains, const Block *const *in, Block *const *out,
+                                                         std::size_t lanes, std::size_t steps) {
+                    // Streams are independent, so wider sets run as consecutive groups over all the steps
+                    for (; lanes >= rijndael_ni_parallel_blocks; lanes -= rijndael_ni_parallel_blocks) {
+                        aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                             std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        indices += rijndael_ni_parallel_blocks;
+                        chains += rijndael_ni_parallel_blocks;
+                        in += rijndael_ni_parallel_blocks;
+                        out += rijndael_ni_parallel_blocks;
+                    }
+                    switch (lanes) {
+                        case 7:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<7>());
+                        case 6:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<6>());
+                        case 5:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<5>());
+                        case 4:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<4>());
+                        case 3:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<3>());
+                        case 2:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<2>());
+                        case 1:
+                            return aes_ni_encrypt_cbc_multi_key<Rounds>(schedules, indices, chains, in, out, steps,
+                                                                        std::make_index_sequence<1>());
+                        default:
+                            return;
+                    }
+                }
+
+                /*!
+                 * @brief Reverses the byte order of a block, converting a big-endian counter block
+                 * to a little-endian 128-bit integer and back.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline __m128i aes_ni_byte_reverse(__m128i block) {
+                    return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+                }
+
+                /*!
+                 * @brief Adds one to a little-endian 128-bit counter. A low half wrapped around to
+                 * zero turns into an all-ones mask, which is shifted up and subtracted from the high
+                 * half as the carry.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline __m128i aes_ni_ctr_increment(__m128i counter) {
+                    const __m128i sum = _mm_add_epi64(counter, _mm_set_epi64x(0, 1));
+                    __m128i wrapped = _mm_cmpeq_epi32(sum, _mm_setzero_si128());
+                    wrapped = _mm_and_si128(wrapped, _mm_shuffle_epi32(wrapped, _MM_SHUFFLE(2, 3, 0, 1)));
+                    return _mm_sub_epi64(sum, _mm_slli_si128(wrapped, 8));
+                }
+
+                /*!
+                 * @brief Encrypts sizeof...(I) consecutive counter blocks and XORs them into the
+                 * input. The counter is kept little-endian in a register and advanced past the
+                 * processed blocks.
+                 */
+                template<std::size_t Rounds, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_ctr(__m128i &counter, const __m128i *in_mm, __m128i *out_mm,
+                                               const __m128i *key_mm, std::index_sequence<I...>) {
+                    typedef int expand[];
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    __m128i B[sizeof...(I)];
+                    (void)expand {0, (B[I] = _mm_xor_si128(aes_ni_byte_reverse(counter), K0),
+                                      counter = aes_ni_ctr_increment(counter), 0)...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], K), 0)...};
+                    }
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], KN), 0)...};
+
+                    (void)expand {0, (_mm_storeu_si128(out_mm + I, _mm_xor_si128(B[I], _mm_loadu_si128(in_mm + I))),
+                                      0)...};
+                }
+
+                /*!
+                 * @brief CTR keystream pass: counter blocks are generated in registers and go through
+                 * the interleaved aesenc chains without a round trip through memory.
+                 * @param counter Big-endian counter block of the first input block
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_encrypt_ctr(const uint8_t *counter, const uint8_t *in, uint8_t *out,
+                                               std::size_t blocks, const __m128i *key_mm) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    __m128i C = aes_ni_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counter)));
+
+                    for (; blocks >= rijndael_ni_parallel_blocks; blocks -= rijndael_ni_parallel_blocks) {
+                        aes_ni_encrypt_ctr<Rounds>(C, in_mm, out_mm, key_mm,
+                                                   std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        in_mm += rijndael_ni_parallel_blocks;
+                        out_mm += rijndael_ni_parallel_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_encrypt_ctr<Rounds>(C, in_mm, out_mm, key_mm, std::make_index_sequence<4>());
+                        blocks -= 4;
+                        in_mm += 4;
+                        out_mm += 4;
+                    }
+                    for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                        aes_ni_encrypt_ctr<Rounds>(C, in_mm, out_mm, key_mm, std::make_index_sequence<1>());
+                    }
+                }
+
+                /*!
+                 * @brief Multiplies an XTS tweak by the primitive element of GF(2^128). Every 32-bit lane
+                 * is shifted left by one and the bit shifted out of it moves one lane up, the one of the
+                 * top lane wrapping around as the reduction constant 0x87.
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline __m128i aes_ni_xts_double(__m128i tweak) {
+                    const __m128i carry = _mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), _MM_SHUFFLE(2, 1, 0, 3));
+                    return _mm_xor_si128(_mm_slli_epi32(tweak, 1), _mm_and_si128(carry, _mm_set_epi32(1, 1, 1, 0x87)));
+                }
+
+                /*!
+                 * @brief Processes sizeof...(I) consecutive XTS blocks. The tweaks are derived from each
+                 * other in registers while the previous group is still in the aesenc chains, and the
+                 * tweak is left advanced past the processed blocks.
+                 */
+                template<std::size_t Rounds, bool Decrypt, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_xts(__m128i &tweak, const __m128i *in_mm, __m128i *out_mm,
+                                               const __m128i *key_mm, std::index_sequence<I...>) {
+                    typedef int expand[];
+
+                    // The tweak is folded into the first and the last round keys, T holds it XORed with the latter
+                    const __m128i K0 = _mm_xor_si128(_mm_loadu_si128(key_mm), _mm_loadu_si128(key_mm + Rounds));
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    __m128i T[sizeof...(I)], B[sizeof...(I)];
+                    (void)expand {0, (T[I] = _mm_xor_si128(tweak, KN), tweak = aes_ni_xts_double(tweak), 0)...};
+                    (void)expand {0, (B[I] = _mm_xor_si128(_mm_loadu_si128(in_mm + I), _mm_xor_si128(T[I], K0)),
+                                      0)...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        (void)expand {0, (B[I] = Decrypt ? _mm_aesdec_si128(B[I], K) : _mm_aesenc_si128(B[I], K),
+                                          0)...};
+                    }
+                    (void)expand {0, (B[I] = Decrypt ? _mm_aesdeclast_si128(B[I], T[I]) :
+                                                       _mm_aesenclast_si128(B[I], T[I]),
+                                      0)...};
+
+                    (void)expand {0, (_mm_storeu_si128(out_mm + I, B[I]), 0)...};
+                }
+
+                /*!
+                 * @brief XTS pass over whole blocks of a data unit.
+                 * @param tweak Tweak of the first input block, advanced past the last one on return
+                 * @param key_mm Encryption schedule, or the decryption one if Decrypt is set
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_xts(uint8_t *tweak, const uint8_t *in, uint8_t *out, std::size_t blocks,
+                                               const __m128i *key_mm) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    __m128i T = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tweak));
+
+                    for (; blocks >= rijndael_ni_parallel_blocks; blocks -= rijndael_ni_parallel_blocks) {
+                        aes_ni_process_xts<Rounds, Decrypt>(T, in_mm, out_mm, key_mm,
+                                                            std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        in_mm += rijndael_ni_parallel_blocks;
+                        out_mm += rijndael_ni_parallel_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_process_xts<Rounds, Decrypt>(T, in_mm, out_mm, key_mm, std::make_index_sequence<4>());
+                        blocks -= 4;
+                        in_mm += 4;
+                        out_mm += 4;
+                    }
+                    for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                        aes_ni_process_xts<Rounds, Decrypt>(T, in_mm, out_mm, key_mm, std::make_index_sequence<1>());
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(tweak), T);
+                }
+
+                /*!
+                 * @brief Runs sizeof...(I) blocks through CTR and GHASH in one go. The counter is kept
+                 * byte-reflected, so incrementing its last 32 bits as GCM requires is a single add.
+                 * Ciphertext is hashed straight from the registers it was produced or loaded into,
+                 * and all the blocks share one reduction.
+                 */
+                template<std::size_t Rounds, bool Decrypt, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                inline void aes_ni_process_gcm(__m128i &counter, __m128i &hash, const __m128i *in_mm, __m128i *out_mm,
+                                               const __m128i *key_mm, const std::uint8_t (*powers)[16],
+                                               std::index_sequence<I...>) {
+                    typedef int expand[];
+                    constexpr static const std::size_t count = sizeof...(I);
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+                    __m128i B[count], C[count];
+                    (void)expand {0, (B[I] = _mm_xor_si128(ghash_clmul_byte_reverse(counter), K0),
+                                      counter = _mm_add_epi32(counter, one), 0)...};
+                    (void)expand {0, (C[I] = _mm_loadu_si128(in_mm + I), 0)...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], K), 0)...};
+                    }
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], KN), 0)...};
+
+                    if (Decrypt) {
+                        (void)expand {0, (_mm_storeu_si128(out_mm + I, _mm_xor_si128(B[I], C[I])), 0)...};
+                    } else {
+                        (void)expand {0, (C[I] = _mm_xor_si128(B[I], C[I]), _mm_storeu_si128(out_mm + I, C[I]), 0)...};
+                    }
+
+                    const __m128i *powers_mm = reinterpret_cast<const __m128i *>(powers);
+                    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                    (void)expand {0, (C[I] = ghash_clmul_byte_reverse(C[I]), 0)...};
+                    C[0] = _mm_xor_si128(C[0], hash);
+                    (void)expand {0, (ghash_clmul_accumulate(C[I], _mm_loadu_si128(powers_mm + count - I - 1), lo,
+                                                             mid, hi),
+                                      0)...};
+                    hash = ghash_clmul_reduce(lo, mid, hi);
+                }
+
+                /*!
+                 * @brief Encrypts sizeof...(I) blocks while hashing the previous group, so that the
+                 * multiplications do not wait on the rounds producing their ciphertext.
+                 * @param pending Byte-reflected ciphertext of the previous group, replaced with this one.
+                 * Only filled in when HashPending is false, for the first group.
+                 */
+                template<std::size_t Rounds, bool HashPending, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                inline void aes_ni_encrypt_gcm_deferred(__m128i &counter, __m128i &hash, const __m128i *in_mm,
+                                                        __m128i *out_mm, const __m128i *key_mm,
+                                                        const std::uint8_t (*powers)[16], __m128i *pending,
+                                                        std::index_sequence<I...>) {
+                    typedef int expand[];
+                    constexpr static const std::size_t count = sizeof...(I);
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+                    __m128i B[count];
+                    (void)expand {0, (B[I] = _mm_xor_si128(ghash_clmul_byte_reverse(counter), K0),
+                                      counter = _mm_add_epi32(counter, one), 0)...};
+
+                    const __m128i *powers_mm = reinterpret_cast<const __m128i *>(powers);
+                    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                    if (HashPending) {
+                        pending[0] = _mm_xor_si128(pending[0], hash);
+                    }
+
+                    // One multiplication of the previous group per round
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], K), 0)...};
+                        if (HashPending && r <= count) {
+                            ghash_clmul_accumulate(pending[r - 1], _mm_loadu_si128(powers_mm + count - r), lo, mid,
+                                                   hi);
+                        }
+                    }
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], KN), 0)...};
+                    if (HashPending) {
+                        hash = ghash_clmul_reduce(lo, mid, hi);
+                    }
+
+                    (void)expand {0, (B[I] = _mm_xor_si128(B[I], _mm_loadu_si128(in_mm + I)),
+                                      _mm_storeu_si128(out_mm + I, B[I]),
+                                      pending[I] = ghash_clmul_byte_reverse(B[I]), 0)...};
+                }
+
+                /*!
+                 * @brief GCM pass over whole blocks: CTR encryption or decryption with GHASH of the
+                 * ciphertext interleaved, eight blocks per reduction.
+                 * @param counter Counter block of the first input block, advanced past the last one on return
+                 * @param hash Running GHASH value, updated in place
+                 * @param powers Powers of the hash key, see ghash_clmul_schedule
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                inline void aes_ni_process_gcm(uint8_t *counter, uint8_t *hash, const uint8_t *in, uint8_t *out,
+                                               std::size_t blocks, const __m128i *key_mm,
+                                               const std::uint8_t (*powers)[16]) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    __m128i C = ghash_clmul_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counter)));
+                    __m128i Y = ghash_clmul_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)));
+
+                    // Encryption hashes each group of ciphertext while the next one is encrypted
+                    if (!Decrypt && blocks >= 2 * ghash_clmul_aggregated_blocks) {
+                        __m128i pending[ghash_clmul_aggregated_blocks];
+                        aes_ni_encrypt_gcm_deferred<Rounds, false>(
+                            C, Y, in_mm, out_mm, key_mm, powers, pending,
+                            std::make_index_sequence<ghash_clmul_aggregated_blocks>());
+                        in_mm += ghash_clmul_aggregated_blocks;
+                        out_mm += ghash_clmul_aggregated_blocks;
+                        blocks -= ghash_clmul_aggregated_blocks;
+
+                        for (; blocks >= ghash_clmul_aggregated_blocks; blocks -= ghash_clmul_aggregated_blocks) {
+                            aes_ni_encrypt_gcm_deferred<Rounds, true>(
+                                C, Y, in_mm, out_mm, key_mm, powers, pending,
+                                std::make_index_sequence<ghash_clmul_aggregated_blocks>());
+                            in_mm += ghash_clmul_aggregated_blocks;
+                            out_mm += ghash_clmul_aggregated_blocks;
+                        }
+                        Y = ghash_clmul_aggregate(powers, Y, pending, ghash_clmul_aggregated_blocks);
+                    }
+                    for (; blocks >= ghash_clmul_aggregated_blocks; blocks -= ghash_clmul_aggregated_blocks) {
+                        aes_ni_process_gcm<Rounds, Decrypt>(C, Y, in_mm, out_mm, key_mm, powers,
+                                                            std::make_index_sequence<ghash_clmul_aggregated_blocks>());
+                        in_mm += ghash_clmul_aggregated_blocks;
+                        out_mm += ghash_clmul_aggregated_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_process_gcm<Rounds, Decrypt>(C, Y, in_mm, out_mm, key_mm, powers,
+                                                            std::make_index_sequence<4>());
+                        blocks -= 4;
+                        in_mm += 4;
+                        out_mm += 4;
+                    }
+                    for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                        aes_ni_process_gcm<Rounds, Decrypt>(C, Y, in_mm, out_mm, key_mm, powers,
+                                                            std::make_index_sequence<1>());
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(counter), ghash_clmul_byte_reverse(C));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), ghash_clmul_byte_reverse(Y));
+                }
+
+                /*!
+                 * @brief Runs one CBC-MAC block and one keystream block through the rounds side by side.
+                 * The MAC chain is serial and bound by the aesenc latency, the keystream block fills
+                 * the issue slots it leaves idle.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_ccm_step(__m128i &mac, __m128i &stream, const __m128i *key_mm) {
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        mac = _mm_aesenc_si128(mac, K);
+                        stream = _mm_aesenc_si128(stream, K);
+                    }
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    mac = _mm_aesenclast_si128(mac, KN);
+                    stream = _mm_aesenclast_si128(stream, KN);
+                }
+
+                /*!
+                 * @brief CCM pass over whole blocks: CBC-MAC of the plaintext and CTR encryption or
+                 * decryption in one pass. Encryption pairs each MAC block with its own keystream block.
+                 * Decryption needs the keystream to recover the plaintext before it can be MACed, so it
+                 * runs one keystream block ahead of the chain.
+                 * @param counter Big-endian counter block of the first input block, advanced past the last one
+                 * @param mac CBC-MAC chaining value, updated in place
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_ccm(uint8_t *counter, uint8_t *mac, const uint8_t *in, uint8_t *out,
+                                               std::size_t blocks, const __m128i *key_mm) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    __m128i C = aes_ni_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counter)));
+                    __m128i M = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mac));
+
+                    if (!Decrypt) {
+                        for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                            const __m128i P = _mm_loadu_si128(in_mm);
+                            __m128i S = _mm_xor_si128(aes_ni_byte_reverse(C), K0);
+                            C = aes_ni_ctr_increment(C);
+                            M = _mm_xor_si128(M, _mm_xor_si128(P, K0));
+                            aes_ni_ccm_step<Rounds>(M, S, key_mm);
+                            _mm_storeu_si128(out_mm, _mm_xor_si128(P, S));
+                        }
+                    } else if (blocks != 0) {
+                        // The first keystream block has no MAC block to pair with, a zero block takes its place
+                        __m128i S = _mm_xor_si128(aes_ni_byte_reverse(C), K0), unused = K0;
+                        aes_ni_ccm_step<Rounds>(unused, S, key_mm);
+
+                        for (; blocks != 0; --blocks, ++in_mm, ++out_mm) {
+                            const __m128i P = _mm_xor_si128(_mm_loadu_si128(in_mm), S);
+                            _mm_storeu_si128(out_mm, P);
+                            C = aes_ni_ctr_increment(C);
+
+                            // The keystream block computed alongside the last MAC block is discarded
+                            S = _mm_xor_si128(aes_ni_byte_reverse(C), K0);
+                            M = _mm_xor_si128(M, _mm_xor_si128(P, K0));
+                            aes_ni_ccm_step<Rounds>(M, S, key_mm);
+                        }
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(counter), aes_ni_byte_reverse(C));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(mac), M);
+                }
+
+                /*!
+                 * @brief Processes sizeof...(I) OCB blocks whitened with their offsets. The offset is
+                 * folded into the first round key on the way in and into the last one on the way out,
+                 * and the plaintext is added to the checksum while it is in registers.
+                 */
+                template<std::size_t Rounds, bool Decrypt, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_ocb(const __m128i *offsets_mm, __m128i &checksum, const __m128i *in_mm,
+                                               __m128i *out_mm, const __m128i *key_mm, std::index_sequence<I...>) {
+                    typedef int expand[];
+                    constexpr static const std::size_t count = sizeof...(I);
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    __m128i O[count], B[count];
+                    (void)expand {0, (O[I] = _mm_loadu_si128(offsets_mm + I), B[I] = _mm_loadu_si128(in_mm + I), 0)...};
+                    if (!Decrypt) {
+                        (void)expand {0, (checksum = _mm_xor_si128(checksum, B[I]), 0)...};
+                    }
+                    (void)expand {0, (B[I] = _mm_xor_si128(B[I], _mm_xor_si128(O[I], K0)), 0)...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        if (Decrypt) {
+                            (void)expand {0, (B[I] = _mm_aesdec_si128(B[I], K), 0)...};
+                        } else {
+                            (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], K), 0)...};
+                        }
+                    }
+                    if (Decrypt) {
+                        (void)expand {0, (B[I] = _mm_aesdeclast_si128(B[I], _mm_xor_si128(O[I], KN)),
+                                          checksum = _mm_xor_si128(checksum, B[I]), 0)...};
+                    } else {
+                        (void)expand {0, (B[I] = _mm_aesenclast_si128(B[I], _mm_xor_si128(O[I], KN)), 0)...};
+                    }
+                    (void)expand {0, (_mm_storeu_si128(out_mm + I, B[I]), 0)...};
+                }
+
+                /*!
+                 * @brief OCB pass over whole blocks with their offsets given: out = E(in ^ offset) ^ offset,
+                 * or the same with the inverse cipher, plaintext added to the checksum.
+                 * @param checksum Running checksum, updated in place
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_ocb(const uint8_t *offsets, uint8_t *checksum, const uint8_t *in,
+                                               uint8_t *out, std::size_t blocks, const __m128i *key_mm) {
+                    const __m128i *offsets_mm = reinterpret_cast<const __m128i *>(offsets);
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    __m128i S = _mm_loadu_si128(reinterpret_cast<const __m128i *>(checksum));
+
+                    for (; blocks >= rijndael_ni_parallel_blocks; blocks -= rijndael_ni_parallel_blocks) {
+                        aes_ni_process_ocb<Rounds, Decrypt>(offsets_mm, S, in_mm, out_mm, key_mm,
+                                                            std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        offsets_mm += rijndael_ni_parallel_blocks;
+                        in_mm += rijndael_ni_parallel_blocks;
+                        out_mm += rijndael_ni_parallel_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_process_ocb<Rounds, Decrypt>(offsets_mm, S, in_mm, out_mm, key_mm,
+                                                            std::make_index_sequence<4>());
+                        blocks -= 4;
+                        offsets_mm += 4;
+                        in_mm += 4;
+                        out_mm += 4;
+                    }
+                    for (; blocks != 0; --blocks, ++offsets_mm, ++in_mm, ++out_mm) {
+                        aes_ni_process_ocb<Rounds, Decrypt>(offsets_mm, S, in_mm, out_mm, key_mm,
+                                                            std::make_index_sequence<1>());
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(checksum), S);
+                }
+
+                /*!
+                 * @brief Enciphers sizeof...(I) PMAC blocks whitened with their offsets and adds the
+                 * results to the sum. The offset is folded into the first round key and nothing is stored.
+                 */
+                template<std::size_t Rounds, std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_pmac(const __m128i *offsets_mm, __m128i &sum, const __m128i *in_mm,
+                                                const __m128i *key_mm, std::index_sequence<I...>) {
+                    typedef int expand[];
+                    constexpr static const std::size_t count = sizeof...(I);
+
+                    const __m128i K0 = _mm_loadu_si128(key_mm);
+                    __m128i B[count];
+                    (void)expand {0, (B[I] = _mm_xor_si128(_mm_loadu_si128(in_mm + I),
+                                                           _mm_xor_si128(_mm_loadu_si128(offsets_mm + I), K0)),
+                                      0)...};
+
+                    for (std::size_t r = 1; r != Rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(key_mm + r);
+                        (void)expand {0, (B[I] = _mm_aesenc_si128(B[I], K), 0)...};
+                    }
+                    const __m128i KN = _mm_loadu_si128(key_mm + Rounds);
+                    (void)expand {0, (sum = _mm_xor_si128(sum, _mm_aesenclast_si128(B[I], KN)), 0)...};
+                }
+
+                /*!
+                 * @brief PMAC pass over whole blocks with their offsets given: sum ^= E(in ^ offset).
+                 * @param sum Running sum, updated in place
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                inline void aes_ni_process_pmac(const uint8_t *offsets, uint8_t *sum, const uint8_t *in,
+                                                std::size_t blocks, const __m128i *key_mm) {
+                    const __m128i *offsets_mm = reinterpret_cast<const __m128i *>(offsets);
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+
+                    __m128i S = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum));
+
+                    for (; blocks >= rijndael_ni_parallel_blocks; blocks -= rijndael_ni_parallel_blocks) {
+                        aes_ni_process_pmac<Rounds>(offsets_mm, S, in_mm, key_mm,
+                                                    std::make_index_sequence<rijndael_ni_parallel_blocks>());
+                        offsets_mm += rijndael_ni_parallel_blocks;
+                        in_mm += rijndael_ni_parallel_blocks;
+                    }
+                    if (blocks >= 4) {
+                        aes_ni_process_pmac<Rounds>(offsets_mm, S, in_mm, key_mm, std::make_index_sequence<4>());
+                        blocks -= 4;
+                        offsets_mm += 4;
+                        in_mm += 4;
+                    }
+                    for (; blocks != 0; --blocks, ++offsets_mm, ++in_mm) {
+                        aes_ni_process_pmac<Rounds>(offsets_mm, S, in_mm, key_mm, std::make_index_sequence<1>());
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(sum), S);
                 }
 
                 template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
@@ -188,52 +1051,191 @@ namespace nil {
                     }
 
                     BOOST_ATTRIBUTE_TARGET("ssse3,aes")
-                    static void schedule_key(const key_type &input_key,
-                                             key_schedule_type &encryption_key,
-                                             key_schedule_type &decryption_key) {
-#define AES_128_KEY_EXPANSION(K, RCON) detail::aes_128_key_expansion(K, _mm_aeskeygenassist_si128(K, RCON))
-
-                        const __m128i K0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input_key.data()));
-                        const __m128i K1 = AES_128_KEY_EXPANSION(K0, 0x01);
-                        const __m128i K2 = AES_128_KEY_EXPANSION(K1, 0x02);
-                        const __m128i K3 = AES_128_KEY_EXPANSION(K2, 0x04);
-                        const __m128i K4 = AES_128_KEY_EXPANSION(K3, 0x08);
-                        const __m128i K5 = AES_128_KEY_EXPANSION(K4, 0x10);
-                        const __m128i K6 = AES_128_KEY_EXPANSION(K5, 0x20);
-                        const __m128i K7 = AES_128_KEY_EXPANSION(K6, 0x40);
-                        const __m128i K8 = AES_128_KEY_EXPANSION(K7, 0x80);
-                        const __m128i K9 = AES_128_KEY_EXPANSION(K8, 0x1B);
-                        const __m128i K10 = AES_128_KEY_EXPANSION(K9, 0x36);
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_blocks<10, false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_blocks<10, true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                  const block_type *in, block_type *out, std::size_t blocks) {
+                        detail::aes_ni_encrypt_multi_key<10>(schedules, indices,
+                                                              reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_cbc_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                      block_type *chains, const block_type *const *in,
+                                                      block_type *const *out, std::size_t lanes, std::size_t steps) {
+                        detail::aes_ni_encrypt_cbc_multi_key<10>(schedules, indices, chains, in, out, lanes, steps);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ctr(const block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_encrypt_ctr<10>(counter.data(), reinterpret_cast<const uint8_t *>(in),
+                                                        reinterpret_cast<uint8_t *>(out), blocks,
+                                                        reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_xts<10, false>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks,
+                                                              reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_xts<10, true>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                             reinterpret_cast<uint8_t *>(out), blocks,
+                                                             reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void encrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<10, false>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void decrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<10, true>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<10, false>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<10, true>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<10, false>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<10, true>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_pmac(const block_type *offsets, const block_type *in, std::size_t blocks,
+                                             const key_schedule_type &encryption_key, block_type &sum) {
+                        detail::aes_ni_process_pmac<10>(reinterpret_cast<const uint8_t *>(offsets), sum.data(),
+                                                       reinterpret_cast<const uint8_t *>(in), blocks,
+                                                       reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations,
+                                                       const key_schedule_type &encryption_key) {
+                        block_type out;
+                        detail::aes_ni_encrypt_iterated<10>(
+                            plaintext.data(), out.data(), iterations,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), std::make_index_sequence<9>());
+                        return out;
+                    }
+
+                    template<std::size_t... L>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void expand_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                            std::index_sequence<L...>) {
+                        typedef int expand[];
+
+                        __m128i *EK_mm[] = {reinterpret_cast<__m128i *>(encryption_keys[L].data())...};
+                        __m128i K[] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys[L].data()))...};
+                        (void)expand {0, (_mm_storeu_si128(EK_mm[L], K[L]), 0)...};
+
+#define AES_128_KEY_EXPANSION(R, RCON)                                                                                \
+    (void)expand {0, (K[L] = detail::aes_128_key_expansion(                                                           \
+                          K[L], detail::aes_ni_sub_word(K[L], detail::aes_ni_rot_word3, RCON)),                       \
+                      _mm_storeu_si128(EK_mm[L] + R, K[L]), 0)...}
+
+                        AES_128_KEY_EXPANSION(1, 0x01);
+                        AES_128_KEY_EXPANSION(2, 0x02);
+                        AES_128_KEY_EXPANSION(3, 0x04);
+                        AES_128_KEY_EXPANSION(4, 0x08);
+                        AES_128_KEY_EXPANSION(5, 0x10);
+                        AES_128_KEY_EXPANSION(6, 0x20);
+                        AES_128_KEY_EXPANSION(7, 0x40);
+                        AES_128_KEY_EXPANSION(8, 0x80);
+                        AES_128_KEY_EXPANSION(9, 0x1B);
+                        AES_128_KEY_EXPANSION(10, 0x36);
 
 #undef AES_128_KEY_EXPANSION
+                    }
+
+                    /*!
+                     * @brief Expands a batch of keys. Decryption schedules are skipped if decryption_keys is null.
+                     */
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void schedule_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                              key_schedule_type *decryption_keys, std::size_t count) {
+                        std::size_t i = 0;
+                        for (; i + detail::rijndael_ni_key_lanes <= count; i += detail::rijndael_ni_key_lanes) {
+                            expand_keys(keys + i, encryption_keys + i,
+                                        std::make_index_sequence<detail::rijndael_ni_key_lanes>());
+                        }
+                        for (; i != count; ++i) {
+                            expand_keys(keys + i, encryption_keys + i, std::make_index_sequence<1>());
+                        }
 
-                        __m128i *EK_mm = reinterpret_cast<__m128i *>(encryption_key.data());
-                        _mm_storeu_si128(EK_mm, K0);
-                        _mm_storeu_si128(EK_mm + 1, K1);
-                        _mm_storeu_si128(EK_mm + 2, K2);
-                        _mm_storeu_si128(EK_mm + 3, K3);
-                        _mm_storeu_si128(EK_mm + 4, K4);
-                        _mm_storeu_si128(EK_mm + 5, K5);
-                        _mm_storeu_si128(EK_mm + 6, K6);
-                        _mm_storeu_si128(EK_mm + 7, K7);
-                        _mm_storeu_si128(EK_mm + 8, K8);
-                        _mm_storeu_si128(EK_mm + 9, K9);
-                        _mm_storeu_si128(EK_mm + 10, K10);
-
-                        // Now generate decryption keys
-
-                        __m128i *DK_mm = reinterpret_cast<__m128i *>(decryption_key.data());
-                        _mm_storeu_si128(DK_mm, K10);
-                        _mm_storeu_si128(DK_mm + 1, _mm_aesimc_si128(K9));
-                        _mm_storeu_si128(DK_mm + 2, _mm_aesimc_si128(K8));
-                        _mm_storeu_si128(DK_mm + 3, _mm_aesimc_si128(K7));
-                        _mm_storeu_si128(DK_mm + 4, _mm_aesimc_si128(K6));
-                        _mm_storeu_si128(DK_mm + 5, _mm_aesimc_si128(K5));
-                        _mm_storeu_si128(DK_mm + 6, _mm_aesimc_si128(K4));
-                        _mm_storeu_si128(DK_mm + 7, _mm_aesimc_si128(K3));
-                        _mm_storeu_si128(DK_mm + 8, _mm_aesimc_si128(K2));
-                        _mm_storeu_si128(DK_mm + 9, _mm_aesimc_si128(K1));
-                        _mm_storeu_si128(DK_mm + 10, K0);
+                        if (decryption_keys) {
+                            detail::aes_ni_inverse_key_schedules<10>(encryption_keys, decryption_keys, count);
+                        }
+                    }
+
+                    static void schedule_key(const key_type &input_key,
+                                             key_schedule_type &encryption_key,
+                                             key_schedule_type &decryption_key) {
+                        schedule_keys(&input_key, &encryption_key, &decryption_key, 1);
                     }
                 };
 
@@ -338,47 +1340,156 @@ namespace nil {
                         return out;
                     }
 
-                    /**
-                     * Load a variable number of little-endian words
-                     * @param out the output array of words
-                     * @param in the input array of bytes
-                     * @param count how many words are in in
-                     */
-                    template<typename T>
-                    static inline void load_le(T out[], const uint8_t in[], size_t count) {
-                        if (count > 0) {
-#if defined(BOOST_ENDIAN_LITTLE_BYTE_AVAILABLE)
-                            std::memcpy(out, in, sizeof(T) * count);
-#elif defined(BOOST_ENDIAN_BIG_BYTE_AVAILABLE)
-                            std::memcpy(out, in, sizeof(T) * count);
-                            const size_t blocks = count - (count % 4);
-                            const size_t left = count - blocks;
-
-                            for (size_t i = 0; i != blocks; i += 4)
-                                bswap_4(out + i);
-
-                            for (size_t i = 0; i != left; ++i)
-                                out[blocks + i] = boost::endian::endian_reverse(out[blocks + i]);
-#else
-                            for (size_t i = 0; i != count; ++i) {
-                                out[i] = load_le<T>(in, i);
-                            }
-#endif
-                        }
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_blocks<12, false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
                     }
 
                     BOOST_ATTRIBUTE_TARGET("ssse3,aes")
-                    static void schedule_key(const key_type &input_key,
-                                             key_schedule_type &encryption_key,
-                                             key_schedule_type &decryption_key) {
-                        __m128i K0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input_key.data()));
-                        __m128i K1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input_key.data() + 8));
-                        K1 = _mm_srli_si128(K1, 8);
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_blocks<12, true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
 
-                        load_le(encryption_key.data(), input_key.data(), 6);
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                  const block_type *in, block_type *out, std::size_t blocks) {
+                        detail::aes_ni_encrypt_multi_key<12>(schedules, indices,
+                                                              reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks);
+                    }
 
-#define AES_192_KEY_EXPANSION(RCON, EK_OFF) \
-    detail::aes_192_key_expansion(&K0, &K1, _mm_aeskeygenassist_si128(K1, RCON), &encryption_key[EK_OFF], EK_OFF == 48)
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_cbc_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                      block_type *chains, const block_type *const *in,
+                                                      block_type *const *out, std::size_t lanes, std::size_t steps) {
+                        detail::aes_ni_encrypt_cbc_multi_key<12>(schedules, indices, chains, in, out, lanes, steps);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ctr(const block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_encrypt_ctr<12>(counter.data(), reinterpret_cast<const uint8_t *>(in),
+                                                        reinterpret_cast<uint8_t *>(out), blocks,
+                                                        reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_xts<12, false>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks,
+                                                              reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_xts<12, true>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                             reinterpret_cast<uint8_t *>(out), blocks,
+                                                             reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void encrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<12, false>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void decrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<12, true>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<12, false>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<12, true>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<12, false>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<12, true>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_pmac(const block_type *offsets, const block_type *in, std::size_t blocks,
+                                             const key_schedule_type &encryption_key, block_type &sum) {
+                        detail::aes_ni_process_pmac<12>(reinterpret_cast<const uint8_t *>(offsets), sum.data(),
+                                                       reinterpret_cast<const uint8_t *>(in), blocks,
+                                                       reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations,
+                                                       const key_schedule_type &encryption_key) {
+                        block_type out;
+                        detail::aes_ni_encrypt_iterated<12>(
+                            plaintext.data(), out.data(), iterations,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), std::make_index_sequence<11>());
+                        return out;
+                    }
+
+                    template<std::size_t... L>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void expand_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                            std::index_sequence<L...>) {
+                        typedef int expand[];
+
+                        __m128i K0[] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys[L].data()))...};
+                        __m128i K1[] = {_mm_loadl_epi64(reinterpret_cast<const __m128i *>(keys[L].data() + 16))...};
+                        __m128i *EK_mm[] = {reinterpret_cast<__m128i *>(encryption_keys[L].data())...};
+                        (void)expand {
+                            0, (_mm_storeu_si128(EK_mm[L], K0[L]), _mm_storel_epi64(EK_mm[L] + 1, K1[L]), 0)...};
+
+#define AES_192_KEY_EXPANSION(RCON, EK_OFF)                                                                           \
+    (void)expand {0, (detail::aes_192_key_expansion(&K0[L], &K1[L],                                                   \
+                                                    detail::aes_ni_sub_word(K1[L], detail::aes_ni_rot_word1, RCON),   \
+                                                    &encryption_keys[L][EK_OFF], EK_OFF == 48),                       \
+                      0)...}
 
                         AES_192_KEY_EXPANSION(0x01, 6);
                         AES_192_KEY_EXPANSION(0x02, 12);
@@ -390,24 +1501,32 @@ namespace nil {
                         AES_192_KEY_EXPANSION(0x80, 48);
 
 #undef AES_192_KEY_EXPANSION
+                    }
+
+                    /*!
+                     * @brief Expands a batch of keys. Decryption schedules are skipped if decryption_keys is null.
+                     */
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void schedule_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                              key_schedule_type *decryption_keys, std::size_t count) {
+                        std::size_t i = 0;
+                        for (; i + detail::rijndael_ni_key_lanes <= count; i += detail::rijndael_ni_key_lanes) {
+                            expand_keys(keys + i, encryption_keys + i,
+                                        std::make_index_sequence<detail::rijndael_ni_key_lanes>());
+                        }
+                        for (; i != count; ++i) {
+                            expand_keys(keys + i, encryption_keys + i, std::make_index_sequence<1>());
+                        }
 
-                        // Now generate decryption keys
-                        const __m128i *EK_mm = reinterpret_cast<const __m128i *>(encryption_key.data());
-
-                        __m128i *DK_mm = reinterpret_cast<__m128i *>(decryption_key.data());
-                        _mm_storeu_si128(DK_mm, _mm_loadu_si128(EK_mm + 12));
-                        _mm_storeu_si128(DK_mm + 1, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 11)));
-                        _mm_storeu_si128(DK_mm + 2, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 10)));
-                        _mm_storeu_si128(DK_mm + 3, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 9)));
-                        _mm_storeu_si128(DK_mm + 4, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 8)));
-                        _mm_storeu_si128(DK_mm + 5, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 7)));
-                        _mm_storeu_si128(DK_mm + 6, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 6)));
-                        _mm_storeu_si128(DK_mm + 7, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 5)));
-                        _mm_storeu_si128(DK_mm + 8, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 4)));
-                        _mm_storeu_si128(DK_mm + 9, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 3)));
-                        _mm_storeu_si128(DK_mm + 10, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 2)));
-                        _mm_storeu_si128(DK_mm + 11, _mm_aesimc_si128(_mm_loadu_si128(EK_mm + 1)));
-                        _mm_storeu_si128(DK_mm + 12, _mm_loadu_si128(EK_mm + 0));
+                        if (decryption_keys) {
+                            detail::aes_ni_inverse_key_schedules<12>(encryption_keys, decryption_keys, count);
+                        }
+                    }
+
+                    static void schedule_key(const key_type &input_key,
+                                             key_schedule_type &encryption_key,
+                                             key_schedule_type &decryption_key) {
+                        schedule_keys(&input_key, &encryption_key, &decryption_key, 1);
                     }
                 };
 
@@ -521,66 +1640,198 @@ namespace nil {
                     }
 
                     BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_blocks<14, false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_blocks<14, true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                  const block_type *in, block_type *out, std::size_t blocks) {
+                        detail::aes_ni_encrypt_multi_key<14>(schedules, indices,
+                                                              reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_cbc_multi_key(const key_schedule_type *schedules, const std::size_t *indices,
+                                                      block_type *chains, const block_type *const *in,
+                                                      block_type *const *out, std::size_t lanes, std::size_t steps) {
+                        detail::aes_ni_encrypt_cbc_multi_key<14>(schedules, indices, chains, in, out, lanes, steps);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ctr(const block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_encrypt_ctr<14>(counter.data(), reinterpret_cast<const uint8_t *>(in),
+                                                        reinterpret_cast<uint8_t *>(out), blocks,
+                                                        reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_ni_process_xts<14, false>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                              reinterpret_cast<uint8_t *>(out), blocks,
+                                                              reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key) {
+                        detail::aes_ni_process_xts<14, true>(tweak.data(), reinterpret_cast<const uint8_t *>(in),
+                                                             reinterpret_cast<uint8_t *>(out), blocks,
+                                                             reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void encrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<14, false>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes,pclmul")
+                    static void decrypt_gcm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            const ghash_key &key, block_type &hash) {
+                        detail::aes_ni_process_gcm<14, true>(
+                            counter.data(), hash.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), key.powers);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<14, false>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ccm(block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &mac) {
+                        detail::aes_ni_process_ccm<14, true>(
+                            counter.data(), mac.data(), reinterpret_cast<const uint8_t *>(in),
+                            reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<14, false>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key,
+                                            block_type &checksum) {
+                        detail::aes_ni_process_ocb<14, true>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_pmac(const block_type *offsets, const block_type *in, std::size_t blocks,
+                                             const key_schedule_type &encryption_key, block_type &sum) {
+                        detail::aes_ni_process_pmac<14>(reinterpret_cast<const uint8_t *>(offsets), sum.data(),
+                                                       reinterpret_cast<const uint8_t *>(in), blocks,
+                                                       reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations,
+                                                       const key_schedule_type &encryption_key) {
+                        block_type out;
+                        detail::aes_ni_encrypt_iterated<14>(
+                            plaintext.data(), out.data(), iterations,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), std::make_index_sequence<13>());
+                        return out;
+                    }
+
+                    template<std::size_t... L>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void expand_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                            std::index_sequence<L...>) {
+                        typedef int expand[];
+
+                        __m128i *EK_mm[] = {reinterpret_cast<__m128i *>(encryption_keys[L].data())...};
+                        __m128i K0[] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys[L].data()))...};
+                        __m128i K1[] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys[L].data() + 16))...};
+                        (void)expand {
+                            0, (_mm_storeu_si128(EK_mm[L], K0[L]), _mm_storeu_si128(EK_mm[L] + 1, K1[L]), 0)...};
+
+                        /*
+                         * Even round keys come from the AES-128 step on the previous odd one, odd round keys
+                         * from the SubWord-only step on the new even one
+                         */
+#define AES_256_KEY_EXPANSION(R, RCON)                                                                                \
+    (void)expand {0, (K0[L] = detail::aes_128_key_expansion(                                                          \
+                          K0[L], detail::aes_ni_sub_word(K1[L], detail::aes_ni_rot_word3, RCON)),                     \
+                      _mm_storeu_si128(EK_mm[L] + R, K0[L]), 0)...};                                                  \
+    if (R != 14) {                                                                                                    \
+        (void)expand {0, (K1[L] = detail::aes_256_key_expansion(K1[L], K0[L]),                                        \
+                          _mm_storeu_si128(EK_mm[L] + R + 1, K1[L]), 0)...};                                          \
+    }
+
+                        AES_256_KEY_EXPANSION(2, 0x01);
+                        AES_256_KEY_EXPANSION(4, 0x02);
+                        AES_256_KEY_EXPANSION(6, 0x04);
+                        AES_256_KEY_EXPANSION(8, 0x08);
+                        AES_256_KEY_EXPANSION(10, 0x10);
+                        AES_256_KEY_EXPANSION(12, 0x20);
+                        AES_256_KEY_EXPANSION(14, 0x40);
+
+#undef AES_256_KEY_EXPANSION
+                    }
+
+                    /*!
+                     * @brief Expands a batch of keys. Decryption schedules are skipped if decryption_keys is null.
+                     */
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void schedule_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                              key_schedule_type *decryption_keys, std::size_t count) {
+                        std::size_t i = 0;
+                        for (; i + detail::rijndael_ni_key_lanes <= count; i += detail::rijndael_ni_key_lanes) {
+                            expand_keys(keys + i, encryption_keys + i,
+                                        std::make_index_sequence<detail::rijndael_ni_key_lanes>());
+                        }
+                        for (; i != count; ++i) {
+                            expand_keys(keys + i, encryption_keys + i, std::make_index_sequence<1>());
+                        }
+
+                        if (decryption_keys) {
+                            detail::aes_ni_inverse_key_schedules<14>(encryption_keys, decryption_keys, count);
+                        }
+                    }
+
                     static void schedule_key(const key_type &input_key,
                                              key_schedule_type &encryption_key,
                                              key_schedule_type &decryption_key) {
-                        const __m128i K0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input_key.data()));
-                        const __m128i K1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input_key.data() + 16));
-
-                        const __m128i K2 = detail::aes_128_key_expansion(K0, _mm_aeskeygenassist_si128(K1, 0x01));
-                        const __m128i K3 = detail::aes_256_key_expansion(K1, K2);
-
-                        const __m128i K4 = detail::aes_128_key_expansion(K2, _mm_aeskeygenassist_si128(K3, 0x02));
-                        const __m128i K5 = detail::aes_256_key_expansion(K3, K4);
-
-                        const __m128i K6 = detail::aes_128_key_expansion(K4, _mm_aeskeygenassist_si128(K5, 0x04));
-                        const __m128i K7 = detail::aes_256_key_expansion(K5, K6);
-
-                        const __m128i K8 = detail::aes_128_key_expansion(K6, _mm_aeskeygenassist_si128(K7, 0x08));
-                        const __m128i K9 = detail::aes_256_key_expansion(K7, K8);
-
-                        const __m128i K10 = detail::aes_128_key_expansion(K8, _mm_aeskeygenassist_si128(K9, 0x10));
-                        const __m128i K11 = detail::aes_256_key_expansion(K9, K10);
-
-                        const __m128i K12 = detail::aes_128_key_expansion(K10, _mm_aeskeygenassist_si128(K11, 0x20));
-                        const __m128i K13 = detail::aes_256_key_expansion(K11, K12);
-
-                        const __m128i K14 = detail::aes_128_key_expansion(K12, _mm_aeskeygenassist_si128(K13, 0x40));
-
-                        __m128i *EK_mm = reinterpret_cast<__m128i *>(encryption_key.data());
-                        _mm_storeu_si128(EK_mm, K0);
-                        _mm_storeu_si128(EK_mm + 1, K1);
-                        _mm_storeu_si128(EK_mm + 2, K2);
-                        _mm_storeu_si128(EK_mm + 3, K3);
-                        _mm_storeu_si128(EK_mm + 4, K4);
-                        _mm_storeu_si128(EK_mm + 5, K5);
-                        _mm_storeu_si128(EK_mm + 6, K6);
-                        _mm_storeu_si128(EK_mm + 7, K7);
-                        _mm_storeu_si128(EK_mm + 8, K8);
-                        _mm_storeu_si128(EK_mm + 9, K9);
-                        _mm_storeu_si128(EK_mm + 10, K10);
-                        _mm_storeu_si128(EK_mm + 11, K11);
-                        _mm_storeu_si128(EK_mm + 12, K12);
-                        _mm_storeu_si128(EK_mm + 13, K13);
-                        _mm_storeu_si128(EK_mm + 14, K14);
-
-                        // Now generate decryption keys
-                        __m128i *DK_mm = reinterpret_cast<__m128i *>(decryption_key.data());
-                        _mm_storeu_si128(DK_mm, K14);
-                        _mm_storeu_si128(DK_mm + 1, _mm_aesimc_si128(K13));
-                        _mm_storeu_si128(DK_mm + 2, _mm_aesimc_si128(K12));
-                        _mm_storeu_si128(DK_mm + 3, _mm_aesimc_si128(K11));
-                        _mm_storeu_si128(DK_mm + 4, _mm_aesimc_si128(K10));
-                        _mm_storeu_si128(DK_mm + 5, _mm_aesimc_si128(K9));
-                        _mm_storeu_si128(DK_mm + 6, _mm_aesimc_si128(K8));
-                        _mm_storeu_si128(DK_mm + 7, _mm_aesimc_si128(K7));
-                        _mm_storeu_si128(DK_mm + 8, _mm_aesimc_si128(K6));
-                        _mm_storeu_si128(DK_mm + 9, _mm_aesimc_si128(K5));
-                        _mm_storeu_si128(DK_mm + 10, _mm_aesimc_si128(K4));
-                        _mm_storeu_si128(DK_mm + 11, _mm_aesimc_si128(K3));
-                        _mm_storeu_si128(DK_mm + 12, _mm_aesimc_si128(K2));
-                        _mm_storeu_si128(DK_mm + 13, _mm_aesimc_si128(K1));
-                        _mm_storeu_si128(DK_mm + 14, K0);
+                        schedule_keys(&input_key, &encryption_key, &decryption_key, 1);
                     }
                 };
             }    // namespace detail
@@ -0,0 +1,299 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file Rijndael with AES-NI for any block and key size
+//
+// @brief aesenc/aesdec operate on a single 128-bit, four column state. A wider
+// Rijndael state is kept in two registers holding columns 0-3 and 4-7. Before
+// every round both halves are rearranged with pshufb so that the ShiftRows built
+// into the instruction yields the ShiftRows of the wide cipher. SubBytes and
+// MixColumns work on each byte and column independently, so they are unaffected.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_RIJNDAEL_NI_WIDE_IMPL_HPP
+#define CRYPTO3_RIJNDAEL_NI_WIDE_IMPL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include <boost/static_assert.hpp>
+
+#include <nil/crypto3/detail/config.hpp>
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_impl.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                /*!
+                 * @brief pshufb masks mapping a wide Rijndael state onto two AES halves.
+                 *
+                 * For the encryption the halves hold InvShiftRows_AES(ShiftRows_Nb(state)), so that
+                 * aesenc applying ShiftRows_AES to each half produces ShiftRows_Nb(state). Decryption
+                 * mirrors this with ShiftRows_AES(InvShiftRows_Nb(state)). Columns past the block width
+                 * are zeroed and never feed the real ones.
+                 */
+                template<typename PolicyType>
+                struct rijndael_ni_wide_shuffle {
+                    constexpr static const std::size_t block_words = PolicyType::block_words;
+                    constexpr static const std::size_t masks_size = 2 * 2 * 2 * 16;
+                    typedef std::array<std::uint8_t, masks_size> masks_type;
+
+                    constexpr static std::size_t shift(std::size_t row) {
+                        return row == 0 ? 0 : PolicyType::shift_offsets[row - 1];
+                    }
+
+                    /*
+                     * Source column for the byte at column (4 * half + column) and the given row,
+                     * block_words when the destination is padding
+                     */
+                    constexpr static std::size_t source_column(bool decrypt, std::size_t half, std::size_t column,
+                                                               std::size_t row) {
+                        return 4 * half + (decrypt ? (column + row) % 4 : (column + 4 - row) % 4) >= block_words ?
+                                   block_words :
+                               decrypt ? (4 * half + (column + row) % 4 + block_words - shift(row)) % block_words :
+                                         (4 * half + (column + 4 - row) % 4 + shift(row)) % block_words;
+                    }
+
+                    constexpr static std::uint8_t mask_byte(bool decrypt, std::size_t half, std::size_t source_half,
+                                                           std::size_t column, std::size_t row) {
+                        return source_column(decrypt, half, column, row) / 4 == source_half ?
+                                   static_cast<std::uint8_t>(4 * (source_column(decrypt, half, column, row) % 4) +
+                                                             row) :
+                                   0x80;
+                    }
+
+                    /*
+                     * Index bits from the top: direction, destination half, source half, byte
+                     */
+                    constexpr static std::uint8_t mask_byte(std::size_t i) {
+                        return mask_byte(i / 64, i / 32 % 2, i / 16 % 2, i % 16 / 4, i % 4);
+                    }
+
+                    template<std::size_t... I>
+                    constexpr static masks_type make_masks(std::index_sequence<I...>) {
+                        return {{mask_byte(I)...}};
+                    }
+
+                    BOOST_ALIGNMENT(16) constexpr static const masks_type masks =
+                        make_masks(std::make_index_sequence<masks_size>());
+                };
+
+                template<typename PolicyType>
+                BOOST_ALIGNMENT(16) constexpr typename rijndael_ni_wide_shuffle<PolicyType>::masks_type const
+                    rijndael_ni_wide_shuffle<PolicyType>::masks;
+
+                /*!
+                 * @brief AES-NI Rijndael for the block and key sizes which are not AES. Key
+                 * schedule is shared with the portable implementation, its word layout matches
+                 * the byte order aesenc/aesdec expect.
+                 */
+                template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
+                class rijndael_ni_wide_impl {
+                    typedef PolicyType policy_type;
+                    typedef typename policy_type::block_type block_type;
+                    typedef typename policy_type::key_type key_type;
+                    typedef typename policy_type::key_schedule_type key_schedule_type;
+
+                    typedef rijndael_impl<KeyBitsImpl, BlockBitsImpl, PolicyType> key_schedule_impl_type;
+                    typedef rijndael_ni_wide_shuffle<PolicyType> shuffle_type;
+
+                    BOOST_STATIC_ASSERT(KeyBitsImpl == PolicyType::key_bits);
+                    BOOST_STATIC_ASSERT(BlockBitsImpl == PolicyType::block_bits);
+
+                    constexpr static const std::size_t block_words = policy_type::block_words;
+                    constexpr static const std::size_t rounds = policy_type::rounds;
+
+                    // With four columns the shuffle is the identity and the upper half is unused
+                    constexpr static const bool is_wide = block_words > 4;
+                    constexpr static const std::size_t halves = is_wide ? 2 : 1;
+
+                    constexpr static const std::size_t parallel_blocks = 4;
+
+                    typedef __m128i round_keys_type[halves * (rounds + 1)];
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void load_round_keys(const key_schedule_type &key, round_keys_type &round_keys) {
+                        for (std::size_t r = 0; r != rounds + 1; ++r) {
+                            const std::uint32_t *words = key.data() + r * block_words;
+                            round_keys[halves * r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+                            if (is_wide) {
+                                BOOST_ALIGNMENT(16) std::uint32_t upper[4] = {0};
+                                std::memcpy(upper, words + 4, (block_words - 4) * sizeof(std::uint32_t));
+                                round_keys[halves * r + 1] = _mm_load_si128(reinterpret_cast<const __m128i *>(upper));
+                            }
+                        }
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void load_block(const block_type &block, __m128i &low, __m128i &high) {
+                        low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data()));
+                        high = _mm_setzero_si128();
+                        if (is_wide) {
+                            BOOST_ALIGNMENT(16) std::uint8_t upper[16] = {0};
+                            std::memcpy(upper, block.data() + 16, block.size() - 16);
+                            high = _mm_load_si128(reinterpret_cast<const __m128i *>(upper));
+                        }
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void store_block(__m128i low, __m128i high, block_type &block) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(block.data()), low);
+                        if (is_wide) {
+                            BOOST_ALIGNMENT(16) std::uint8_t upper[16];
+                            _mm_store_si128(reinterpret_cast<__m128i *>(upper), high);
+                            std::memcpy(block.data() + 16, upper, block.size() - 16);
+                        }
+                    }
+
+                    template<bool Last, bool Decrypt>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void round(__m128i &low, __m128i &high, const __m128i *masks, const __m128i *key) {
+                        __m128i l = low, h = high;
+                        if (is_wide) {
+                            l = _mm_or_si128(_mm_shuffle_epi8(low, masks[0]), _mm_shuffle_epi8(high, masks[1]));
+                            h = _mm_or_si128(_mm_shuffle_epi8(low, masks[2]), _mm_shuffle_epi8(high, masks[3]));
+                        }
+
+                        if (Last) {
+                            low = Decrypt ? _mm_aesdeclast_si128(l, key[0]) : _mm_aesenclast_si128(l, key[0]);
+                            if (is_wide) {
+                                high = Decrypt ? _mm_aesdeclast_si128(h, key[1]) : _mm_aesenclast_si128(h, key[1]);
+                            }
+                        } else {
+                            low = Decrypt ? _mm_aesdec_si128(l, key[0]) : _mm_aesenc_si128(l, key[0]);
+                            if (is_wide) {
+                                high = Decrypt ? _mm_aesdec_si128(h, key[1]) : _mm_aesenc_si128(h, key[1]);
+                            }
+                        }
+                    }
+
+                    /*!
+                     * @brief Interleaved pass over sizeof...(I) blocks, see rijndael_ni_wide_shuffle.
+                     * Blocks are expanded as a parameter pack so that their states stay in registers.
+                     */
+                    template<bool Decrypt, std::size_t... I>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void process(const block_type *in, block_type *out, const round_keys_type &keys,
+                                               std::index_sequence<I...>) {
+                        typedef int expand[];
+
+                        const __m128i *shuffle = reinterpret_cast<const __m128i *>(shuffle_type::masks.data());
+                        const __m128i masks[4] = {
+                            _mm_load_si128(shuffle + (Decrypt ? 4 : 0)), _mm_load_si128(shuffle + (Decrypt ? 5 : 1)),
+                            _mm_load_si128(shuffle + (Decrypt ? 6 : 2)), _mm_load_si128(shuffle + (Decrypt ? 7 : 3))};
+
+                        __m128i low[sizeof...(I)], high[sizeof...(I)];
+
+                        const __m128i *first = keys + halves * (Decrypt ? rounds : 0);
+                        (void)expand {0, (load_block(in[I], low[I], high[I]), 0)...};
+                        (void)expand {0, (low[I] = _mm_xor_si128(low[I], first[0]), 0)...};
+                        (void)expand {0, (high[I] = _mm_xor_si128(high[I], first[halves - 1]), 0)...};
+
+                        for (std::size_t n = 1; n != rounds; ++n) {
+                            const __m128i *key = keys + halves * (Decrypt ? rounds - n : n);
+                            (void)expand {0, (round<false, Decrypt>(low[I], high[I], masks, key), 0)...};
+                        }
+
+                        const __m128i *last = keys + halves * (Decrypt ? 0 : rounds);
+                        (void)expand {0, (round<true, Decrypt>(low[I], high[I], masks, last), 0)...};
+
+                        (void)expand {0, (store_block(low[I], high[I], out[I]), 0)...};
+                    }
+
+                    template<bool Decrypt>
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static inline void process_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                                      const key_schedule_type &key) {
+                        round_keys_type round_keys;
+                        load_round_keys(key, round_keys);
+
+                        for (; blocks >= parallel_blocks; blocks -= parallel_blocks) {
+                            process<Decrypt>(in, out, round_keys, std::make_index_sequence<parallel_blocks>());
+                            in += parallel_blocks;
+                            out += parallel_blocks;
+                        }
+                        for (; blocks != 0; --blocks) {
+                            process<Decrypt>(in++, out++, round_keys, std::make_index_sequence<1>());
+                        }
+                    }
+
+                public:
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static block_type encrypt_block(const block_type &plaintext,
+                                                    const key_schedule_type &encryption_key) {
+                        block_type out;
+                        process_blocks<false>(&plaintext, &out, 1, encryption_key);
+                        return out;
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static block_type decrypt_block(const block_type &ciphertext,
+                                                    const key_schedule_type &decryption_key) {
+                        block_type out;
+                        process_blocks<true>(&ciphertext, &out, 1, decryption_key);
+                        return out;
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        process_blocks<false>(in, out, blocks, encryption_key);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3,aes")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        process_blocks<true>(in, out, blocks, decryption_key);
+                    }
+
+                    static void schedule_key(const key_type &key, key_schedule_type &encryption_key,
+                                             key_schedule_type &decryption_key) {
+                        key_schedule_impl_type::schedule_key(key, encryption_key, decryption_key);
+                    }
+
+                    static void schedule_keys(const key_type *keys, key_schedule_type *encryption_keys,
+                                              key_schedule_type *decryption_keys, std::size_t count) {
+                        key_schedule_impl_type::schedule_keys(keys, encryption_keys, decryption_keys, count);
+                    }
+                };
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_RIJNDAEL_NI_WIDE_IMPL_HPP
@@ -174,6 +174,20 @@ namespace nil {
 
                         return out;
                     }
+
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = encrypt_block(in[i], encryption_key);
+                        }
+                    }
+
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = decrypt_block(in[i], decryption_key);
+                        }
+                    }
                 };
 
                 template<typename PolicyType>
@@ -264,6 +278,20 @@ namespace nil {
 
                         StoreBlock(B, out.data());
                     }
+
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = encrypt_block(in[i], encryption_key);
+                        }
+                    }
+
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = decrypt_block(in[i], decryption_key);
+                        }
+                    }
                 };
 
                 template<typename PolicyType>
@@ -365,6 +393,20 @@ namespace nil {
 
                         return out;
                     }
+
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = encrypt_block(in[i], encryption_key);
+                        }
+                    }
+
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        for (std::size_t i = 0; i != blocks; ++i) {
+                            out[i] = decrypt_block(in[i], decryption_key);
+                        }
+                    }
                 };
             }    // namespace detail
         }        // namespace block
@@ -33,6 +33,7 @@
 #define CRYPTO3_SSSE3_RIJNDAEL_IMPL_HPP
 
 #include <cstddef>
+#include <utility>
 
 #include <tmmintrin.h>
 
@@ -74,14 +75,14 @@ namespace nil {
 #define mm_xor3(x, y, z) _mm_xor_si128(x, _mm_xor_si128(y, z))
 
                 BOOST_ATTRIBUTE_TARGET("ssse3")
-                __m128i aes_schedule_transform(__m128i input, __m128i table_1, __m128i table_2) {
+                inline __m128i aes_schedule_transform(__m128i input, __m128i table_1, __m128i table_2) {
                     __m128i i_1 = _mm_and_si128(low_nibs, input);
                     __m128i i_2 = _mm_srli_epi32(_mm_andnot_si128(low_nibs, input), 4);
 
                     return _mm_xor_si128(_mm_shuffle_epi8(table_1, i_1), _mm_shuffle_epi8(table_2, i_2));
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_mangle(__m128i k, uint8_t round_no) {
+                BOOST_ATTRIBUTE_TARGET("ssse3") inline __m128i aes_schedule_mangle(__m128i k, uint8_t round_no) {
                     __m128i t = _mm_shuffle_epi8(_mm_xor_si128(k, _mm_set1_epi8(0x5B)), mc_forward[0]);
 
                     __m128i t2 = t;
@@ -93,11 +94,11 @@ namespace nil {
                     return _mm_shuffle_epi8(t2, sr[round_no % 4]);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_192_smear(__m128i x, __m128i y) {
+                BOOST_ATTRIBUTE_TARGET("ssse3") inline __m128i aes_schedule_192_smear(__m128i x, __m128i y) {
                     return mm_xor3(y, _mm_shuffle_epi32(x, 0xFE), _mm_shuffle_epi32(y, 0x80));
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_mangle_dec(__m128i k, uint8_t round_no) {
+                BOOST_ATTRIBUTE_TARGET("ssse3") inline __m128i aes_schedule_mangle_dec(__m128i k, uint8_t round_no) {
                     const __m128i dsk[8] = {_mm_set_epi32(0x4AED9334, 0x82255BFC, 0xB6116FC8, 0x7ED9A700),
                                             _mm_set_epi32(0x8BB89FAC, 0xE9DAFDCE, 0x45765162, 0x27143300),
                                             _mm_set_epi32(0x4622EE8A, 0xADC90561, 0x27438FEB, 0xCCA86400),
@@ -122,7 +123,7 @@ namespace nil {
                     return _mm_shuffle_epi8(output, sr[round_no % 4]);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_mangle_last(__m128i k, uint8_t round_no) {
+                BOOST_ATTRIBUTE_TARGET("ssse3") inline __m128i aes_schedule_mangle_last(__m128i k, uint8_t round_no) {
                     const __m128i out_tr1 = _mm_set_epi32(0xF7974121, 0xDEBE6808, 0xFF9F4929, 0xD6B66000);
                     const __m128i out_tr2 = _mm_set_epi32(0xE10D5DB1, 0xB05C0CE0, 0x01EDBD51, 0x50BCEC00);
 
@@ -131,7 +132,7 @@ namespace nil {
                     return aes_schedule_transform(k, out_tr1, out_tr2);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_mangle_last_dec(__m128i k) {
+                BOOST_ATTRIBUTE_TARGET("ssse3") inline __m128i aes_schedule_mangle_last_dec(__m128i k) {
                     const __m128i deskew1 = _mm_set_epi32(0x1DFEB95A, 0x5DBEF91A, 0x07E4A340, 0x47A4E300);
                     const __m128i deskew2 = _mm_set_epi32(0x2841C2AB, 0xF49D1E77, 0x5F36B5DC, 0x83EA6900);
 
@@ -139,7 +140,8 @@ namespace nil {
                     return aes_schedule_transform(k, deskew1, deskew2);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_schedule_round(__m128i *rcon, __m128i input1, __m128i input2) {
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_schedule_round(__m128i *rcon, __m128i input1, __m128i input2) {
                     if (rcon) {
                         input2 = _mm_xor_si128(_mm_alignr_epi8(_mm_setzero_si128(), *rcon, 15), input2);
 
@@ -169,123 +171,222 @@ namespace nil {
                     return mm_xor3(_mm_shuffle_epi8(sb1u, t5), _mm_shuffle_epi8(sb1t, t6), smeared);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_ssse3_encrypt(__m128i B, const __m128i *keys, size_t rounds) {
-                    const __m128i sb2u = _mm_set_epi32(0x5EB7E955, 0xBC982FCD, 0xE27A93C6, 0x0B712400);
-                    const __m128i sb2t = _mm_set_epi32(0xC2A163C8, 0xAB82234A, 0x69EB8840, 0x0AE12900);
+                const __m128i sb2u = _mm_set_epi32(0x5EB7E955, 0xBC982FCD, 0xE27A93C6, 0x0B712400);
+                const __m128i sb2t = _mm_set_epi32(0xC2A163C8, 0xAB82234A, 0x69EB8840, 0x0AE12900);
 
-                    const __m128i sbou = _mm_set_epi32(0x15AABF7A, 0xC502A878, 0xD0D26D17, 0x6FBDC700);
-                    const __m128i sbot = _mm_set_epi32(0x8E1E90D1, 0x412B35FA, 0xCFE474A5, 0x5FBB6A00);
+                const __m128i sbou = _mm_set_epi32(0x15AABF7A, 0xC502A878, 0xD0D26D17, 0x6FBDC700);
+                const __m128i sbot = _mm_set_epi32(0x8E1E90D1, 0x412B35FA, 0xCFE474A5, 0x5FBB6A00);
 
-                    const __m128i mc_backward[4] = {
-                        _mm_set_epi32(0x0E0D0C0F, 0x0A09080B, 0x06050407, 0x02010003),
-                        _mm_set_epi32(0x0A09080B, 0x06050407, 0x02010003, 0x0E0D0C0F),
-                        _mm_set_epi32(0x06050407, 0x02010003, 0x0E0D0C0F, 0x0A09080B),
-                        _mm_set_epi32(0x02010003, 0x0E0D0C0F, 0x0A09080B, 0x06050407),
-                    };
+                const __m128i mc_backward[4] = {_mm_set_epi32(0x0E0D0C0F, 0x0A09080B, 0x06050407, 0x02010003),
+                                                _mm_set_epi32(0x0A09080B, 0x06050407, 0x02010003, 0x0E0D0C0F),
+                                                _mm_set_epi32(0x06050407, 0x02010003, 0x0E0D0C0F, 0x0A09080B),
+                                                _mm_set_epi32(0x02010003, 0x0E0D0C0F, 0x0A09080B, 0x06050407)};
 
-                    B = mm_xor3(_mm_shuffle_epi8(k_ipt1, _mm_and_si128(low_nibs, B)),
-                                _mm_shuffle_epi8(k_ipt2, _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4)),
-                                _mm_loadu_si128(keys));
+                const __m128i k_dipt1 = _mm_set_epi32(0x154A411E, 0x114E451A, 0x0F505B04, 0x0B545F00);
+                const __m128i k_dipt2 = _mm_set_epi32(0x12771772, 0xF491F194, 0x86E383E6, 0x60056500);
 
-                    for (size_t r = 1;; ++r) {
-                        const __m128i K = _mm_loadu_si128(keys + r);
+                const __m128i sb9u = _mm_set_epi32(0xCAD51F50, 0x4F994CC9, 0x851C0353, 0x9A86D600);
+                const __m128i sb9t = _mm_set_epi32(0x725E2C9E, 0xB2FBA565, 0xC03B1789, 0xECD74900);
 
-                        __m128i t = _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4);
+                const __m128i sbeu = _mm_set_epi32(0x22426004, 0x64B4F6B0, 0x46F29296, 0x26D4D000);
+                const __m128i sbet = _mm_set_epi32(0x9467F36B, 0x98593E32, 0x0C55A6CD, 0xFFAAC100);
 
-                        B = _mm_and_si128(low_nibs, B);
+                const __m128i sbdu = _mm_set_epi32(0xF56E9B13, 0x882A4439, 0x7D57CCDF, 0xE6B1A200);
+                const __m128i sbdt = _mm_set_epi32(0x2931180D, 0x15DEEFD3, 0x3CE2FAF7, 0x24C6CB00);
 
-                        __m128i t2 = _mm_shuffle_epi8(k_inv2, B);
+                const __m128i sbbu = _mm_set_epi32(0x602646F6, 0xB0F2D404, 0xD0226492, 0x96B44200);
+                const __m128i sbbt = _mm_set_epi32(0xF3FF0C3E, 0x3255AA6B, 0xC19498A6, 0xCD596700);
 
-                        B = _mm_xor_si128(B, t);
+                const __m128i sbou_dec = _mm_set_epi32(0xC7AA6DB9, 0xD4943E2D, 0x1387EA53, 0x7EF94000);
+                const __m128i sbot_dec = _mm_set_epi32(0xCA4B8159, 0xD8C58E9C, 0x12D7560F, 0x93441D00);
 
-                        __m128i t3 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, t));
-                        __m128i t4 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, B));
+                /*
+                 * GF(2^4) inversion part of the S-box shared by all rounds, t5 and t6 are the
+                 * indices into the output tables
+                 */
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline void aes_ssse3_inverse(__m128i B, __m128i &t5, __m128i &t6) {
+                    const __m128i t = _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4);
 
-                        __m128i t5 = _mm_xor_si128(B, _mm_shuffle_epi8(k_inv1, t3));
-                        __m128i t6 = _mm_xor_si128(t, _mm_shuffle_epi8(k_inv1, t4));
+                    B = _mm_and_si128(low_nibs, B);
 
-                        if (r == rounds) {
-                            B = _mm_shuffle_epi8(mm_xor3(_mm_shuffle_epi8(sbou, t5), _mm_shuffle_epi8(sbot, t6), K),
-                                                 sr[r % 4]);
+                    const __m128i t2 = _mm_shuffle_epi8(k_inv2, B);
 
-                            return B;
-                        }
+                    B = _mm_xor_si128(B, t);
 
-                        __m128i t7 = mm_xor3(_mm_shuffle_epi8(sb1t, t6), _mm_shuffle_epi8(sb1u, t5), K);
+                    const __m128i t3 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, t));
+                    const __m128i t4 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, B));
 
-                        __m128i t8 = mm_xor3(_mm_shuffle_epi8(sb2t, t6), _mm_shuffle_epi8(sb2u, t5),
-                                             _mm_shuffle_epi8(t7, mc_forward[r % 4]));
+                    t5 = _mm_xor_si128(B, _mm_shuffle_epi8(k_inv1, t3));
+                    t6 = _mm_xor_si128(t, _mm_shuffle_epi8(k_inv1, t4));
+                }
 
-                        B = mm_xor3(_mm_shuffle_epi8(t8, mc_forward[r % 4]), _mm_shuffle_epi8(t7, mc_backward[r % 4]),
-                                    t8);
-                    }
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_encrypt_first(__m128i B, __m128i K) {
+                    return mm_xor3(_mm_shuffle_epi8(k_ipt1, _mm_and_si128(low_nibs, B)),
+                                   _mm_shuffle_epi8(k_ipt2, _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4)), K);
                 }
 
-                BOOST_ATTRIBUTE_TARGET("ssse3") __m128i aes_ssse3_decrypt(__m128i B, const __m128i *keys, size_t rounds) {
-                    const __m128i k_dipt1 = _mm_set_epi32(0x154A411E, 0x114E451A, 0x0F505B04, 0x0B545F00);
-                    const __m128i k_dipt2 = _mm_set_epi32(0x12771772, 0xF491F194, 0x86E383E6, 0x60056500);
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_encrypt_round(__m128i B, __m128i K, std::size_t r) {
+                    __m128i t5, t6;
+                    aes_ssse3_inverse(B, t5, t6);
 
-                    const __m128i sb9u = _mm_set_epi32(0xCAD51F50, 0x4F994CC9, 0x851C0353, 0x9A86D600);
-                    const __m128i sb9t = _mm_set_epi32(0x725E2C9E, 0xB2FBA565, 0xC03B1789, 0xECD74900);
+                    const __m128i t7 = mm_xor3(_mm_shuffle_epi8(sb1t, t6), _mm_shuffle_epi8(sb1u, t5), K);
 
-                    const __m128i sbeu = _mm_set_epi32(0x22426004, 0x64B4F6B0, 0x46F29296, 0x26D4D000);
-                    const __m128i sbet = _mm_set_epi32(0x9467F36B, 0x98593E32, 0x0C55A6CD, 0xFFAAC100);
+                    const __m128i t8 = mm_xor3(_mm_shuffle_epi8(sb2t, t6), _mm_shuffle_epi8(sb2u, t5),
+                                               _mm_shuffle_epi8(t7, mc_forward[r % 4]));
 
-                    const __m128i sbdu = _mm_set_epi32(0xF56E9B13, 0x882A4439, 0x7D57CCDF, 0xE6B1A200);
-                    const __m128i sbdt = _mm_set_epi32(0x2931180D, 0x15DEEFD3, 0x3CE2FAF7, 0x24C6CB00);
+                    return mm_xor3(_mm_shuffle_epi8(t8, mc_forward[r % 4]), _mm_shuffle_epi8(t7, mc_backward[r % 4]),
+                                   t8);
+                }
 
-                    const __m128i sbbu = _mm_set_epi32(0x602646F6, 0xB0F2D404, 0xD0226492, 0x96B44200);
-                    const __m128i sbbt = _mm_set_epi32(0xF3FF0C3E, 0x3255AA6B, 0xC19498A6, 0xCD596700);
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_encrypt_last(__m128i B, __m128i K, std::size_t r) {
+                    __m128i t5, t6;
+                    aes_ssse3_inverse(B, t5, t6);
 
-                    __m128i mc = mc_forward[3];
+                    return _mm_shuffle_epi8(mm_xor3(_mm_shuffle_epi8(sbou, t5), _mm_shuffle_epi8(sbot, t6), K),
+                                            sr[r % 4]);
+                }
 
-                    __m128i t = _mm_shuffle_epi8(k_dipt2, _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4));
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_decrypt_first(__m128i B, __m128i K) {
+                    const __m128i t = _mm_shuffle_epi8(k_dipt2, _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4));
 
-                    B = mm_xor3(t, _mm_loadu_si128(keys), _mm_shuffle_epi8(k_dipt1, _mm_and_si128(B, low_nibs)));
+                    return mm_xor3(t, K, _mm_shuffle_epi8(k_dipt1, _mm_and_si128(B, low_nibs)));
+                }
 
-                    for (size_t r = 1;; ++r) {
-                        const __m128i K = _mm_loadu_si128(keys + r);
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_decrypt_round(__m128i B, __m128i K, __m128i mc) {
+                    __m128i t5, t6;
+                    aes_ssse3_inverse(B, t5, t6);
 
-                        t = _mm_srli_epi32(_mm_andnot_si128(low_nibs, B), 4);
+                    const __m128i t8 = mm_xor3(_mm_shuffle_epi8(sb9t, t6), _mm_shuffle_epi8(sb9u, t5), K);
 
-                        B = _mm_and_si128(low_nibs, B);
+                    const __m128i t9 =
+                        mm_xor3(_mm_shuffle_epi8(t8, mc), _mm_shuffle_epi8(sbdu, t5), _mm_shuffle_epi8(sbdt, t6));
 
-                        __m128i t2 = _mm_shuffle_epi8(k_inv2, B);
+                    const __m128i t12 =
+                        mm_xor3(_mm_shuffle_epi8(t9, mc), _mm_shuffle_epi8(sbbu, t5), _mm_shuffle_epi8(sbbt, t6));
 
-                        B = _mm_xor_si128(B, t);
+                    return mm_xor3(_mm_shuffle_epi8(t12, mc), _mm_shuffle_epi8(sbeu, t5), _mm_shuffle_epi8(sbet, t6));
+                }
 
-                        __m128i t3 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, t));
-                        __m128i t4 = _mm_xor_si128(t2, _mm_shuffle_epi8(k_inv1, B));
-                        __m128i t5 = _mm_xor_si128(B, _mm_shuffle_epi8(k_inv1, t3));
-                        __m128i t6 = _mm_xor_si128(t, _mm_shuffle_epi8(k_inv1, t4));
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_decrypt_last(__m128i B, __m128i K, std::size_t rounds) {
+                    __m128i t5, t6;
+                    aes_ssse3_inverse(B, t5, t6);
 
-                        if (r == rounds) {
-                            const __m128i sbou = _mm_set_epi32(0xC7AA6DB9, 0xD4943E2D, 0x1387EA53, 0x7EF94000);
-                            const __m128i sbot = _mm_set_epi32(0xCA4B8159, 0xD8C58E9C, 0x12D7560F, 0x93441D00);
+                    const __m128i x = mm_xor3(_mm_shuffle_epi8(sbou_dec, t5), K, _mm_shuffle_epi8(sbot_dec, t6));
 
-                            __m128i x = _mm_shuffle_epi8(sbou, t5);
-                            __m128i y = _mm_shuffle_epi8(sbot, t6);
-                            x = _mm_xor_si128(x, K);
-                            x = _mm_xor_si128(x, y);
+                    const uint32_t which_sr = ((((rounds - 1) << 4) ^ 48) & 48) / 16;
+                    return _mm_shuffle_epi8(x, sr[which_sr]);
+                }
 
-                            const uint32_t which_sr = ((((rounds - 1) << 4) ^ 48) & 48) / 16;
-                            return _mm_shuffle_epi8(x, sr[which_sr]);
-                        }
+                /*!
+                 * @brief Encrypts sizeof...(I) blocks with interleaved rounds. Every round is a long
+                 * serial chain of pshufb lookups, running independent blocks side by side lets the
+                 * CPU overlap them while the lookup tables are shared.
+                 */
+                template<std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline void aes_ssse3_encrypt(__m128i *B, const __m128i *keys, std::size_t rounds,
+                                              std::index_sequence<I...>) {
+                    typedef int expand[];
 
-                        __m128i t8 =
-                            _mm_xor_si128(_mm_shuffle_epi8(sb9t, t6), _mm_xor_si128(_mm_shuffle_epi8(sb9u, t5), K));
+                    const __m128i K0 = _mm_loadu_si128(keys);
+                    (void)expand {0, (B[I] = aes_ssse3_encrypt_first(B[I], K0), 0)...};
 
-                        __m128i t9 =
-                            mm_xor3(_mm_shuffle_epi8(t8, mc), _mm_shuffle_epi8(sbdu, t5), _mm_shuffle_epi8(sbdt, t6));
+                    for (std::size_t r = 1; r != rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(keys + r);
+                        (void)expand {0, (B[I] = aes_ssse3_encrypt_round(B[I], K, r), 0)...};
+                    }
 
-                        __m128i t12 = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(t9, mc), _mm_shuffle_epi8(sbbu, t5)),
-                                                    _mm_shuffle_epi8(sbbt, t6));
+                    const __m128i K = _mm_loadu_si128(keys + rounds);
+                    (void)expand {0, (B[I] = aes_ssse3_encrypt_last(B[I], K, rounds), 0)...};
+                }
 
-                        B = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(t12, mc), _mm_shuffle_epi8(sbeu, t5)),
-                                          _mm_shuffle_epi8(sbet, t6));
+                template<std::size_t... I>
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline void aes_ssse3_decrypt(__m128i *B, const __m128i *keys, std::size_t rounds,
+                                              std::index_sequence<I...>) {
+                    typedef int expand[];
 
+                    const __m128i K0 = _mm_loadu_si128(keys);
+                    (void)expand {0, (B[I] = aes_ssse3_decrypt_first(B[I], K0), 0)...};
+
+                    __m128i mc = mc_forward[3];
+                    for (std::size_t r = 1; r != rounds; ++r) {
+                        const __m128i K = _mm_loadu_si128(keys + r);
+                        (void)expand {0, (B[I] = aes_ssse3_decrypt_round(B[I], K, mc), 0)...};
                         mc = _mm_alignr_epi8(mc, mc, 12);
                     }
+
+                    const __m128i K = _mm_loadu_si128(keys + rounds);
+                    (void)expand {0, (B[I] = aes_ssse3_decrypt_last(B[I], K, rounds), 0)...};
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_encrypt(__m128i B, const __m128i *keys, size_t rounds) {
+                    aes_ssse3_encrypt(&B, keys, rounds, std::make_index_sequence<1>());
+                    return B;
+                }
+
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline __m128i aes_ssse3_decrypt(__m128i B, const __m128i *keys, size_t rounds) {
+                    aes_ssse3_decrypt(&B, keys, rounds, std::make_index_sequence<1>());
+                    return B;
+                }
+
+                /*!
+                 * @brief Bulk pass over contiguous blocks, four and two at a time where possible
+                 */
+                template<bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("ssse3")
+                inline void aes_ssse3_process_blocks(const uint8_t *in, uint8_t *out, std::size_t blocks,
+                                                     const __m128i *keys, std::size_t rounds) {
+                    const __m128i *in_mm = reinterpret_cast<const __m128i *>(in);
+                    __m128i *out_mm = reinterpret_cast<__m128i *>(out);
+
+                    while (blocks >= 4) {
+                        __m128i B[4] = {_mm_loadu_si128(in_mm), _mm_loadu_si128(in_mm + 1),
+                                        _mm_loadu_si128(in_mm + 2), _mm_loadu_si128(in_mm + 3)};
+                        if (Decrypt) {
+                            aes_ssse3_decrypt(B, keys, rounds, std::make_index_sequence<4>());
+                        } else {
+                            aes_ssse3_encrypt(B, keys, rounds, std::make_index_sequence<4>());
+                        }
+                        _mm_storeu_si128(out_mm, B[0]);
+                        _mm_storeu_si128(out_mm + 1, B[1]);
+                        _mm_storeu_si128(out_mm + 2, B[2]);
+                        _mm_storeu_si128(out_mm + 3, B[3]);
+
+                        in_mm += 4;
+                        out_mm += 4;
+                        blocks -= 4;
+                    }
+
+                    if (blocks >= 2) {
+                        __m128i B[2] = {_mm_loadu_si128(in_mm), _mm_loadu_si128(in_mm + 1)};
+                        if (Decrypt) {
+                            aes_ssse3_decrypt(B, keys, rounds, std::make_index_sequence<2>());
+                        } else {
+                            aes_ssse3_encrypt(B, keys, rounds, std::make_index_sequence<2>());
+                        }
+                        _mm_storeu_si128(out_mm, B[0]);
+                        _mm_storeu_si128(out_mm + 1, B[1]);
+
+                        in_mm += 2;
+                        out_mm += 2;
+                        blocks -= 2;
+                    }
+
+                    if (blocks) {
+                        const __m128i B = _mm_loadu_si128(in_mm);
+                        _mm_storeu_si128(out_mm, Decrypt ? aes_ssse3_decrypt(B, keys, rounds) :
+                                                           aes_ssse3_encrypt(B, keys, rounds));
+                    }
                 }
 
                 template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
@@ -309,6 +410,7 @@ namespace nil {
                     BOOST_STATIC_ASSERT(PolicyType::block_bits == 128);
 
                 public:
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
                     static block_type encrypt_block(const block_type &plaintext,
                                                     const key_schedule_type &encryption_key) {
                         block_type out = {0};
@@ -330,6 +432,7 @@ namespace nil {
                         return out;
                     }
 
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
                     static block_type decrypt_block(const block_type &plaintext,
                                                     const key_schedule_type &decryption_key) {
                         block_type out = {0};
@@ -350,6 +453,22 @@ namespace nil {
 
                         return out;
                     }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_ssse3_process_blocks<false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()), policy_type::rounds);
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_ssse3_process_blocks<true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()), policy_type::rounds);
+                    }
                 };
 
                 template<typename PolicyType>
@@ -363,6 +482,7 @@ namespace nil {
                     typedef typename policy_type::key_schedule_type key_schedule_type;
 
                 public:
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
                     static void schedule_key(const key_type &input_key, key_schedule_type &encryption_key,
                                              key_schedule_type &decryption_key) {
                         __m128i rcon = _mm_set_epi32(0x702A9808, 0x4D7C7D81, 0x1F8391B9, 0xAF9DEEB6);
@@ -406,6 +526,7 @@ namespace nil {
                     typedef typename policy_type::key_schedule_type key_schedule_type;
 
                 public:
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
                     static void schedule_key(const key_type &input_key, key_schedule_type &encryption_key,
                                              key_schedule_type &decryption_key) {
                         __m128i rcon = _mm_set_epi32(0x702A9808, 0x4D7C7D81, 0x1F8391B9, 0xAF9DEEB6);
@@ -475,6 +596,7 @@ namespace nil {
                     typedef typename policy_type::key_schedule_type key_schedule_type;
 
                 public:
+                    BOOST_ATTRIBUTE_TARGET("ssse3")
                     static void schedule_key(const key_type &input_key, key_schedule_type &encryption_key,
                                              key_schedule_type &decryption_key) {
                         __m128i rcon = _mm_set_epi32(0x702A9808, 0x4D7C7D81, 0x1F8391B9, 0xAF9DEEB6);
@@ -0,0 +1,1031 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_RIJNDAEL_VAES_IMPL_HPP
+#define CRYPTO3_RIJNDAEL_VAES_IMPL_HPP
+
+#include <cstddef>
+
+#include <immintrin.h>
+
+#include <nil/crypto3/detail/config.hpp>
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_ni_impl.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @cond DETAIL_IMPL
+             */
+            namespace detail {
+                /*!
+                 * @brief Amount of blocks processed simultaneously by bulk VAES routines: four
+                 * vectors with two (AVX2) or four (AVX-512) blocks each, kept in flight to cover
+                 * the vaesenc latency.
+                 */
+                constexpr static const std::size_t rijndael_vaes_avx2_parallel_blocks = 8;
+                constexpr static const std::size_t rijndael_vaes_avx512_parallel_blocks = 16;
+
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes")
+                inline void aes_vaes_enc_4(__m256i &B0, __m256i &B1, __m256i &B2, __m256i &B3, const __m256i &K) {
+                    B0 = _mm256_aesenc_epi128(B0, K);
+                    B1 = _mm256_aesenc_epi128(B1, K);
+                    B2 = _mm256_aesenc_epi128(B2, K);
+                    B3 = _mm256_aesenc_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes")
+                inline void aes_vaes_enclast_4(__m256i &B0, __m256i &B1, __m256i &B2, __m256i &B3,
+                                               const __m256i &K) {
+                    B0 = _mm256_aesenclast_epi128(B0, K);
+                    B1 = _mm256_aesenclast_epi128(B1, K);
+                    B2 = _mm256_aesenclast_epi128(B2, K);
+                    B3 = _mm256_aesenclast_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes")
+                inline void aes_vaes_dec_4(__m256i &B0, __m256i &B1, __m256i &B2, __m256i &B3, const __m256i &K) {
+                    B0 = _mm256_aesdec_epi128(B0, K);
+                    B1 = _mm256_aesdec_epi128(B1, K);
+                    B2 = _mm256_aesdec_epi128(B2, K);
+                    B3 = _mm256_aesdec_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes")
+                inline void aes_vaes_declast_4(__m256i &B0, __m256i &B1, __m256i &B2, __m256i &B3,
+                                               const __m256i &K) {
+                    B0 = _mm256_aesdeclast_epi128(B0, K);
+                    B1 = _mm256_aesdeclast_epi128(B1, K);
+                    B2 = _mm256_aesdeclast_epi128(B2, K);
+                    B3 = _mm256_aesdeclast_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes")
+                inline void aes_vaes_enc_4(__m512i &B0, __m512i &B1, __m512i &B2, __m512i &B3, const __m512i &K) {
+                    B0 = _mm512_aesenc_epi128(B0, K);
+                    B1 = _mm512_aesenc_epi128(B1, K);
+                    B2 = _mm512_aesenc_epi128(B2, K);
+                    B3 = _mm512_aesenc_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes")
+                inline void aes_vaes_enclast_4(__m512i &B0, __m512i &B1, __m512i &B2, __m512i &B3,
+                                               const __m512i &K) {
+                    B0 = _mm512_aesenclast_epi128(B0, K);
+                    B1 = _mm512_aesenclast_epi128(B1, K);
+                    B2 = _mm512_aesenclast_epi128(B2, K);
+                    B3 = _mm512_aesenclast_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes")
+                inline void aes_vaes_dec_4(__m512i &B0, __m512i &B1, __m512i &B2, __m512i &B3, const __m512i &K) {
+                    B0 = _mm512_aesdec_epi128(B0, K);
+                    B1 = _mm512_aesdec_epi128(B1, K);
+                    B2 = _mm512_aesdec_epi128(B2, K);
+                    B3 = _mm512_aesdec_epi128(B3, K);
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes")
+                inline void aes_vaes_declast_4(__m512i &B0, __m512i &B1, __m512i &B2, __m512i &B3,
+                                               const __m512i &K) {
+                    B0 = _mm512_aesdeclast_epi128(B0, K);
+                    B1 = _mm512_aesdeclast_epi128(B1, K);
+                    B2 = _mm512_aesdeclast_epi128(B2, K);
+                    B3 = _mm512_aesdeclast_epi128(B3, K);
+                }
+
+                /*!
+                 * @brief Broadcasts each round key to all four lanes. The zero-masking broadcast under
+                 * a full mask gives the same vectors as the plain one, which merges into an undefined
+                 * vector that GCC 12 reports as uninitialized once inlined.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("avx512f")
+                inline void aes_vaes_avx512_load_key(const __m128i *key_mm, __m512i *K) {
+                    for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                        K[r] = _mm512_maskz_broadcast_i32x4(0xffff, _mm_loadu_si128(key_mm + r));
+                    }
+                }
+
+                /*!
+                 * @brief Bulk pass over contiguous blocks with 256-bit VAES: eight blocks per
+                 * iteration, remainder with the 128-bit AES instructions.
+                 * @tparam Rounds Cipher rounds count
+                 * @tparam Decrypt Use aesdec/aesdeclast with an inverse key schedule
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                inline void aes_vaes_avx2_process_blocks(const uint8_t *in, uint8_t *out, std::size_t blocks,
+                                                         const __m128i *key_mm) {
+                    __m256i K[Rounds + 1];
+                    for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                        K[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(key_mm + r));
+                    }
+
+                    const __m256i *in_mm = reinterpret_cast<const __m256i *>(in);
+                    __m256i *out_mm = reinterpret_cast<__m256i *>(out);
+
+                    for (; blocks >= rijndael_vaes_avx2_parallel_blocks;
+                         blocks -= rijndael_vaes_avx2_parallel_blocks, in_mm += 4, out_mm += 4) {
+                        __m256i B0 = _mm256_xor_si256(_mm256_loadu_si256(in_mm), K[0]);
+                        __m256i B1 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 1), K[0]);
+                        __m256i B2 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 2), K[0]);
+                        __m256i B3 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 3), K[0]);
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            if (Decrypt) {
+                                aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                            } else {
+                                aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                            }
+                        }
+
+                        if (Decrypt) {
+                            aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                        } else {
+                            aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                        }
+
+                        _mm256_storeu_si256(out_mm, B0);
+                        _mm256_storeu_si256(out_mm + 1, B1);
+                        _mm256_storeu_si256(out_mm + 2, B2);
+                        _mm256_storeu_si256(out_mm + 3, B3);
+                    }
+
+                    for (; blocks >= 2; blocks -= 2, ++in_mm, ++out_mm) {
+                        __m256i B = _mm256_xor_si256(_mm256_loadu_si256(in_mm), K[0]);
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = Decrypt ? _mm256_aesdec_epi128(B, K[r]) : _mm256_aesenc_epi128(B, K[r]);
+                        }
+                        B = Decrypt ? _mm256_aesdeclast_epi128(B, K[Rounds]) : _mm256_aesenclast_epi128(B, K[Rounds]);
+                        _mm256_storeu_si256(out_mm, B);
+                    }
+
+                    if (blocks != 0) {
+                        __m128i B = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in_mm)),
+                                                  _mm_loadu_si128(key_mm));
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = Decrypt ? _mm_aesdec_si128(B, _mm_loadu_si128(key_mm + r)) :
+                                          _mm_aesenc_si128(B, _mm_loadu_si128(key_mm + r));
+                        }
+                        B = Decrypt ? _mm_aesdeclast_si128(B, _mm_loadu_si128(key_mm + Rounds)) :
+                                      _mm_aesenclast_si128(B, _mm_loadu_si128(key_mm + Rounds));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out_mm), B);
+                    }
+                }
+
+                /*!
+                 * @brief Bulk pass over contiguous blocks with 512-bit VAES: sixteen blocks per
+                 * iteration, then four-block vectors, the last one masked.
+                 * @tparam Rounds Cipher rounds count
+                 * @tparam Decrypt Use aesdec/aesdeclast with an inverse key schedule
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                inline void aes_vaes_avx512_process_blocks(const uint8_t *in, uint8_t *out, std::size_t blocks,
+                                                           const __m128i *key_mm) {
+                    __m512i K[Rounds + 1];
+                    aes_vaes_avx512_load_key<Rounds>(key_mm, K);
+
+                    const __m512i *in_mm = reinterpret_cast<const __m512i *>(in);
+                    __m512i *out_mm = reinterpret_cast<__m512i *>(out);
+
+                    for (; blocks >= rijndael_vaes_avx512_parallel_blocks;
+                         blocks -= rijndael_vaes_avx512_parallel_blocks, in_mm += 4, out_mm += 4) {
+                        __m512i B0 = _mm512_xor_si512(_mm512_loadu_si512(in_mm), K[0]);
+                        __m512i B1 = _mm512_xor_si512(_mm512_loadu_si512(in_mm + 1), K[0]);
+                        __m512i B2 = _mm512_xor_si512(_mm512_loadu_si512(in_mm + 2), K[0]);
+                        __m512i B3 = _mm512_xor_si512(_mm512_loadu_si512(in_mm + 3), K[0]);
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            if (Decrypt) {
+                                aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                            } else {
+                                aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                            }
+                        }
+
+                        if (Decrypt) {
+                            aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                        } else {
+                            aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                        }
+
+                        _mm512_storeu_si512(out_mm, B0);
+                        _mm512_storeu_si512(out_mm + 1, B1);
+                        _mm512_storeu_si512(out_mm + 2, B2);
+                        _mm512_storeu_si512(out_mm + 3, B3);
+                    }
+
+                    while (blocks != 0) {
+                        // Each block spans two 64-bit lanes, a partial vector is loaded and stored under mask
+                        const std::size_t n = blocks < 4 ? blocks : 4;
+                        const __mmask8 mask = static_cast<__mmask8>((1U << (2 * n)) - 1);
+
+                        __m512i B = _mm512_xor_si512(_mm512_maskz_loadu_epi64(mask, in_mm), K[0]);
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = Decrypt ? _mm512_aesdec_epi128(B, K[r]) : _mm512_aesenc_epi128(B, K[r]);
+                        }
+                        B = Decrypt ? _mm512_aesdeclast_epi128(B, K[Rounds]) : _mm512_aesenclast_epi128(B, K[Rounds]);
+                        _mm512_mask_storeu_epi64(out_mm, mask, B);
+
+                        blocks -= n;
+                        ++in_mm;
+                        ++out_mm;
+                    }
+                }
+
+                /*!
+                 * @brief Adds addend to the little-endian 128-bit counters in both lanes. Carries out
+                 * of the low halves are detected with a sign-biased compare, AVX2 having no unsigned one.
+                 */
+                BOOST_ATTRIBUTE_TARGET("avx2")
+                inline __m256i aes_vaes_avx2_ctr_add(__m256i counters, __m256i addend) {
+                    const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+                    const __m256i sum = _mm256_add_epi64(counters, addend);
+                    const __m256i carry =
+                        _mm256_cmpgt_epi64(_mm256_xor_si256(addend, bias), _mm256_xor_si256(sum, bias));
+                    return _mm256_sub_epi64(sum, _mm256_slli_si256(carry, 8));
+                }
+
+                BOOST_ATTRIBUTE_TARGET("avx2")
+                inline __m256i aes_vaes_avx2_byte_reverse(__m256i blocks) {
+                    return _mm256_shuffle_epi8(blocks, _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                                                                       15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                                                       13, 14, 15));
+                }
+
+                /*!
+                 * @brief CTR keystream pass with 256-bit VAES: each vector holds two consecutive
+                 * counters, eight blocks per iteration.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                inline void aes_vaes_avx2_encrypt_ctr(const uint8_t *counter, const uint8_t *in, uint8_t *out,
+                                                      std::size_t blocks, const __m128i *key_mm) {
+                    __m256i K[Rounds + 1];
+                    for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                        K[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(key_mm + r));
+                    }
+
+                    const __m256i *in_mm = reinterpret_cast<const __m256i *>(in);
+                    __m256i *out_mm = reinterpret_cast<__m256i *>(out);
+
+                    const __m256i two = _mm256_set_epi64x(0, 2, 0, 2);
+                    __m256i C = aes_vaes_avx2_ctr_add(
+                        _mm256_broadcastsi128_si256(
+                            aes_ni_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counter)))),
+                        _mm256_set_epi64x(0, 1, 0, 0));
+
+                    for (; blocks >= rijndael_vaes_avx2_parallel_blocks;
+                         blocks -= rijndael_vaes_avx2_parallel_blocks, in_mm += 4, out_mm += 4) {
+                        const __m256i C1 = aes_vaes_avx2_ctr_add(C, two);
+                        const __m256i C2 = aes_vaes_avx2_ctr_add(C1, two);
+                        const __m256i C3 = aes_vaes_avx2_ctr_add(C2, two);
+
+                        __m256i B0 = _mm256_xor_si256(aes_vaes_avx2_byte_reverse(C), K[0]);
+                        __m256i B1 = _mm256_xor_si256(aes_vaes_avx2_byte_reverse(C1), K[0]);
+                        __m256i B2 = _mm256_xor_si256(aes_vaes_avx2_byte_reverse(C2), K[0]);
+                        __m256i B3 = _mm256_xor_si256(aes_vaes_avx2_byte_reverse(C3), K[0]);
+                        C = aes_vaes_avx2_ctr_add(C3, two);
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                        }
+                        aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+
+                        _mm256_storeu_si256(out_mm, _mm256_xor_si256(B0, _mm256_loadu_si256(in_mm)));
+                        _mm256_storeu_si256(out_mm + 1, _mm256_xor_si256(B1, _mm256_loadu_si256(in_mm + 1)));
+                        _mm256_storeu_si256(out_mm + 2, _mm256_xor_si256(B2, _mm256_loadu_si256(in_mm + 2)));
+                        _mm256_storeu_si256(out_mm + 3, _mm256_xor_si256(B3, _mm256_loadu_si256(in_mm + 3)));
+                    }
+
+                    for (; blocks >= 2; blocks -= 2, ++in_mm, ++out_mm) {
+                        __m256i B = _mm256_xor_si256(aes_vaes_avx2_byte_reverse(C), K[0]);
+                        C = aes_vaes_avx2_ctr_add(C, two);
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = _mm256_aesenc_epi128(B, K[r]);
+                        }
+                        B = _mm256_aesenclast_epi128(B, K[Rounds]);
+                        _mm256_storeu_si256(out_mm, _mm256_xor_si256(B, _mm256_loadu_si256(in_mm)));
+                    }
+
+                    if (blocks != 0) {
+                        // The low lane holds the next counter
+                        __m128i B = _mm_xor_si128(aes_ni_byte_reverse(_mm256_castsi256_si128(C)),
+                                                  _mm_loadu_si128(key_mm));
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = _mm_aesenc_si128(B, _mm_loadu_si128(key_mm + r));
+                        }
+                        B = _mm_aesenclast_si128(B, _mm_loadu_si128(key_mm + Rounds));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out_mm),
+                                         _mm_xor_si128(B, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_mm))));
+                    }
+                }
+
+                /*!
+                 * @brief Adds addend to the little-endian 128-bit counters in all four lanes, moving
+                 * carries out of the low halves into the high ones under mask.
+                 */
+                BOOST_ATTRIBUTE_TARGET("avx512f")
+                inline __m512i aes_vaes_avx512_ctr_add(__m512i counters, __m512i addend) {
+                    const __m512i sum = _mm512_add_epi64(counters, addend);
+                    const __mmask8 carry = _mm512_cmplt_epu64_mask(sum, addend);
+                    return _mm512_mask_add_epi64(sum, static_cast<__mmask8>(carry << 1), sum, _mm512_set1_epi64(1));
+                }
+
+                /*!
+                 * @brief Reverses bytes within each 128-bit lane. AVX-512F has no byte shuffle, so
+                 * dwords are byte-swapped with two rotates and a bit select, then reversed in order.
+                 * Zero-masking forms keep the rotates and the shuffle off undefined vectors, see
+                 * aes_vaes_avx512_load_key.
+                 */
+                BOOST_ATTRIBUTE_TARGET("avx512f")
+                inline __m512i aes_vaes_avx512_byte_reverse(__m512i blocks) {
+                    const __m512i swapped =
+                        _mm512_ternarylogic_epi32(_mm512_maskz_rol_epi32(0xffff, blocks, 8),
+                                                  _mm512_maskz_rol_epi32(0xffff, blocks, 24),
+                                                  _mm512_set1_epi32(0x00ff00ff), 0xe4);
+                    return _mm512_maskz_shuffle_epi32(0xffff, swapped, _MM_PERM_ABCD);
+                }
+
+                /*!
+                 * @brief CTR keystream pass with 512-bit VAES: each vector holds four consecutive
+                 * counters, sixteen blocks per iteration and a masked tail.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                inline void aes_vaes_avx512_encrypt_ctr(const uint8_t *counter, const uint8_t *in, uint8_t *out,
+                                                        std::size_t blocks, const __m128i *key_mm) {
+                    __m512i K[Rounds + 1];
+                    aes_vaes_avx512_load_key<Rounds>(key_mm, K);
+
+                    const __m512i *in_mm = reinterpret_cast<const __m512i *>(in);
+                    __m512i *out_mm = reinterpret_cast<__m512i *>(out);
+
+                    const __m512i four = _mm512_set_epi64(0, 4, 0, 4, 0, 4, 0, 4);
+                    const __m128i first =
+                        aes_ni_byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counter)));
+                    __m512i C = aes_vaes_avx512_ctr_add(_mm512_maskz_broadcast_i32x4(0xffff, first),
+                                                        _mm512_set_epi64(0, 3, 0, 2, 0, 1, 0, 0));
+
+                    for (; blocks >= rijndael_vaes_avx512_parallel_blocks;
+                         blocks -= rijndael_vaes_avx512_parallel_blocks, in_mm += 4, out_mm += 4) {
+                        const __m512i C1 = aes_vaes_avx512_ctr_add(C, four);
+                        const __m512i C2 = aes_vaes_avx512_ctr_add(C1, four);
+                        const __m512i C3 = aes_vaes_avx512_ctr_add(C2, four);
+
+                        __m512i B0 = _mm512_xor_si512(aes_vaes_avx512_byte_reverse(C), K[0]);
+                        __m512i B1 = _mm512_xor_si512(aes_vaes_avx512_byte_reverse(C1), K[0]);
+                        __m512i B2 = _mm512_xor_si512(aes_vaes_avx512_byte_reverse(C2), K[0]);
+                        __m512i B3 = _mm512_xor_si512(aes_vaes_avx512_byte_reverse(C3), K[0]);
+                        C = aes_vaes_avx512_ctr_add(C3, four);
+
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                        }
+                        aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+
+                        _mm512_storeu_si512(out_mm, _mm512_xor_si512(B0, _mm512_loadu_si512(in_mm)));
+                        _mm512_storeu_si512(out_mm + 1, _mm512_xor_si512(B1, _mm512_loadu_si512(in_mm + 1)));
+                        _mm512_storeu_si512(out_mm + 2, _mm512_xor_si512(B2, _mm512_loadu_si512(in_mm + 2)));
+                        _mm512_storeu_si512(out_mm + 3, _mm512_xor_si512(B3, _mm512_loadu_si512(in_mm + 3)));
+                    }
+
+                    while (blocks != 0) {
+                        const std::size_t n = blocks < 4 ? blocks : 4;
+                        const __mmask8 mask = static_cast<__mmask8>((1U << (2 * n)) - 1);
+
+                        __m512i B = _mm512_xor_si512(aes_vaes_avx512_byte_reverse(C), K[0]);
+                        C = aes_vaes_avx512_ctr_add(C, four);
+                        for (std::size_t r = 1; r != Rounds; ++r) {
+                            B = _mm512_aesenc_epi128(B, K[r]);
+                        }
+                        B = _mm512_aesenclast_epi128(B, K[Rounds]);
+                        B = _mm512_xor_si512(B, _mm512_maskz_loadu_epi64(mask, in_mm));
+                        _mm512_mask_storeu_epi64(out_mm, mask, B);
+
+                        blocks -= n;
+                        ++in_mm;
+                        ++out_mm;
+                    }
+                }
+
+                /*!
+                 * @brief Multiplies the XTS tweaks in both lanes by the primitive element of GF(2^128)
+                 * raised to Shift. The top Shift bits of each half are moved to the other half, the ones
+                 * of the high half being reduced with 0x87 = x^7 + x^2 + x + 1 by shifts in the low one.
+                 */
+                template<int Shift>
+                BOOST_ATTRIBUTE_TARGET("avx2")
+                inline __m256i aes_vaes_avx2_xts_multiply(__m256i tweaks) {
+                    BOOST_STATIC_ASSERT(Shift > 0 && Shift + 7 <= 64);
+
+                    const __m256i swapped = _mm256_shuffle_epi32(_mm256_srli_epi64(tweaks, 64 - Shift), 0x4e);
+                    const __m256i high = _mm256_and_si256(swapped, _mm256_set_epi64x(0, -1, 0, -1));
+                    const __m256i reduced = _mm256_xor_si256(
+                        _mm256_xor_si256(_mm256_slli_epi64(high, 1), _mm256_slli_epi64(high, 2)),
+                        _mm256_slli_epi64(high, 7));
+                    return _mm256_xor_si256(_mm256_xor_si256(_mm256_slli_epi64(tweaks, Shift), swapped), reduced);
+                }
+
+                /*!
+                 * @brief XTS pass with 256-bit VAES: four vectors of two consecutive tweaks each, every
+                 * vector advanced by eight blocks at once. Less than eight remaining blocks go through
+                 * the AES-NI pass.
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                inline void aes_vaes_avx2_process_xts(uint8_t *tweak, const uint8_t *in, uint8_t *out,
+                                                      std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx2_parallel_blocks) {
+                        __m256i K[Rounds + 1];
+                        for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                            K[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(key_mm + r));
+                        }
+
+                        const __m256i *in_mm = reinterpret_cast<const __m256i *>(in);
+                        __m256i *out_mm = reinterpret_cast<__m256i *>(out);
+
+                        const __m128i T = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tweak));
+                        __m256i T0 = _mm256_inserti128_si256(_mm256_castsi128_si256(T), aes_ni_xts_double(T), 1);
+                        __m256i T1 = aes_vaes_avx2_xts_multiply<2>(T0);
+                        __m256i T2 = aes_vaes_avx2_xts_multiply<2>(T1);
+                        __m256i T3 = aes_vaes_avx2_xts_multiply<2>(T2);
+
+                        for (; blocks >= rijndael_vaes_avx2_parallel_blocks;
+                             blocks -= rijndael_vaes_avx2_parallel_blocks, in_mm += 4, out_mm += 4) {
+                            __m256i B0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256(in_mm), T0), K[0]);
+                            __m256i B1 = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256(in_mm + 1), T1), K[0]);
+                            __m256i B2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256(in_mm + 2), T2), K[0]);
+                            __m256i B3 = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256(in_mm + 3), T3), K[0]);
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                if (Decrypt) {
+                                    aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                                } else {
+                                    aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                                }
+                            }
+                            if (Decrypt) {
+                                aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                            } else {
+                                aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                            }
+
+                            _mm256_storeu_si256(out_mm, _mm256_xor_si256(B0, T0));
+                            _mm256_storeu_si256(out_mm + 1, _mm256_xor_si256(B1, T1));
+                            _mm256_storeu_si256(out_mm + 2, _mm256_xor_si256(B2, T2));
+                            _mm256_storeu_si256(out_mm + 3, _mm256_xor_si256(B3, T3));
+
+                            T0 = aes_vaes_avx2_xts_multiply<8>(T0);
+                            T1 = aes_vaes_avx2_xts_multiply<8>(T1);
+                            T2 = aes_vaes_avx2_xts_multiply<8>(T2);
+                            T3 = aes_vaes_avx2_xts_multiply<8>(T3);
+                        }
+
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(tweak), _mm256_castsi256_si128(T0));
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                        out = reinterpret_cast<uint8_t *>(out_mm);
+                    }
+
+                    aes_ni_process_xts<Rounds, Decrypt>(tweak, in, out, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief Multiplies the XTS tweaks in all four lanes by the primitive element of
+                 * GF(2^128) raised to Shift, see aes_vaes_avx2_xts_multiply. Only the low halves take
+                 * the reduction, selected by the mask of the ternary XOR. The shifts and the shuffle use
+                 * the zero-masking forms, see aes_vaes_avx512_load_key.
+                 */
+                template<int Shift>
+                BOOST_ATTRIBUTE_TARGET("avx512f")
+                inline __m512i aes_vaes_avx512_xts_multiply(__m512i tweaks) {
+                    BOOST_STATIC_ASSERT(Shift > 0 && Shift + 7 <= 64);
+
+                    const __m512i swapped =
+                        _mm512_maskz_shuffle_epi32(0xffff, _mm512_maskz_srli_epi64(0xff, tweaks, 64 - Shift),
+                                                   _MM_PERM_BADC);
+                    const __m512i reduced = _mm512_maskz_ternarylogic_epi64(
+                        0x55, _mm512_maskz_slli_epi64(0xff, swapped, 1), _mm512_maskz_slli_epi64(0xff, swapped, 2),
+                        _mm512_maskz_slli_epi64(0xff, swapped, 7), 0x96);
+                    return _mm512_ternarylogic_epi64(_mm512_maskz_slli_epi64(0xff, tweaks, Shift), swapped, reduced,
+                                                     0x96);
+                }
+
+                /*!
+                 * @brief XTS pass with 512-bit VAES: four vectors of four consecutive tweaks each, every
+                 * vector advanced by sixteen blocks at once. Less than sixteen remaining blocks go
+                 * through the AES-NI pass.
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                inline void aes_vaes_avx512_process_xts(uint8_t *tweak, const uint8_t *in, uint8_t *out,
+                                                        std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx512_parallel_blocks) {
+                        __m512i K[Rounds + 1];
+                        aes_vaes_avx512_load_key<Rounds>(key_mm, K);
+
+                        const __m512i *in_mm = reinterpret_cast<const __m512i *>(in);
+                        __m512i *out_mm = reinterpret_cast<__m512i *>(out);
+
+                        const __m128i T = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tweak));
+                        const __m128i T2x = aes_ni_xts_double(T);
+                        const __m128i T4x = aes_ni_xts_double(T2x);
+                        __m512i T0 = _mm512_inserti32x4(_mm512_setzero_si512(), T, 0);
+                        T0 = _mm512_inserti32x4(T0, T2x, 1);
+                        T0 = _mm512_inserti32x4(T0, T4x, 2);
+                        T0 = _mm512_inserti32x4(T0, aes_ni_xts_double(T4x), 3);
+                        __m512i T1 = aes_vaes_avx512_xts_multiply<4>(T0);
+                        __m512i T2 = aes_vaes_avx512_xts_multiply<4>(T1);
+                        __m512i T3 = aes_vaes_avx512_xts_multiply<4>(T2);
+
+                        for (; blocks >= rijndael_vaes_avx512_parallel_blocks;
+                             blocks -= rijndael_vaes_avx512_parallel_blocks, in_mm += 4, out_mm += 4) {
+                            __m512i B0 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm), T0, K[0], 0x96);
+                            __m512i B1 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 1), T1, K[0], 0x96);
+                            __m512i B2 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 2), T2, K[0], 0x96);
+                            __m512i B3 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 3), T3, K[0], 0x96);
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                if (Decrypt) {
+                                    aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                                } else {
+                                    aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                                }
+                            }
+                            if (Decrypt) {
+                                aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                            } else {
+                                aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                            }
+
+                            _mm512_storeu_si512(out_mm, _mm512_xor_si512(B0, T0));
+                            _mm512_storeu_si512(out_mm + 1, _mm512_xor_si512(B1, T1));
+                            _mm512_storeu_si512(out_mm + 2, _mm512_xor_si512(B2, T2));
+                            _mm512_storeu_si512(out_mm + 3, _mm512_xor_si512(B3, T3));
+
+                            T0 = aes_vaes_avx512_xts_multiply<16>(T0);
+                            T1 = aes_vaes_avx512_xts_multiply<16>(T1);
+                            T2 = aes_vaes_avx512_xts_multiply<16>(T2);
+                            T3 = aes_vaes_avx512_xts_multiply<16>(T3);
+                        }
+
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(tweak),
+                                         _mm512_maskz_extracti32x4_epi32(0xf, T0, 0));
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                        out = reinterpret_cast<uint8_t *>(out_mm);
+                    }
+
+                    aes_ni_process_xts<Rounds, Decrypt>(tweak, in, out, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief OCB pass with 256-bit VAES: four vectors of two blocks each, whitened with
+                 * offsets from the precomputed array. The checksum is kept in one vector and folded at
+                 * the end. Less than eight remaining blocks go through the AES-NI pass.
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                inline void aes_vaes_avx2_process_ocb(const uint8_t *offsets, uint8_t *checksum, const uint8_t *in,
+                                                      uint8_t *out, std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx2_parallel_blocks) {
+                        __m256i K[Rounds + 1];
+                        for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                            K[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(key_mm + r));
+                        }
+
+                        const __m256i *offsets_mm = reinterpret_cast<const __m256i *>(offsets);
+                        const __m256i *in_mm = reinterpret_cast<const __m256i *>(in);
+                        __m256i *out_mm = reinterpret_cast<__m256i *>(out);
+                        __m256i S = _mm256_setzero_si256();
+
+                        for (; blocks >= rijndael_vaes_avx2_parallel_blocks;
+                             blocks -= rijndael_vaes_avx2_parallel_blocks, offsets_mm += 4, in_mm += 4, out_mm += 4) {
+                            const __m256i O0 = _mm256_loadu_si256(offsets_mm);
+                            const __m256i O1 = _mm256_loadu_si256(offsets_mm + 1);
+                            const __m256i O2 = _mm256_loadu_si256(offsets_mm + 2);
+                            const __m256i O3 = _mm256_loadu_si256(offsets_mm + 3);
+                            __m256i B0 = _mm256_loadu_si256(in_mm);
+                            __m256i B1 = _mm256_loadu_si256(in_mm + 1);
+                            __m256i B2 = _mm256_loadu_si256(in_mm + 2);
+                            __m256i B3 = _mm256_loadu_si256(in_mm + 3);
+                            if (!Decrypt) {
+                                S = _mm256_xor_si256(S, _mm256_xor_si256(_mm256_xor_si256(B0, B1),
+                                                                         _mm256_xor_si256(B2, B3)));
+                            }
+                            B0 = _mm256_xor_si256(B0, _mm256_xor_si256(O0, K[0]));
+                            B1 = _mm256_xor_si256(B1, _mm256_xor_si256(O1, K[0]));
+                            B2 = _mm256_xor_si256(B2, _mm256_xor_si256(O2, K[0]));
+                            B3 = _mm256_xor_si256(B3, _mm256_xor_si256(O3, K[0]));
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                if (Decrypt) {
+                                    aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                                } else {
+                                    aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                                }
+                            }
+                            if (Decrypt) {
+                                aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                            } else {
+                                aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                            }
+
+                            B0 = _mm256_xor_si256(B0, O0);
+                            B1 = _mm256_xor_si256(B1, O1);
+                            B2 = _mm256_xor_si256(B2, O2);
+                            B3 = _mm256_xor_si256(B3, O3);
+                            if (Decrypt) {
+                                S = _mm256_xor_si256(S, _mm256_xor_si256(_mm256_xor_si256(B0, B1),
+                                                                         _mm256_xor_si256(B2, B3)));
+                            }
+                            _mm256_storeu_si256(out_mm, B0);
+                            _mm256_storeu_si256(out_mm + 1, B1);
+                            _mm256_storeu_si256(out_mm + 2, B2);
+                            _mm256_storeu_si256(out_mm + 3, B3);
+                        }
+
+                        const __m128i folded = _mm_xor_si128(_mm256_castsi256_si128(S), _mm256_extracti128_si256(S, 1));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(checksum),
+                                         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(checksum)),
+                                                       folded));
+                        offsets = reinterpret_cast<const uint8_t *>(offsets_mm);
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                        out = reinterpret_cast<uint8_t *>(out_mm);
+                    }
+
+                    aes_ni_process_ocb<Rounds, Decrypt>(offsets, checksum, in, out, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief XORs the four lanes of S into acc, with the zero-masking extract under a full
+                 * mask, see aes_vaes_avx512_load_key.
+                 */
+                BOOST_ATTRIBUTE_TARGET("avx512f")
+                inline __m128i aes_vaes_avx512_fold(__m128i acc, __m512i S) {
+                    acc = _mm_xor_si128(acc, _mm512_maskz_extracti32x4_epi32(0xf, S, 0));
+                    acc = _mm_xor_si128(acc, _mm512_maskz_extracti32x4_epi32(0xf, S, 1));
+                    acc = _mm_xor_si128(acc, _mm512_maskz_extracti32x4_epi32(0xf, S, 2));
+                    return _mm_xor_si128(acc, _mm512_maskz_extracti32x4_epi32(0xf, S, 3));
+                }
+
+                /*!
+                 * @brief OCB pass with 512-bit VAES, see aes_vaes_avx2_process_ocb. Sixteen blocks per
+                 * iteration, the rest through the AES-NI pass.
+                 */
+                template<std::size_t Rounds, bool Decrypt>
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                inline void aes_vaes_avx512_process_ocb(const uint8_t *offsets, uint8_t *checksum, const uint8_t *in,
+                                                        uint8_t *out, std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx512_parallel_blocks) {
+                        __m512i K[Rounds + 1];
+                        aes_vaes_avx512_load_key<Rounds>(key_mm, K);
+
+                        const __m512i *offsets_mm = reinterpret_cast<const __m512i *>(offsets);
+                        const __m512i *in_mm = reinterpret_cast<const __m512i *>(in);
+                        __m512i *out_mm = reinterpret_cast<__m512i *>(out);
+                        __m512i S = _mm512_setzero_si512();
+
+                        for (; blocks >= rijndael_vaes_avx512_parallel_blocks;
+                             blocks -= rijndael_vaes_avx512_parallel_blocks, offsets_mm += 4, in_mm += 4,
+                             out_mm += 4) {
+                            const __m512i O0 = _mm512_loadu_si512(offsets_mm);
+                            const __m512i O1 = _mm512_loadu_si512(offsets_mm + 1);
+                            const __m512i O2 = _mm512_loadu_si512(offsets_mm + 2);
+                            const __m512i O3 = _mm512_loadu_si512(offsets_mm + 3);
+                            __m512i B0 = _mm512_loadu_si512(in_mm);
+                            __m512i B1 = _mm512_loadu_si512(in_mm + 1);
+                            __m512i B2 = _mm512_loadu_si512(in_mm + 2);
+                            __m512i B3 = _mm512_loadu_si512(in_mm + 3);
+                            if (!Decrypt) {
+                                S = _mm512_ternarylogic_epi64(S, _mm512_xor_si512(B0, B1),
+                                                              _mm512_xor_si512(B2, B3), 0x96);
+                            }
+                            B0 = _mm512_ternarylogic_epi64(B0, O0, K[0], 0x96);
+                            B1 = _mm512_ternarylogic_epi64(B1, O1, K[0], 0x96);
+                            B2 = _mm512_ternarylogic_epi64(B2, O2, K[0], 0x96);
+                            B3 = _mm512_ternarylogic_epi64(B3, O3, K[0], 0x96);
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                if (Decrypt) {
+                                    aes_vaes_dec_4(B0, B1, B2, B3, K[r]);
+                                } else {
+                                    aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                                }
+                            }
+                            if (Decrypt) {
+                                aes_vaes_declast_4(B0, B1, B2, B3, K[Rounds]);
+                            } else {
+                                aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+                            }
+
+                            B0 = _mm512_xor_si512(B0, O0);
+                            B1 = _mm512_xor_si512(B1, O1);
+                            B2 = _mm512_xor_si512(B2, O2);
+                            B3 = _mm512_xor_si512(B3, O3);
+                            if (Decrypt) {
+                                S = _mm512_ternarylogic_epi64(S, _mm512_xor_si512(B0, B1),
+                                                              _mm512_xor_si512(B2, B3), 0x96);
+                            }
+                            _mm512_storeu_si512(out_mm, B0);
+                            _mm512_storeu_si512(out_mm + 1, B1);
+                            _mm512_storeu_si512(out_mm + 2, B2);
+                            _mm512_storeu_si512(out_mm + 3, B3);
+                        }
+
+                        const __m128i folded =
+                            aes_vaes_avx512_fold(_mm_loadu_si128(reinterpret_cast<const __m128i *>(checksum)), S);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(checksum), folded);
+                        offsets = reinterpret_cast<const uint8_t *>(offsets_mm);
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                        out = reinterpret_cast<uint8_t *>(out_mm);
+                    }
+
+                    aes_ni_process_ocb<Rounds, Decrypt>(offsets, checksum, in, out, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief PMAC pass with 256-bit VAES: four vectors of two blocks each, whitened with
+                 * offsets from the precomputed array and summed in one vector folded at the end. Less
+                 * than eight remaining blocks go through the AES-NI pass.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                inline void aes_vaes_avx2_process_pmac(const uint8_t *offsets, uint8_t *sum, const uint8_t *in,
+                                                       std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx2_parallel_blocks) {
+                        __m256i K[Rounds + 1];
+                        for (std::size_t r = 0; r != Rounds + 1; ++r) {
+                            K[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(key_mm + r));
+                        }
+
+                        const __m256i *offsets_mm = reinterpret_cast<const __m256i *>(offsets);
+                        const __m256i *in_mm = reinterpret_cast<const __m256i *>(in);
+                        __m256i S = _mm256_setzero_si256();
+
+                        for (; blocks >= rijndael_vaes_avx2_parallel_blocks;
+                             blocks -= rijndael_vaes_avx2_parallel_blocks, offsets_mm += 4, in_mm += 4) {
+                            __m256i B0 = _mm256_xor_si256(_mm256_loadu_si256(in_mm),
+                                                          _mm256_xor_si256(_mm256_loadu_si256(offsets_mm), K[0]));
+                            __m256i B1 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 1),
+                                                          _mm256_xor_si256(_mm256_loadu_si256(offsets_mm + 1), K[0]));
+                            __m256i B2 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 2),
+                                                          _mm256_xor_si256(_mm256_loadu_si256(offsets_mm + 2), K[0]));
+                            __m256i B3 = _mm256_xor_si256(_mm256_loadu_si256(in_mm + 3),
+                                                          _mm256_xor_si256(_mm256_loadu_si256(offsets_mm + 3), K[0]));
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                            }
+                            aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+
+                            S = _mm256_xor_si256(S, _mm256_xor_si256(_mm256_xor_si256(B0, B1),
+                                                                     _mm256_xor_si256(B2, B3)));
+                        }
+
+                        const __m128i folded = _mm_xor_si128(_mm256_castsi256_si128(S), _mm256_extracti128_si256(S, 1));
+                        _mm_storeu_si128(
+                            reinterpret_cast<__m128i *>(sum),
+                            _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sum)), folded));
+                        offsets = reinterpret_cast<const uint8_t *>(offsets_mm);
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                    }
+
+                    aes_ni_process_pmac<Rounds>(offsets, sum, in, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief PMAC pass with 512-bit VAES, see aes_vaes_avx2_process_pmac. Sixteen blocks per
+                 * iteration, the rest through the AES-NI pass.
+                 */
+                template<std::size_t Rounds>
+                BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                inline void aes_vaes_avx512_process_pmac(const uint8_t *offsets, uint8_t *sum, const uint8_t *in,
+                                                         std::size_t blocks, const __m128i *key_mm) {
+                    if (blocks >= rijndael_vaes_avx512_parallel_blocks) {
+                        __m512i K[Rounds + 1];
+                        aes_vaes_avx512_load_key<Rounds>(key_mm, K);
+
+                        const __m512i *offsets_mm = reinterpret_cast<const __m512i *>(offsets);
+                        const __m512i *in_mm = reinterpret_cast<const __m512i *>(in);
+                        __m512i S = _mm512_setzero_si512();
+
+                        for (; blocks >= rijndael_vaes_avx512_parallel_blocks;
+                             blocks -= rijndael_vaes_avx512_parallel_blocks, offsets_mm += 4, in_mm += 4) {
+                            __m512i B0 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm),
+                                                                   _mm512_loadu_si512(offsets_mm), K[0], 0x96);
+                            __m512i B1 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 1),
+                                                                   _mm512_loadu_si512(offsets_mm + 1), K[0], 0x96);
+                            __m512i B2 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 2),
+                                                                   _mm512_loadu_si512(offsets_mm + 2), K[0], 0x96);
+                            __m512i B3 = _mm512_ternarylogic_epi64(_mm512_loadu_si512(in_mm + 3),
+                                                                   _mm512_loadu_si512(offsets_mm + 3), K[0], 0x96);
+
+                            for (std::size_t r = 1; r != Rounds; ++r) {
+                                aes_vaes_enc_4(B0, B1, B2, B3, K[r]);
+                            }
+                            aes_vaes_enclast_4(B0, B1, B2, B3, K[Rounds]);
+
+                            S = _mm512_ternarylogic_epi64(S, _mm512_xor_si512(B0, B1), _mm512_xor_si512(B2, B3), 0x96);
+                        }
+
+                        const __m128i folded =
+                            aes_vaes_avx512_fold(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sum)), S);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(sum), folded);
+                        offsets = reinterpret_cast<const uint8_t *>(offsets_mm);
+                        in = reinterpret_cast<const uint8_t *>(in_mm);
+                    }
+
+                    aes_ni_process_pmac<Rounds>(offsets, sum, in, blocks, key_mm);
+                }
+
+                /*!
+                 * @brief AES with VAES bulk processing. Key schedule and single block operations
+                 * are shared with the AES-NI implementation, only the multi-block path is widened.
+                 */
+                template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
+                class rijndael_vaes_avx2_impl : public rijndael_ni_impl<KeyBitsImpl, BlockBitsImpl, PolicyType> {
+                    typedef PolicyType policy_type;
+                    typedef typename policy_type::block_type block_type;
+                    typedef typename policy_type::key_schedule_type key_schedule_type;
+
+                public:
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx2_process_blocks<policy_type::rounds, false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_vaes_avx2_process_blocks<policy_type::rounds, true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void encrypt_ctr(const block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx2_encrypt_ctr<policy_type::rounds>(
+                            counter.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void encrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx2_process_xts<policy_type::rounds, false>(
+                            tweak.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void decrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key) {
+                        detail::aes_vaes_avx2_process_xts<policy_type::rounds, true>(
+                            tweak.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void encrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &checksum) {
+                        detail::aes_vaes_avx2_process_ocb<policy_type::rounds, false>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void decrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key,
+                                            block_type &checksum) {
+                        detail::aes_vaes_avx2_process_ocb<policy_type::rounds, true>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx2,vaes,aes")
+                    static void encrypt_pmac(const block_type *offsets, const block_type *in, std::size_t blocks,
+                                             const key_schedule_type &encryption_key, block_type &sum) {
+                        detail::aes_vaes_avx2_process_pmac<policy_type::rounds>(
+                            reinterpret_cast<const uint8_t *>(offsets), sum.data(),
+                            reinterpret_cast<const uint8_t *>(in), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+                };
+
+                template<std::size_t KeyBitsImpl, std::size_t BlockBitsImpl, typename PolicyType>
+                class rijndael_vaes_avx512_impl : public rijndael_ni_impl<KeyBitsImpl, BlockBitsImpl, PolicyType> {
+                    typedef PolicyType policy_type;
+                    typedef typename policy_type::block_type block_type;
+                    typedef typename policy_type::key_schedule_type key_schedule_type;
+
+                public:
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void encrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx512_process_blocks<policy_type::rounds, false>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void decrypt_blocks(const block_type *in, block_type *out, std::size_t blocks,
+                                               const key_schedule_type &decryption_key) {
+                        detail::aes_vaes_avx512_process_blocks<policy_type::rounds, true>(
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void encrypt_ctr(const block_type &counter, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx512_encrypt_ctr<policy_type::rounds>(
+                            counter.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void encrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key) {
+                        detail::aes_vaes_avx512_process_xts<policy_type::rounds, false>(
+                            tweak.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void decrypt_xts(block_type &tweak, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key) {
+                        detail::aes_vaes_avx512_process_xts<policy_type::rounds, true>(
+                            tweak.data(), reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out),
+                            blocks, reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void encrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &encryption_key,
+                                            block_type &checksum) {
+                        detail::aes_vaes_avx512_process_ocb<policy_type::rounds, false>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void decrypt_ocb(const block_type *offsets, const block_type *in, block_type *out,
+                                            std::size_t blocks, const key_schedule_type &decryption_key,
+                                            block_type &checksum) {
+                        detail::aes_vaes_avx512_process_ocb<policy_type::rounds, true>(
+                            reinterpret_cast<const uint8_t *>(offsets), checksum.data(),
+                            reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), blocks,
+                            reinterpret_cast<const __m128i *>(decryption_key.data()));
+                    }
+
+                    BOOST_ATTRIBUTE_TARGET("avx512f,vaes,aes")
+                    static void encrypt_pmac(const block_type *offsets, const block_type *in, std::size_t blocks,
+                                             const key_schedule_type &encryption_key, block_type &sum) {
+                        detail::aes_vaes_avx512_process_pmac<policy_type::rounds>(
+                            reinterpret_cast<const uint8_t *>(offsets), sum.data(),
+                            reinterpret_cast<const uint8_t *>(in), blocks,
+                            reinterpret_cast<const __m128i *>(encryption_key.data()));
+                    }
+                };
+            }    // namespace detail
+            /*!
+             * @endcond
+             */
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_RIJNDAEL_VAES_IMPL_HPP
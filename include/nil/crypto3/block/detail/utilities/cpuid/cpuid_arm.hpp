@@ -1,17 +1,22 @@
-#include <nil/crypto3/utilities/cpuid/cpuid.hpp>
+#ifndef CRYPTO3_CPUID_ARM_HPP
+#define CRYPTO3_CPUID_ARM_HPP
 
-#if defined(BOOST_ARCH_ARM)
+#include <cctype>
+#include <string>
 
-#if defined(CRYPTO3_TARGET_OS_HAS_GETAUXVAL)
+#include <boost/predef/os.h>
+
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#if BOOST_ARCH_ARM
+
+#if BOOST_OS_LINUX
 #include <sys/auxv.h>
 
-#elif defined(CRYPTO3_TARGET_OS_IS_IOS)
+#elif BOOST_OS_IOS
 #include <sys/types.h>
 #include <sys/sysctl.h>
 
-#else
-#include <nil/crypto3/utilities/os_utils.h>
-
 #endif
 
 #endif
@@ -19,13 +24,13 @@
 namespace nil {
     namespace crypto3 {
 
-#if defined(BOOST_ARCH_ARM)
+#if BOOST_ARCH_ARM
 
-#if defined(CRYPTO3_TARGET_OS_IS_IOS)
+#if BOOST_OS_IOS
 
-        namespace {
+        namespace detail {
 
-            uint64_t flags_by_ios_machine_type(const std::string &machine) {
+            inline uint64_t flags_by_ios_machine_type(const std::string &machine) {
                 /*
                  * This relies on a map of known machine names to features. This
                  * will quickly grow out of date as new products are introduced, but
@@ -85,14 +90,14 @@ namespace nil {
                 return 0;
             }
 
-        }    // namespace
+        }    // namespace detail
 
 #endif
 
-        uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
+        inline uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
             uint64_t detected_features = 0;
 
-#if defined(CRYPTO3_TARGET_OS_HAS_GETAUXVAL)
+#if BOOST_OS_LINUX
             /*
              * On systems with getauxval these bits should normally be defined
              * in bits/auxv.h but some buggy? glibc installs seem to miss them.
@@ -101,16 +106,7 @@ namespace nil {
              */
 
             enum ARM_hwcap_bit {
-#if defined(CRYPTO3_TARGET_ARCHITECTURE_IS_ARM32)
-                NEON_bit = (1 << 12),
-                AES_bit = (1 << 0),
-                PMULL_bit = (1 << 1),
-                SHA1_bit = (1 << 2),
-                SHA2_bit = (1 << 3),
-
-                ARCH_hwcap_neon = 16,      // AT_HWCAP
-                ARCH_hwcap_crypto = 26,    // AT_HWCAP2
-#elif defined(CRYPTO3_TARGET_ARCHITECTURE_IS_ARM64)
+#if defined(__aarch64__)
                 NEON_bit = (1 << 1),
                 AES_bit = (1 << 3),
                 PMULL_bit = (1 << 4),
@@ -119,6 +115,15 @@ namespace nil {
 
                 ARCH_hwcap_neon = 16,      // AT_HWCAP
                 ARCH_hwcap_crypto = 16,    // AT_HWCAP
+#else
+                NEON_bit = (1 << 12),
+                AES_bit = (1 << 0),
+                PMULL_bit = (1 << 1),
+                SHA1_bit = (1 << 2),
+                SHA2_bit = (1 << 3),
+
+                ARCH_hwcap_neon = 16,      // AT_HWCAP
+                ARCH_hwcap_crypto = 26,    // AT_HWCAP2
 #endif
             };
 
@@ -128,6 +133,8 @@ namespace nil {
             // plausibility check
             if (dcache_line == 32 || dcache_line == 64 || dcache_line == 128)
                 *cache_line_size = static_cast<size_t>(dcache_line);
+#else
+            (void)cache_line_size;
 #endif
 
             const unsigned long hwcap_neon = ::getauxval(ARM_hwcap_bit::ARCH_hwcap_neon);
@@ -149,60 +156,25 @@ namespace nil {
             if (hwcap_crypto & ARM_hwcap_bit::SHA2_bit)
                 detected_features |= cpuid::CPUID_ARM_SHA2_BIT;
 
-#elif defined(CRYPTO3_TARGET_OS_IS_IOS)
+#elif BOOST_OS_IOS
+
+            (void)cache_line_size;
 
             char machine[64] = {0};
             size_t size = sizeof(machine) - 1;
             ::sysctlbyname("hw.machine", machine, &size, nullptr, 0);
 
-            detected_features = flags_by_ios_machine_type(machine);
+            detected_features = detail::flags_by_ios_machine_type(machine);
 
-#elif defined(CRYPTO3_USE_GCC_INLINE_ASM) && defined(CRYPTO3_TARGET_ARCHITECTURE_IS_ARM64)
+#else
 
             /*
-            No getauxval API available, fall back on probe functions. We only
-            bother with Aarch64 here to simplify the code and because going to
-            extreme contortions to support detect NEON on devices that probably
-            don't support it doesn't seem worthwhile.
-
-            NEON registers v0-v7 are caller saved in Aarch64
+            Without an OS interface to query, no extension is reported and the
+            library keeps to what the compiler was told to target. Probing by
+            executing instructions needs a SIGILL handler, which a header-only
+            library has no business installing.
             */
-
-            auto neon_probe = []() -> int {
-                asm("and v0.16b, v0.16b, v0.16b");
-                return 1;
-            };
-            auto aes_probe = []() -> int {
-                asm(".word 0x4e284800");
-                return 1;
-            };
-            auto pmull_probe = []() -> int {
-                asm(".word 0x0ee0e000");
-                return 1;
-            };
-            auto sha1_probe = []() -> int {
-                asm(".word 0x5e280800");
-                return 1;
-            };
-            auto sha2_probe = []() -> int {
-                asm(".word 0x5e282800");
-                return 1;
-            };
-
-            // Only bother running the crypto3 detection if we found NEON
-
-            if (run_cpu_instruction_probe(neon_probe) == 1) {
-                detected_features |= cpuid::CPUID_ARM_NEON_BIT;
-
-                if (run_cpu_instruction_probe(aes_probe) == 1)
-                    detected_features |= cpuid::CPUID_ARM_RIJNDAEL_BIT;
-                if (run_cpu_instruction_probe(pmull_probe) == 1)
-                    detected_features |= cpuid::CPUID_ARM_PMULL_BIT;
-                if (run_cpu_instruction_probe(sha1_probe) == 1)
-                    detected_features |= cpuid::CPUID_ARM_SHA1_BIT;
-                if (run_cpu_instruction_probe(sha2_probe) == 1)
-                    detected_features |= cpuid::CPUID_ARM_SHA2_BIT;
-            }
+            (void)cache_line_size;
 
 #endif
 
@@ -212,3 +184,5 @@ namespace nil {
 #endif
     }    // namespace crypto3
 }    // namespace nil
+
+#endif
@@ -1,18 +1,22 @@
-#include <nil/crypto3/utilities/cpuid/cpuid.hpp>
-#include <nil/crypto3/utilities/os_utils.hpp>
+#ifndef CRYPTO3_CPUID_PPC_HPP
+#define CRYPTO3_CPUID_PPC_HPP
 
-#if defined(BOOST_ARCH_PPC)
+#include <boost/predef/os.h>
+
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#if BOOST_ARCH_PPC
 
 /*
  * On Darwin and OpenBSD ppc, use sysctl to detect AltiVec
  */
-#if defined(CRYPTO3_TARGET_OS_IS_DARWIN)
+#if BOOST_OS_MACOS
 #include <sys/sysctl.h>
-#elif defined(CRYPTO3_TARGET_OS_IS_OPENBSD)
+#elif BOOST_OS_BSD_OPEN
 #include <sys/param.h>
 #include <sys/sysctl.h>
 #include <machine/cpu.h>
-#elif defined(CRYPTO3_TARGET_OS_HAS_GETAUXVAL)
+#elif BOOST_OS_LINUX
 #include <sys/auxv.h>
 #endif
 
@@ -21,20 +25,20 @@
 namespace nil {
     namespace crypto3 {
 
-#if defined(BOOST_ARCH_PPC)
+#if BOOST_ARCH_PPC
 
         /*
          * PowerPC specific block: check for AltiVec using either
-         * sysctl or by reading processor version number register.
+         * sysctl or the auxiliary vector.
          */
-        uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
-            CRYPTO3_UNUSED(cache_line_size);
+        inline uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
+            (void)cache_line_size;
 
-#if defined(CRYPTO3_TARGET_OS_IS_DARWIN) || defined(CRYPTO3_TARGET_OS_IS_OPENBSD)
+#if BOOST_OS_MACOS || BOOST_OS_BSD_OPEN
             // On Darwin/OS X and OpenBSD, use sysctl
 
             int sels[2] = {
-#if defined(CRYPTO3_TARGET_OS_IS_OPENBSD)
+#if BOOST_OS_BSD_OPEN
                 CTL_MACHDEP,
                 CPU_ALTIVEC
 #else
@@ -50,7 +54,7 @@ namespace nil {
             if (error == 0 && vector_type > 0)
                 return cpuid::CPUID_ALTIVEC_BIT;
 
-#elif defined(CRYPTO3_TARGET_OS_HAS_GETAUXVAL) && defined(CRYPTO3_TARGET_ARCHITECTURE_IS_PPC64)
+#elif BOOST_OS_LINUX
 
             enum PPC_hwcap_bit {
                 ALTIVEC_bit = (1 << 28),
@@ -72,51 +76,19 @@ namespace nil {
 
             return detected_features;
 
-#else
+#endif
 
             /*
-            On PowerPC, MSR 287 is PVR, the Processor Version Number
-            Normally it is only accessible to ring 0, but Linux and NetBSD
-            (others, too, maybe?) will trap and emulate it for us.
+            Elsewhere the processor version register could be read, but
+            only the kernel may do so and it has to trap the instruction,
+            which needs a SIGILL handler a header-only library has no
+            business installing.
             */
-
-            int pvr = run_cpu_instruction_probe([]() -> int {
-                uint32_t pvr = 0;
-                asm volatile("mfspr %0, 287" : "=r"(pvr));
-                // Top 16 bits suffice to identify the model
-                return static_cast<int>(pvr >> 16);
-            });
-
-            if (pvr > 0) {
-                const uint16_t ALTIVEC_PVR[] = {
-                    0x003E,    // IBM POWER6
-                    0x003F,    // IBM POWER7
-                    0x004A,    // IBM POWER7p
-                    0x004D,    // IBM POWER8
-                    0x004B,    // IBM POWER8E
-                    0x000C,    // G4-7400
-                    0x0039,    // G5 970
-                    0x003C,    // G5 970FX
-                    0x0044,    // G5 970MP
-                    0x0070,    // Cell PPU
-                    0,         // end
-                };
-
-                for (size_t i = 0; ALTIVEC_PVR[i]; ++i) {
-                    if (pvr == ALTIVEC_PVR[i])
-                        return cpuid::CPUID_ALTIVEC_BIT;
-                }
-
-                return 0;
-            }
-
-            // TODO try direct instruction probing
-
-#endif
-
             return 0;
         }
 
 #endif
     }    // namespace crypto3
 }    // namespace nil
+
+#endif
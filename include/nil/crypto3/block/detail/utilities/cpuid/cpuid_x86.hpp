@@ -1,14 +1,22 @@
-#include <nil/crypto3/utilities/cpuid/cpuid.hpp>
-#include <nil/crypto3/utilities/memory_operations.hpp>
-#include <nil/crypto3/utilities/loadstore.hpp>
+#ifndef CRYPTO3_CPUID_X86_HPP
+#define CRYPTO3_CPUID_X86_HPP
 
-#if defined(BOOST_ARCH_X86)
+#include <climits>
+#include <cstring>
 
-#if defined(CRYPTO3_BUILD_COMPILER_IS_MSVC)
+#include <boost/predef/compiler.h>
+
+#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+
+#include <nil/crypto3/detail/make_uint_t.hpp>
+
+#if BOOST_ARCH_X86
+
+#if BOOST_COMP_MSVC
 #include <intrin.h>
-#elif defined(CRYPTO3_BUILD_COMPILER_IS_INTEL)
+#elif BOOST_COMP_INTEL
 #include <ia32intrin.h>
-#elif defined(CRYPTO3_BUILD_COMPILER_IS_GCC) || defined(CRYPTO3_BUILD_COMPILER_IS_CLANG)
+#elif BOOST_COMP_GNUC || BOOST_COMP_CLANG
 #include <cpuid.h>
 #endif
 
@@ -17,10 +25,10 @@
 namespace nil {
     namespace crypto3 {
 
-#if defined(BOOST_ARCH_X86)
+#if BOOST_ARCH_X86
 
-        uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
-#if defined(CRYPTO3_BUILD_COMPILER_IS_MSVC)
+        inline uint64_t cpuid::detect_cpu_features(size_t *cache_line_size) {
+#if BOOST_COMP_MSVC
 #define X86_CPUID(type, out)       \
     do {                           \
         __cpuid((int *)out, type); \
@@ -30,7 +38,7 @@ namespace nil {
         __cpuidex((int *)out, type, level);  \
     } while (0)
 
-#elif defined(CRYPTO3_BUILD_COMPILER_IS_INTEL)
+#elif BOOST_COMP_INTEL
 #define X86_CPUID(type, out) \
     do {                     \
         __cpuid(out, type);  \
@@ -40,13 +48,13 @@ namespace nil {
         __cpuidex((int *)out, type, level);  \
     } while (0)
 
-#elif defined(CRYPTO3_TARGET_ARCHITECTURE_IS_X86_64) && defined(CRYPTO3_USE_GCC_INLINE_ASM)
+#elif BOOST_ARCH_X86_64 && defined(CRYPTO3_USE_GCC_INLINE_ASM)
 #define X86_CPUID(type, out) asm("cpuid\n\t" : "=a"(out[0]), "=b"(out[1]), "=c"(out[2]), "=d"(out[3]) : "0"(type))
 
 #define X86_CPUID_SUBLEVEL(type, level, out) \
     asm("cpuid\n\t" : "=a"(out[0]), "=b"(out[1]), "=c"(out[2]), "=d"(out[3]) : "0"(type), "2"(level))
 
-#elif defined(CRYPTO3_BUILD_COMPILER_IS_GCC) || defined(CRYPTO3_BUILD_COMPILER_IS_CLANG)
+#elif BOOST_COMP_GNUC || BOOST_COMP_CLANG
 #define X86_CPUID(type, out)                               \
     do {                                                   \
         __get_cpuid(type, out, out + 1, out + 2, out + 3); \
@@ -60,17 +68,20 @@ namespace nil {
 #warning "No way of calling x86 cpuid instruction for this compiler"
 #define X86_CPUID(type, out) \
     do {                     \
-        clear_mem(out, 4);   \
+        std::memset(out, 0, 4 * sizeof(uint32_t)); \
     } while (0)
 #define X86_CPUID_SUBLEVEL(type, level, out) \
     do {                                     \
-        clear_mem(out, 4);                   \
+        std::memset(out, 0, 4 * sizeof(uint32_t)); \
     } while (0)
 #endif
 
             uint64_t features_detected = 0;
             uint32_t cpuid[4] = {0};
 
+            // Register state the OS saves on context switch, wide vector units are unusable without it
+            uint64_t xcr0 = 0;
+
             // cpuid 0: vendor identification, max sublevel
             X86_CPUID(0, cpuid);
 
@@ -78,8 +89,8 @@ namespace nil {
 
             const uint32_t INTEL_CPUID[3] = {0x756E6547, 0x6C65746E, 0x49656E69};
             const uint32_t AMD_CPUID[3] = {0x68747541, 0x444D4163, 0x69746E65};
-            const bool is_intel = same_mem(cpuid + 1, INTEL_CPUID, 3);
-            const bool is_amd = same_mem(cpuid + 1, AMD_CPUID, 3);
+            const bool is_intel = std::memcmp(cpuid + 1, INTEL_CPUID, sizeof(INTEL_CPUID)) == 0;
+            const bool is_amd = std::memcmp(cpuid + 1, AMD_CPUID, sizeof(AMD_CPUID)) == 0;
 
             if (max_supported_sublevel >= 1) {
                 // cpuid 1: feature bits
@@ -94,6 +105,7 @@ namespace nil {
                     SSE41 = (1ULL << 51),
                     SSE42 = (1ULL << 52),
                     AESNI = (1ULL << 57),
+                    OSXSAVE = (1ULL << 59),
                     RDRAND = (1ULL << 62)
                 };
 
@@ -113,19 +125,29 @@ namespace nil {
                     features_detected |= cpuid::CPUID_AESNI_BIT;
                 if (flags0 & x86_CPUID_1_bits::RDRAND)
                     features_detected |= cpuid::CPUID_RDRAND_BIT;
+
+                if (flags0 & x86_CPUID_1_bits::OSXSAVE) {
+#if BOOST_COMP_MSVC || BOOST_COMP_INTEL
+                    xcr0 = _xgetbv(0);
+#elif BOOST_COMP_GNUC || BOOST_COMP_CLANG
+                    uint32_t xcr0_lo = 0, xcr0_hi = 0;
+                    asm volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+                    xcr0 = (static_cast<uint64_t>(xcr0_hi) << 32) | xcr0_lo;
+#endif
+                }
             }
 
             if (is_intel) {
                 // Intel cache line size is in cpuid(1) output
-                *cache_line_size = 8 * extract_uint_t<CHAR_BIT>(cpuid[1], 2);
+                *cache_line_size = 8 * ::nil::crypto3::detail::extract_uint_t<CHAR_BIT>(cpuid[1], 2);
             } else if (is_amd) {
                 // AMD puts it in vendor zone
                 X86_CPUID(0x80000005, cpuid);
-                *cache_line_size = extract_uint_t<CHAR_BIT>(cpuid[2], 3);
+                *cache_line_size = ::nil::crypto3::detail::extract_uint_t<CHAR_BIT>(cpuid[2], 3);
             }
 
             if (max_supported_sublevel >= 7) {
-                clear_mem(cpuid, 4);
+                std::memset(cpuid, 0, sizeof(cpuid));
                 X86_CPUID_SUBLEVEL(7, 0, cpuid);
 
                 enum x86_CPUID_7_bits : uint64_t {
@@ -135,14 +157,20 @@ namespace nil {
                     RDSEED = (1ULL << 18),
                     ADX = (1ULL << 19),
                     SHA = (1ULL << 29),
+                    VAES = (1ULL << 41),
+                    VPCLMULQDQ = (1ULL << 42),
                 };
+
+                // SSE, AVX and AVX-512 (opmask, upper zmm halves, zmm16-31) state enabled by the OS
+                const bool os_ymm = (xcr0 & 0x06) == 0x06;
+                const bool os_zmm = (xcr0 & 0xE6) == 0xE6;
                 uint64_t flags7 = (static_cast<uint64_t>(cpuid[2]) << 32) | cpuid[1];
 
-                if (flags7 & x86_CPUID_7_bits::AVX2)
+                if ((flags7 & x86_CPUID_7_bits::AVX2) && os_ymm)
                     features_detected |= cpuid::CPUID_AVX2_BIT;
                 if (flags7 & x86_CPUID_7_bits::BMI2)
                     features_detected |= cpuid::CPUID_BMI2_BIT;
-                if (flags7 & x86_CPUID_7_bits::AVX512F)
+                if ((flags7 & x86_CPUID_7_bits::AVX512F) && os_zmm)
                     features_detected |= cpuid::CPUID_AVX512F_BIT;
                 if (flags7 & x86_CPUID_7_bits::RDSEED)
                     features_detected |= cpuid::CPUID_RDSEED_BIT;
@@ -150,6 +178,10 @@ namespace nil {
                     features_detected |= cpuid::CPUID_ADX_BIT;
                 if (flags7 & x86_CPUID_7_bits::SHA)
                     features_detected |= cpuid::CPUID_SHA_BIT;
+                if ((flags7 & x86_CPUID_7_bits::VAES) && os_ymm)
+                    features_detected |= cpuid::CPUID_VAES_BIT;
+                if ((flags7 & x86_CPUID_7_bits::VPCLMULQDQ) && os_ymm)
+                    features_detected |= cpuid::CPUID_VPCLMULQDQ_BIT;
             }
 
 #undef X86_CPUID
@@ -159,7 +191,7 @@ namespace nil {
              * If we don't have access to cpuid, we can still safely assume that
              * any x86-64 processor has SSE2 and RDTSC
              */
-#if defined(CRYPTO3_TARGET_ARCHITECTURE_IS_X86_64)
+#if BOOST_ARCH_X86_64
             if (features_detected == 0) {
                 features_detected |= cpuid::CPUID_SSE2_BIT;
                 features_detected |= cpuid::CPUID_RDTSC_BIT;
@@ -172,3 +204,5 @@ namespace nil {
 #endif
     }    // namespace crypto3
 }    // namespace nil
+
+#endif    // CRYPTO3_CPUID_X86_HPP
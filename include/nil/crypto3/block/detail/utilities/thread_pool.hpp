@@ -0,0 +1,204 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file Fixed size thread pool for data parallel cipher passes
+//
+// @brief Workers are started once and sleep between jobs. A job is an index
+// range handed out one index at a time, with the calling thread taking part,
+// so uneven chunks balance themselves out.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_THREAD_POOL_HPP
+#define CRYPTO3_BLOCK_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @brief Thread pool running parallel_for jobs.
+             *
+             * Jobs from different threads are run one after another. Job functions
+             * must not throw. A job function may call parallel_for on the same pool,
+             * the nested job then runs inline on the calling thread.
+             */
+            class thread_pool {
+            public:
+                /*!
+                 * @param threads Amount of threads working on a job, including the calling one.
+                 * Zero uses every hardware thread.
+                 */
+                explicit thread_pool(std::size_t threads = 0) :
+                    job(nullptr), job_size(0), next(0), active(0), generation(0), stopping(false) {
+                    if (threads == 0) {
+                        threads = std::thread::hardware_concurrency();
+                    }
+                    for (std::size_t i = 1; i < threads; ++i) {
+                        workers.emplace_back(&thread_pool::work, this);
+                    }
+                }
+
+                ~thread_pool() {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stopping = true;
+                    }
+                    wake.notify_all();
+                    for (std::thread &worker : workers) {
+                        worker.join();
+                    }
+                }
+
+                thread_pool(const thread_pool &) = delete;
+                thread_pool &operator=(const thread_pool &) = delete;
+
+                /*!
+                 * @return Amount of threads working on a job, including the calling one
+                 */
+                inline std::size_t size() const {
+                    return workers.size() + 1;
+                }
+
+                /*!
+                 * @brief Calls f(i) for every i in [0, count) and returns once all calls are done.
+                 */
+                void parallel_for(std::size_t count, const std::function<void(std::size_t)> &f) {
+                    // Workers of a nested job would wait for the outer one holding them
+                    if (workers.empty() || count < 2 || running_scope::inside(this)) {
+                        for (std::size_t i = 0; i != count; ++i) {
+                            f(i);
+                        }
+                        return;
+                    }
+
+                    std::lock_guard<std::mutex> submit_lock(submit);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        job = &f;
+                        job_size = count;
+                        next = 0;
+                        active = workers.size();
+                        ++generation;
+                    }
+                    wake.notify_all();
+
+                    {
+                        running_scope scope(this);
+                        drain(f, count);
+                    }
+
+                    std::unique_lock<std::mutex> lock(mutex);
+                    done.wait(lock, [this] { return active == 0; });
+                    job = nullptr;
+                }
+
+            protected:
+                // Pools the current thread runs a job for, innermost first
+                struct running_scope {
+                    explicit running_scope(const thread_pool *pool) : pool(pool), outer(innermost()) {
+                        innermost() = this;
+                    }
+
+                    ~running_scope() {
+                        innermost() = outer;
+                    }
+
+                    static bool inside(const thread_pool *pool) {
+                        for (const running_scope *scope = innermost(); scope != nullptr; scope = scope->outer) {
+                            if (scope->pool == pool) {
+                                return true;
+                            }
+                        }
+                        return false;
+                    }
+
+                    static const running_scope *&innermost() {
+                        static thread_local const running_scope *scope = nullptr;
+                        return scope;
+                    }
+
+                    const thread_pool *pool;
+                    const running_scope *outer;
+                };
+
+                inline void drain(const std::function<void(std::size_t)> &f, std::size_t count) {
+                    for (std::size_t i = next++; i < count; i = next++) {
+                        f(i);
+                    }
+                }
+
+                void work() {
+                    std::size_t seen = 0;
+                    for (;;) {
+                        const std::function<void(std::size_t)> *f;
+                        std::size_t count;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+                            if (stopping) {
+                                return;
+                            }
+                            seen = generation;
+                            f = job;
+                            count = job_size;
+                        }
+
+                        {
+                            running_scope scope(this);
+                            drain(*f, count);
+                        }
+
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (--active == 0) {
+                            done.notify_one();
+                        }
+                    }
+                }
+
+                std::vector<std::thread> workers;
+
+                std::mutex submit;
+                std::mutex mutex;
+                std::condition_variable wake;
+                std::condition_variable done;
+
+                const std::function<void(std::size_t)> *job;
+                std::size_t job_size;
+                std::atomic<std::size_t> next;
+                std::size_t active;
+                std::size_t generation;
+                bool stopping;
+            };
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_THREAD_POOL_HPP
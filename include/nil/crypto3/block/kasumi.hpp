@@ -93,6 +93,20 @@ namespace nil {
                     return decrypt_block(ciphertext, key_schedule);
                 }
 
+                inline void encrypt_blocks(const block_type *plaintext, block_type *ciphertext,
+                                           std::size_t blocks) const {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        ciphertext[i] = encrypt(plaintext[i]);
+                    }
+                }
+
+                inline void decrypt_blocks(const block_type *ciphertext, block_type *plaintext,
+                                           std::size_t blocks) const {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        plaintext[i] = decrypt(ciphertext[i]);
+                    }
+                }
+
             protected:
                 inline block_type encrypt_block(const block_type &plaintext,
                                                 const key_schedule_type &key_schedule) const {
@@ -0,0 +1,298 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file Keystream-ahead buffer for stream modes
+//
+// @brief Generates the keystream of a CTR or OFB mode into a ring buffer
+// before the data arrives, so processing a packet only XORs it with bytes
+// computed earlier. Refills run on a worker thread owned by the buffer or
+// wherever the owner calls refill, e.g. from an idle loop.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_KEYSTREAM_BUFFER_HPP
+#define CRYPTO3_BLOCK_KEYSTREAM_BUFFER_HPP
+
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @brief Ways of refilling a keystream_buffer.
+             */
+            struct keystream_refill {
+                enum type {
+                    /// Only explicit refill calls generate keystream ahead
+                    manual,
+                    /// A worker thread owned by the buffer refills it below the low watermark
+                    background
+                };
+            };
+
+            /*!
+             * @brief Keystream-ahead buffer over a bound CTR or OFB mode.
+             *
+             * @ingroup block
+             *
+             * The buffer keeps its own copy of the mode and continues its keystream from the
+             * first block on, so the whole message goes through process in order. Keystream is
+             * generated in whole blocks into a ring of depth blocks. Whenever less than the low
+             * watermark is buffered a refill tops the ring up to the high watermark. A packet
+             * larger than what is buffered does not wait for the refill, the missing keystream is
+             * generated on the spot.
+             *
+             * process is called from one thread at a time. The buffer may be refilled meanwhile by
+             * its worker thread with keystream_refill::background, or by one other thread calling
+             * refill with keystream_refill::manual.
+             *
+             * @tparam Mode Mode bound to its policy, e.g. modes::counter or modes::ofb
+             */
+            template<typename Mode>
+            class keystream_buffer {
+            public:
+                typedef Mode mode_type;
+
+                typedef typename mode_type::block_type block_type;
+
+                constexpr static const std::size_t block_bits = mode_type::block_bits;
+                constexpr static const std::size_t block_bytes = block_bits / CHAR_BIT;
+
+                BOOST_STATIC_ASSERT(sizeof(block_type) == block_bytes);
+
+                /*!
+                 * @brief Blocks generated between two points where the consumer may pick them up.
+                 */
+                constexpr static const std::size_t refill_batch_blocks = 64;
+
+                /*!
+                 * @param mode Freshly bound mode the keystream is taken from
+                 * @param depth Ring size in blocks
+                 * @param low_watermark Buffered blocks below which a refill starts, less than depth so that
+                 * a refill always finds a free block
+                 * @param high_watermark Buffered blocks a refill stops at, at most depth
+                 * @param refill Who refills the buffer. The ring is filled up to the high watermark
+                 * on construction in any case.
+                 */
+                keystream_buffer(const mode_type &mode, std::size_t depth, std::size_t low_watermark,
+                                 std::size_t high_watermark,
+                                 keystream_refill::type refill = keystream_refill::background) :
+                    mode(mode),
+                    ring(depth), ring_bytes(depth * block_bytes), low_watermark(low_watermark * block_bytes),
+                    high_watermark(high_watermark * block_bytes), policy(refill), produced(0), consumed(0),
+                    stopping(false) {
+                    BOOST_ASSERT(depth != 0);
+                    BOOST_ASSERT(low_watermark < depth && low_watermark <= high_watermark && high_watermark <= depth);
+
+                    fill(this->high_watermark);
+                    if (policy == keystream_refill::background) {
+                        worker = std::thread(&keystream_buffer::work, this);
+                    }
+                }
+
+                /*!
+                 * @brief Refills at half the depth up to the full depth.
+                 */
+                keystream_buffer(const mode_type &mode, std::size_t depth,
+                                 keystream_refill::type refill = keystream_refill::background) :
+                    keystream_buffer(mode, depth, depth / 2, depth, refill) {
+                }
+
+                ~keystream_buffer() {
+                    if (worker.joinable()) {
+                        {
+                            std::lock_guard<std::mutex> lock(wake_mutex);
+                            stopping = true;
+                        }
+                        wake.notify_one();
+                        worker.join();
+                    }
+                    for (block_type &block : ring) {
+                        block.fill(0);
+                    }
+                }
+
+                keystream_buffer(const keystream_buffer &) = delete;
+                keystream_buffer &operator=(const keystream_buffer &) = delete;
+
+                /*!
+                 * @brief Encrypts or decrypts the next part of the message.
+                 * @param out Output, may be the same as in
+                 */
+                void process(const std::uint8_t *in, std::uint8_t *out, std::size_t size) {
+                    const std::uint8_t *stream = reinterpret_cast<const std::uint8_t *>(ring.data());
+                    std::uint64_t position = consumed.load(std::memory_order_relaxed);
+
+                    while (size != 0) {
+                        const std::uint64_t available = produced.load(std::memory_order_acquire) - position;
+                        if (available == 0) {
+                            // The refill is behind, generate what this call still needs right away
+                            fill(size < ring_bytes ? size : ring_bytes);
+                            continue;
+                        }
+
+                        const std::size_t offset = static_cast<std::size_t>(position % ring_bytes);
+                        std::size_t n = size < available ? size : static_cast<std::size_t>(available);
+                        n = n < ring_bytes - offset ? n : ring_bytes - offset;
+
+                        xor_bytes(in, stream + offset, out, n);
+
+                        position += n;
+                        consumed.store(position, std::memory_order_release);
+                        in += n;
+                        out += n;
+                        size -= n;
+                    }
+
+                    if (policy == keystream_refill::background && buffered() < low_watermark) {
+                        std::lock_guard<std::mutex> lock(wake_mutex);
+                        wake.notify_one();
+                    }
+                }
+
+                /*!
+                 * @brief Tops the buffer up to the high watermark if it is below the low one. Meant
+                 * for idle time with keystream_refill::manual.
+                 */
+                void refill() {
+                    if (buffered() < low_watermark) {
+                        fill(high_watermark);
+                    }
+                }
+
+                /*!
+                 * @return Amount of keystream bytes buffered ahead
+                 */
+                inline std::size_t available() const {
+                    return static_cast<std::size_t>(buffered());
+                }
+
+            protected:
+                inline std::uint64_t buffered() const {
+                    return produced.load(std::memory_order_acquire) - consumed.load(std::memory_order_acquire);
+                }
+
+                // 64 bits at a time, which compilers widen to vector registers
+                static void xor_bytes(const std::uint8_t *a, const std::uint8_t *b, std::uint8_t *out,
+                                      std::size_t size) {
+                    std::size_t i = 0;
+                    for (; size - i >= sizeof(std::uint64_t); i += sizeof(std::uint64_t)) {
+                        std::uint64_t x, y;
+                        std::memcpy(&x, a + i, sizeof(x));
+                        std::memcpy(&y, b + i, sizeof(y));
+                        x ^= y;
+                        std::memcpy(out + i, &x, sizeof(x));
+                    }
+                    for (; i != size; ++i) {
+                        out[i] = a[i] ^ b[i];
+                    }
+                }
+
+                /*
+                 * Generates keystream until target bytes are buffered or the ring is full. The lock is
+                 * taken per batch, so the consumer gets at fresh keystream or generates its own share
+                 * without waiting for a whole refill.
+                 */
+                void fill(std::uint64_t target) {
+                    for (;;) {
+                        std::lock_guard<std::mutex> lock(generator);
+
+                        // A block is free once every byte of it has been consumed
+                        const std::uint64_t tail = consumed.load(std::memory_order_acquire);
+                        std::uint64_t head = produced.load(std::memory_order_relaxed) / block_bytes;
+                        if (head * block_bytes - tail >= target) {
+                            return;
+                        }
+
+                        std::uint64_t blocks = (target - (head * block_bytes - tail) + block_bytes - 1) / block_bytes;
+                        const std::uint64_t room = tail / block_bytes + ring.size() - head;
+                        blocks = blocks < room ? blocks : room;
+                        blocks = blocks < refill_batch_blocks ? blocks : refill_batch_blocks;
+                        if (blocks == 0) {
+                            return;
+                        }
+
+                        // Keystream is the mode applied to zeros, contiguous runs at a time
+                        for (std::uint64_t left = blocks; left != 0;) {
+                            const std::size_t position = static_cast<std::size_t>(head % ring.size());
+                            const std::size_t run = left < ring.size() - position ? static_cast<std::size_t>(left) :
+                                                                                     ring.size() - position;
+                            block_type *stream = ring.data() + position;
+                            for (std::size_t i = 0; i != run; ++i) {
+                                stream[i].fill(0);
+                            }
+                            // Bits seen so far include the first block processed
+                            mode.process_blocks(stream, stream, run, static_cast<std::size_t>(head + 1) * block_bits);
+                            head += run;
+                            left -= run;
+                        }
+
+                        produced.store(head * block_bytes, std::memory_order_release);
+                    }
+                }
+
+                void work() {
+                    for (;;) {
+                        {
+                            std::unique_lock<std::mutex> lock(wake_mutex);
+                            wake.wait(lock, [this] { return stopping || buffered() < low_watermark; });
+                            if (stopping) {
+                                return;
+                            }
+                        }
+                        fill(high_watermark);
+                    }
+                }
+
+                // Only used under the generator lock
+                mode_type mode;
+                std::vector<block_type> ring;
+                const std::size_t ring_bytes;
+                const std::uint64_t low_watermark, high_watermark;
+                const keystream_refill::type policy;
+
+                // Bytes of keystream generated and consumed since the start of the message
+                std::atomic<std::uint64_t> produced, consumed;
+
+                std::mutex generator;
+                std::mutex wake_mutex;
+                std::condition_variable wake;
+                bool stopping;
+                std::thread worker;
+            };
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_KEYSTREAM_BUFFER_HPP
@@ -32,27 +32,8 @@
 #include <nil/crypto3/block/detail/cipher_modes.hpp>
 
 #include <nil/crypto3/block/detail/rijndael/rijndael_policy.hpp>
-#include <nil/crypto3/block/detail/rijndael/rijndael_impl.hpp>
-
-#if defined(CRYPTO3_HAS_RIJNDAEL_NI)
-
-#include <nil/crypto3/block/detail/rijndael/rijndael_ni_impl.hpp>
-
-#elif defined(CRYPTO3_HAS_RIJNDAEL_SSSE3) || BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSSE3_VERSION
-
-#include <nil/crypto3/block/detail/rijndael/rijndael_ssse3_impl.hpp>
-
-#elif defined(CRYPTO3_HAS_RIJNDAEL_ARMV8)
-
-#include <nil/crypto3/block/detail/rijndael/rijndael_armv8_impl.hpp>
-
-#elif defined(CRYPTO3_HAS_RIJNDAEL_POWER8)
-
-#include <nil/crypto3/block/detail/rijndael/rijndael_power8_impl.hpp>
-
-#endif
-
-#include <nil/crypto3/block/detail/utilities/cpuid/cpuid.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_dispatch.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_modes.hpp>
 
 namespace nil {
     namespace crypto3 {
@@ -76,26 +57,34 @@ namespace nil {
              * systems with SSSE3 but without AES-NI, crypto3 has an implementation which avoids
              * known side channels.
              *
-             * This implementation is intended to be based on table lookups which
+             * The portable implementation is based on table lookups which
              * are known to be vulnerable to timing and cache based side channel
              * attacks. Some countermeasures are used which may be helpful in some
              * situations:
              *
-             * - Only a single 256-word T-table is used, with rotations applied.
-             *   Most implementations use 4 T-tables which leaks much more
+             * - Only a single 256-word T-table per direction is used, with rotations
+             *   applied. Most implementations use 4 T-tables which leaks much more
              *   information via cache usage.
              *
-             * - The TE and TD tables are computed at runtime to avoid flush+reload
-             *   attacks using clflush. As different processes will not share the
-             *   same underlying table data, an attacker can't manipulate another
-             *   processes cache lines via their shared reference to the library
-             *   read only segment.
-             *
              * - Each cache line of the lookup tables is accessed at the beginning
-             *   of each call to encrypt or decrypt. (See the Z variable below)
+             *   of each call to encrypt or decrypt.
+             *
+             * The TE and TD tables are generated at compile time and live in the
+             * read only segment, so they are shared between processes using the
+             * library and offer no protection against flush+reload attacks.
              *
              * If available SSSE3 or AES-NI are used instead of this version, as both
-             * are faster and immune to side channel attacks.
+             * are faster and immune to side channel attacks. On x86 the choice is made
+             * at runtime from the host CPU features, see rijndael_backend.
+             *
+             * Without any of those, AES on 64-bit hosts uses a bitsliced constant-time
+             * implementation which processes four to eight blocks at once.
+             *
+             * Block and key sizes other than AES are served by AES-NI as well, with
+             * the wider ShiftRows emulated by byte shuffles across two registers.
+             *
+             * Where only one direction is used, rijndael_encryptor and rijndael_decryptor
+             * hold a single key schedule and are cheaper to set up.
              *
              * Some AES cache timing papers for reference:
              *
@@ -120,20 +109,7 @@ namespace nil {
                 constexpr static const std::size_t version = KeyBits;
                 typedef detail::rijndael_policy<KeyBits, BlockBits> policy_type;
 
-                typedef
-                    typename std::conditional<BlockBits == 128 && (KeyBits == 128 || KeyBits == 192 || KeyBits == 256),
-#if defined(CRYPTO3_HAS_RIJNDAEL_NI)
-                                              detail::rijndael_ni_impl<KeyBits, BlockBits, policy_type>,
-#elif defined(CRYPTO3_HAS_RIJNDAEL_SSSE3) || BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSSE3_VERSION
-                                              detail::rijndael_ssse3_impl<KeyBits, BlockBits, policy_type>,
-#elif defined(CRYPTO3_HAS_RIJNDAEL_ARMV8)
-                                              detail::rijndael_armv8_impl<KeyBits, BlockBits, policy_type>,
-#elif defined(CRYPTO3_HAS_RIJNDAEL_POWER8)
-                                              detail::rijndael_power8_impl<KeyBits, BlockBits, policy_type>,
-#else
-                                              detail::rijndael_impl<KeyBits, BlockBits, policy_type>,
-#endif
-                                              detail::rijndael_impl<KeyBits, BlockBits, policy_type>>::type impl_type;
+                typedef detail::rijndael_dispatch<KeyBits, BlockBits, policy_type> dispatch_type;
 
                 constexpr static const std::size_t key_schedule_words = policy_type::key_schedule_words;
                 constexpr static const std::size_t key_schedule_bytes = policy_type::key_schedule_bytes;
@@ -168,8 +144,10 @@ namespace nil {
 
                 typedef typename stream_endian::little_octet_big_bit endian_type;
 
-                rijndael(const key_type &key) : encryption_key({0}), decryption_key({0}) {
-                    impl_type::schedule_key(key, encryption_key, decryption_key);
+                rijndael(const key_type &key) :
+                    impl(&dispatch_type::resolve(rijndael_backend::active())), encryption_key({0}),
+                    decryption_key({0}) {
+                    impl->schedule_key(key, encryption_key, decryption_key);
                 }
 
                 virtual ~rijndael() {
@@ -178,16 +156,226 @@ namespace nil {
                 }
 
                 inline block_type encrypt(const block_type &plaintext) const {
-                    return impl_type::encrypt_block(plaintext, encryption_key);
+                    return impl->encrypt_block(plaintext, encryption_key);
                 }
 
                 inline block_type decrypt(const block_type &plaintext) const {
-                    return impl_type::decrypt_block(plaintext, decryption_key);
+                    return impl->decrypt_block(plaintext, decryption_key);
+                }
+
+                /*!
+                 * @brief Encrypts the block iterations times, feeding each ciphertext back as the
+                 * next plaintext. Hardware backends keep the key schedule and the state in registers
+                 * for the whole chain, which is much faster than calling encrypt in a loop.
+                 * @param plaintext Initial block
+                 * @param iterations Amount of encryptions, zero returns the block unchanged
+                 */
+                inline block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations) const {
+                    return impl->encrypt_iterated(plaintext, iterations, encryption_key);
+                }
+
+                /*!
+                 * @brief Encrypts contiguous sequence of blocks. Hardware-accelerated
+                 * backends process several blocks at once, so this is considerably
+                 * faster than calling encrypt for each block.
+                 * @param plaintext Input blocks
+                 * @param ciphertext Output blocks, may be the same as plaintext
+                 * @param blocks Amount of blocks to encrypt
+                 */
+                inline void encrypt_blocks(const block_type *plaintext, block_type *ciphertext,
+                                           std::size_t blocks) const {
+                    impl->encrypt_blocks(plaintext, ciphertext, blocks, encryption_key);
+                }
+
+                /*!
+                 * @brief Decrypts contiguous sequence of blocks.
+                 * @param ciphertext Input blocks
+                 * @param plaintext Output blocks, may be the same as ciphertext
+                 * @param blocks Amount of blocks to decrypt
+                 */
+                inline void decrypt_blocks(const block_type *ciphertext, block_type *plaintext,
+                                           std::size_t blocks) const {
+                    impl->decrypt_blocks(ciphertext, plaintext, blocks, decryption_key);
+                }
+
+                /*!
+                 * @brief Counter mode keystream pass: XORs the input with encryptions of counter,
+                 * counter + 1, ... where the counter is a big-endian integer over the whole block.
+                 * Serves both encryption and decryption. Hardware backends generate the counter
+                 * blocks in vector registers and keep several of them in flight.
+                 * @param counter Counter block of the first input block
+                 * @param input Input blocks
+                 * @param output Output blocks, may be the same as input
+                 * @param blocks Amount of blocks to process
+                 */
+                inline void encrypt_ctr(const block_type &counter, const block_type *input, block_type *output,
+                                        std::size_t blocks) const {
+                    impl->encrypt_ctr(counter, input, output, blocks, encryption_key);
+                }
+
+                /*!
+                 * @return Backend the key of this instance was scheduled for
+                 */
+                inline rijndael_backend::type backend() const {
+                    return impl->backend;
                 }
 
             protected:
+                template<typename, typename>
+                friend struct detail::rijndael_mode_access;
+
+                const typename dispatch_type::table_type *impl;
                 key_schedule_type encryption_key, decryption_key;
             };
+
+            /*!
+             * @brief Encryption-only Rijndael.
+             *
+             * @ingroup block
+             *
+             * Keeps only the encryption key schedule, so it takes half the memory of
+             * rijndael and skips the inverse key schedule on construction. Suits modes
+             * which never run the block cipher backwards: CTR, GCM, CFB, OFB, CMAC.
+             *
+             * @tparam KeyBits Key length used in bits. Available values are: 128, 192, 256
+             * @tparam BlockBits Block length used in bits. Available values are: 128, 192, 256
+             */
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael_encryptor {
+                typedef detail::rijndael_policy<KeyBits, BlockBits> policy_type;
+
+                typedef detail::rijndael_dispatch<KeyBits, BlockBits, policy_type> dispatch_type;
+
+                typedef typename policy_type::key_schedule_type key_schedule_type;
+
+            public:
+                constexpr static const std::size_t key_bits = policy_type::key_bits;
+                typedef typename policy_type::key_type key_type;
+
+                constexpr static const std::size_t block_bits = policy_type::block_bits;
+                constexpr static const std::size_t block_words = policy_type::block_words;
+                typedef typename policy_type::block_type block_type;
+
+                constexpr static const std::uint8_t rounds = policy_type::rounds;
+
+                rijndael_encryptor(const key_type &key) :
+                    impl(&dispatch_type::resolve(rijndael_backend::active())), encryption_key({0}) {
+                    impl->schedule_keys(&key, &encryption_key, nullptr, 1);
+                }
+
+                ~rijndael_encryptor() {
+                    encryption_key.fill(0);
+                }
+
+                inline block_type encrypt(const block_type &plaintext) const {
+                    return impl->encrypt_block(plaintext, encryption_key);
+                }
+
+                /*!
+                 * @brief Encrypts the block iterations times in a row, see rijndael::encrypt_iterated.
+                 */
+                inline block_type encrypt_iterated(const block_type &plaintext, std::size_t iterations) const {
+                    return impl->encrypt_iterated(plaintext, iterations, encryption_key);
+                }
+
+                /*!
+                 * @brief Encrypts contiguous sequence of blocks, see rijndael::encrypt_blocks.
+                 */
+                inline void encrypt_blocks(const block_type *plaintext, block_type *ciphertext,
+                                           std::size_t blocks) const {
+                    impl->encrypt_blocks(plaintext, ciphertext, blocks, encryption_key);
+                }
+
+                /*!
+                 * @brief Counter mode keystream pass, see rijndael::encrypt_ctr.
+                 */
+                inline void encrypt_ctr(const block_type &counter, const block_type *input, block_type *output,
+                                        std::size_t blocks) const {
+                    impl->encrypt_ctr(counter, input, output, blocks, encryption_key);
+                }
+
+                /*!
+                 * @return Backend the key of this instance was scheduled for
+                 */
+                inline rijndael_backend::type backend() const {
+                    return impl->backend;
+                }
+
+            protected:
+                template<typename, typename>
+                friend struct detail::rijndael_mode_access;
+
+                const typename dispatch_type::table_type *impl;
+                key_schedule_type encryption_key;
+            };
+
+            /*!
+             * @brief Decryption-only Rijndael.
+             *
+             * @ingroup block
+             *
+             * Keeps only the decryption key schedule, so it takes half the memory of
+             * rijndael. The encryption schedule is still derived on construction, as
+             * the inverse one is computed from it, and wiped right away.
+             *
+             * @tparam KeyBits Key length used in bits. Available values are: 128, 192, 256
+             * @tparam BlockBits Block length used in bits. Available values are: 128, 192, 256
+             */
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael_decryptor {
+                typedef detail::rijndael_policy<KeyBits, BlockBits> policy_type;
+
+                typedef detail::rijndael_dispatch<KeyBits, BlockBits, policy_type> dispatch_type;
+
+                typedef typename policy_type::key_schedule_type key_schedule_type;
+
+            public:
+                constexpr static const std::size_t key_bits = policy_type::key_bits;
+                typedef typename policy_type::key_type key_type;
+
+                constexpr static const std::size_t block_bits = policy_type::block_bits;
+                constexpr static const std::size_t block_words = policy_type::block_words;
+                typedef typename policy_type::block_type block_type;
+
+                constexpr static const std::uint8_t rounds = policy_type::rounds;
+
+                rijndael_decryptor(const key_type &key) :
+                    impl(&dispatch_type::resolve(rijndael_backend::active())), decryption_key({0}) {
+                    key_schedule_type encryption_key = {0};
+                    impl->schedule_key(key, encryption_key, decryption_key);
+                    encryption_key.fill(0);
+                }
+
+                ~rijndael_decryptor() {
+                    decryption_key.fill(0);
+                }
+
+                inline block_type decrypt(const block_type &ciphertext) const {
+                    return impl->decrypt_block(ciphertext, decryption_key);
+                }
+
+                /*!
+                 * @brief Decrypts contiguous sequence of blocks, see rijndael::decrypt_blocks.
+                 */
+                inline void decrypt_blocks(const block_type *ciphertext, block_type *plaintext,
+                                           std::size_t blocks) const {
+                    impl->decrypt_blocks(ciphertext, plaintext, blocks, decryption_key);
+                }
+
+                /*!
+                 * @return Backend the key of this instance was scheduled for
+                 */
+                inline rijndael_backend::type backend() const {
+                    return impl->backend;
+                }
+
+            protected:
+                template<typename, typename>
+                friend struct detail::rijndael_mode_access;
+
+                const typename dispatch_type::table_type *impl;
+                key_schedule_type decryption_key;
+            };
         }    // namespace block
     }        // namespace crypto3
 }    // namespace nil
@@ -0,0 +1,449 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+// @file Multi-key Rijndael encryption engine
+//
+// @brief Keeps the encryption schedules of many keys in one contiguous table
+// and encrypts batches of blocks where every block names its own key. On
+// AES-NI the independent per-key pipelines are interleaved the same way as
+// blocks of a single key are in the bulk pass. Multi-buffer CBC encryption
+// and CMAC run many messages side by side on the same pipelines.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_BLOCK_RIJNDAEL_MULTI_KEY_HPP
+#define CRYPTO3_BLOCK_RIJNDAEL_MULTI_KEY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/static_assert.hpp>
+
+#include <nil/crypto3/block/detail/rijndael/rijndael_policy.hpp>
+#include <nil/crypto3/block/detail/rijndael/rijndael_dispatch.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace block {
+            /*!
+             * @brief Rijndael encryption under many keys at once.
+             *
+             * @ingroup block
+             *
+             * Suits workloads which encrypt a few blocks per key for a large set of
+             * keys, e.g. per-session or per-record keys. A single block under one key
+             * leaves the AES unit mostly idle waiting for the previous round, while
+             * blocks of different keys keep several rounds in flight.
+             *
+             * Only encryption schedules are kept. The backend is chosen on
+             * construction, see rijndael_backend.
+             *
+             * @tparam KeyBits Key length used in bits. Available values are: 128, 192, 256
+             * @tparam BlockBits Block length used in bits. Available values are: 128, 192, 256
+             */
+            template<std::size_t KeyBits, std::size_t BlockBits>
+            class rijndael_multi_key {
+                typedef detail::rijndael_policy<KeyBits, BlockBits> policy_type;
+
+                typedef detail::rijndael_dispatch<KeyBits, BlockBits, policy_type> dispatch_type;
+
+                typedef typename policy_type::key_schedule_type key_schedule_type;
+
+            public:
+                constexpr static const std::size_t key_bits = policy_type::key_bits;
+                typedef typename policy_type::key_type key_type;
+
+                constexpr static const std::size_t block_bits = policy_type::block_bits;
+                typedef typename policy_type::block_type block_type;
+
+                /*!
+                 * @brief Amount of CBC streams encrypt_cbc advances together, enough to cover the
+                 * aesenc latency on current x86 cores.
+                 */
+                constexpr static const std::size_t cbc_lanes = 8;
+
+                /*!
+                 * @brief Independent CBC encryption of a contiguous message.
+                 */
+                struct cbc_job {
+                    /// Key index as returned by add_key
+                    std::size_t key;
+                    /// Initialization vector, replaced by the last ciphertext block once the job is done
+                    block_type iv;
+                    const block_type *plaintext;
+                    /// May be the same as plaintext
+                    block_type *ciphertext;
+                    std::size_t blocks;
+                };
+
+                /*!
+                 * @brief CMAC (SP 800-38B) of a contiguous message.
+                 */
+                struct cmac_job {
+                    /// Key index as returned by add_key
+                    std::size_t key;
+                    const std::uint8_t *message;
+                    /// Message length in bytes
+                    std::size_t size;
+                    /// Full-length tag, written once the job is done
+                    block_type tag;
+                };
+
+                rijndael_multi_key() : impl(&dispatch_type::resolve(rijndael_backend::active())) {
+                }
+
+                ~rijndael_multi_key() {
+                    clear();
+                }
+
+                rijndael_multi_key(const rijndael_multi_key &) = delete;
+                rijndael_multi_key &operator=(const rijndael_multi_key &) = delete;
+
+                /*!
+                 * @brief Reserves space for the schedules of the given amount of keys.
+                 * Growing the table afterwards moves the schedules around and leaves
+                 * stale copies in freed memory, so reserve up front when that matters.
+                 */
+                void reserve(std::size_t keys) {
+                    schedules.reserve(keys);
+                    subkeys.reserve(2 * keys);
+                }
+
+                /*!
+                 * @brief Expands the key and appends it to the schedule table.
+                 * @return Index of the key to use in encrypt
+                 */
+                std::size_t add_key(const key_type &key) {
+                    return add_keys(&key, 1);
+                }
+
+                /*!
+                 * @brief Expands a batch of keys and appends them to the schedule table. Hardware
+                 * backends expand several keys in lockstep, which is cheaper than one at a time.
+                 * @return Index of the first key of the batch, the rest follow consecutively
+                 */
+                std::size_t add_keys(const key_type *keys, std::size_t count) {
+                    const std::size_t first = schedules.size();
+
+                    schedules.resize(first + count);
+                    impl->schedule_keys(keys, schedules.data() + first, nullptr, count);
+
+                    return first;
+                }
+
+                /*!
+                 * @return Amount of keys added so far
+                 */
+                inline std::size_t keys() const {
+                    return schedules.size();
+                }
+
+                /*!
+                 * @brief Wipes and drops all the key schedules.
+                 */
+                void clear() {
+                    for (key_schedule_type &schedule : schedules) {
+                        schedule.fill(0);
+                    }
+                    schedules.clear();
+                    for (block_type &subkey : subkeys) {
+                        subkey.fill(0);
+                    }
+                    subkeys.clear();
+                }
+
+                /*!
+                 * @brief Encrypts each block under its own key.
+                 * @param key_indices Key index for every block, as returned by add_key
+                 * @param plaintext Input blocks
+                 * @param ciphertext Output blocks, may be the same as plaintext
+                 * @param blocks Amount of blocks to encrypt
+                 */
+                inline void encrypt(const std::size_t *key_indices, const block_type *plaintext,
+                                    block_type *ciphertext, std::size_t blocks) const {
+                    impl->encrypt_multi_key(schedules.data(), key_indices, plaintext, ciphertext, blocks);
+                }
+
+                /*!
+                 * @brief Encrypts many independent CBC messages at once. A single CBC stream is serial,
+                 * so the streams are spread over cbc_lanes lanes advanced in lockstep with the chaining
+                 * values held in registers. Whenever a message ends its lane is handed to the next job,
+                 * which lets jobs of uneven lengths share the pipeline.
+                 * @param jobs Jobs to run, their iv fields are updated to continue the streams later
+                 * @param count Amount of jobs
+                 */
+                void encrypt_cbc(cbc_job *jobs, std::size_t count) const {
+                    cbc_job *lane_jobs[cbc_lanes];
+                    std::size_t indices[cbc_lanes], remaining[cbc_lanes];
+                    block_type chains[cbc_lanes];
+                    const block_type *in[cbc_lanes];
+                    block_type *out[cbc_lanes];
+
+                    std::size_t active = 0, next = 0;
+                    for (;;) {
+                        for (; active != cbc_lanes && next != count; ++next) {
+                            if (jobs[next].blocks != 0) {
+                                lane_jobs[active] = &jobs[next];
+                                indices[active] = jobs[next].key;
+                                remaining[active] = jobs[next].blocks;
+                                chains[active] = jobs[next].iv;
+                                in[active] = jobs[next].plaintext;
+                                out[active] = jobs[next].ciphertext;
+                                ++active;
+                            }
+                        }
+                        if (active == 0) {
+                            break;
+                        }
+
+                        // Run until the shortest job in flight ends
+                        std::size_t steps = remaining[0];
+                        for (std::size_t l = 1; l != active; ++l) {
+                            steps = remaining[l] < steps ? remaining[l] : steps;
+                        }
+
+                        impl->encrypt_cbc_multi_key(schedules.data(), indices, chains, in, out, active, steps);
+
+                        for (std::size_t l = 0; l != active; ++l) {
+                            remaining[l] -= steps;
+                            in[l] += steps;
+                            out[l] += steps;
+                        }
+
+                        // Finished lanes are filled with the last lane in flight to keep the set contiguous
+                        for (std::size_t l = 0; l != active;) {
+                            if (remaining[l] != 0) {
+                                ++l;
+                                continue;
+                            }
+                            lane_jobs[l]->iv = chains[l];
+                            if (l != --active) {
+                                lane_jobs[l] = lane_jobs[active];
+                                indices[l] = indices[active];
+                                remaining[l] = remaining[active];
+                                chains[l] = chains[active];
+                                in[l] = in[active];
+                                out[l] = out[active];
+                            }
+                        }
+                    }
+
+                    for (block_type &chain : chains) {
+                        chain.fill(0);
+                    }
+                }
+
+                /*!
+                 * @brief Computes the CMAC tags of many independent messages at once. All blocks but
+                 * the last of a message form a plain CBC-MAC chain, so the messages are spread over
+                 * cbc_lanes lanes the same way as in encrypt_cbc, one block of every message in flight
+                 * per step. The last blocks of all the messages are then enciphered together.
+                 *
+                 * The CMAC subkeys of the keys added since the previous call are derived first, one
+                 * more block per key, so engines never used for CMAC don't pay for them.
+                 * @param jobs Jobs to run, their tag fields are overwritten
+                 * @param count Amount of jobs
+                 */
+                void cmac(cmac_job *jobs, std::size_t count) {
+                    BOOST_STATIC_ASSERT(block_bits == 128);
+
+                    if (subkeys.size() != 2 * schedules.size()) {
+                        schedule_subkeys(subkeys.size() / 2, schedules.size() - subkeys.size() / 2);
+                    }
+
+                    cmac_job *lane_jobs[cbc_lanes];
+                    std::size_t indices[cbc_lanes], remaining[cbc_lanes];
+                    block_type chains[cbc_lanes];
+                    const std::uint8_t *messages[cbc_lanes];
+                    // Message blocks are copied in and enciphered in place, the chain is all that is kept
+                    block_type staged[cbc_lanes][cmac_batch_blocks];
+                    const block_type *in[cbc_lanes];
+                    block_type *out[cbc_lanes];
+                    for (std::size_t l = 0; l != cbc_lanes; ++l) {
+                        in[l] = staged[l];
+                        out[l] = staged[l];
+                    }
+
+                    std::size_t active = 0, next = 0;
+                    for (;;) {
+                        for (; active != cbc_lanes && next != count; ++next) {
+                            const std::size_t leading = jobs[next].size == 0 ? 0 : (jobs[next].size - 1) / block_bytes;
+                            jobs[next].tag.fill(0);
+                            if (leading != 0) {
+                                lane_jobs[active] = &jobs[next];
+                                indices[active] = jobs[next].key;
+                                remaining[active] = leading;
+                                chains[active].fill(0);
+                                messages[active] = jobs[next].message;
+                                ++active;
+                            }
+                        }
+                        if (active == 0) {
+                            break;
+                        }
+
+                        // Run until the shortest job in flight ends or the scratch space is used up
+                        std::size_t steps = cmac_batch_blocks;
+                        for (std::size_t l = 0; l != active; ++l) {
+                            steps = remaining[l] < steps ? remaining[l] : steps;
+                        }
+
+                        for (std::size_t l = 0; l != active; ++l) {
+                            for (std::size_t i = 0; i != steps; ++i) {
+                                std::memcpy(staged[l][i].data(), messages[l] + i * block_bytes, block_bytes);
+                            }
+                        }
+
+                        impl->encrypt_cbc_multi_key(schedules.data(), indices, chains, in, out, active, steps);
+
+                        for (std::size_t l = 0; l != active; ++l) {
+                            remaining[l] -= steps;
+                            messages[l] += steps * block_bytes;
+                        }
+
+                        for (std::size_t l = 0; l != active;) {
+                            if (remaining[l] != 0) {
+                                ++l;
+                                continue;
+                            }
+                            lane_jobs[l]->tag = chains[l];
+                            if (l != --active) {
+                                lane_jobs[l] = lane_jobs[active];
+                                indices[l] = indices[active];
+                                remaining[l] = remaining[active];
+                                chains[l] = chains[active];
+                                messages[l] = messages[active];
+                            }
+                        }
+                    }
+
+                    // A complete last block is masked with the first subkey, a padded one with the second
+                    block_type last[cmac_batch_blocks];
+                    std::size_t last_indices[cmac_batch_blocks];
+                    for (std::size_t done = 0; done != count;) {
+                        const std::size_t n = count - done < cmac_batch_blocks ? count - done : cmac_batch_blocks;
+
+                        for (std::size_t i = 0; i != n; ++i) {
+                            const cmac_job &job = jobs[done + i];
+                            const std::size_t leading = job.size == 0 ? 0 : (job.size - 1) / block_bytes;
+                            const std::size_t tail = job.size - leading * block_bytes;
+                            const std::uint8_t *message = job.message + leading * block_bytes;
+
+                            if (tail == block_bytes) {
+                                xor_block(job.tag, message, last[i]);
+                                xor_block(last[i], subkeys[2 * job.key].data(), last[i]);
+                            } else {
+                                block_type padded;
+                                padded.fill(0);
+                                std::memcpy(padded.data(), message, tail);
+                                padded[tail] = 0x80;
+                                xor_block(job.tag, padded.data(), last[i]);
+                                xor_block(last[i], subkeys[2 * job.key + 1].data(), last[i]);
+                            }
+                            last_indices[i] = job.key;
+                        }
+
+                        impl->encrypt_multi_key(schedules.data(), last_indices, last, last, n);
+
+                        for (std::size_t i = 0; i != n; ++i) {
+                            jobs[done + i].tag = last[i];
+                        }
+                        done += n;
+                    }
+
+                    for (std::size_t i = 0; i != cmac_batch_blocks; ++i) {
+                        last[i].fill(0);
+                    }
+                    for (std::size_t l = 0; l != cbc_lanes; ++l) {
+                        chains[l].fill(0);
+                        for (block_type &block : staged[l]) {
+                            block.fill(0);
+                        }
+                    }
+                }
+
+                /*!
+                 * @return Backend the keys are scheduled for
+                 */
+                inline rijndael_backend::type backend() const {
+                    return impl->backend;
+                }
+
+            protected:
+                constexpr static const std::size_t block_bytes = block_bits / 8;
+
+                // Most CBC-MAC steps per lane in one pass, the size of the staging buffers
+                constexpr static const std::size_t cmac_batch_blocks = 16;
+
+                // 64 bits at a time, out may be the same as a
+                static void xor_block(const block_type &a, const std::uint8_t *b, block_type &out) {
+                    std::uint64_t x[block_bytes / 8], y[block_bytes / 8];
+                    std::memcpy(x, a.data(), block_bytes);
+                    std::memcpy(y, b, block_bytes);
+                    for (std::size_t i = 0; i != block_bytes / 8; ++i) {
+                        x[i] ^= y[i];
+                    }
+                    std::memcpy(out.data(), x, block_bytes);
+                }
+
+                // Doubling in GF(2^128), big-endian as CMAC defines it
+                static block_type multiply_x(const block_type &block) {
+                    block_type out;
+                    for (std::size_t i = 0; i != block_bytes - 1; ++i) {
+                        out[i] = static_cast<std::uint8_t>((block[i] << 1) | (block[i + 1] >> 7));
+                    }
+                    out[block_bytes - 1] =
+                        static_cast<std::uint8_t>((block[block_bytes - 1] << 1) ^ (0x87 & -(block[0] >> 7)));
+                    return out;
+                }
+
+                // Subkeys of the keys from first on: L = E(0), K1 = 2L and K2 = 4L
+                void schedule_subkeys(std::size_t first, std::size_t count) {
+                    std::vector<std::size_t> indices(count);
+                    std::vector<block_type> masks(count);
+                    for (std::size_t i = 0; i != count; ++i) {
+                        indices[i] = first + i;
+                        masks[i].fill(0);
+                    }
+                    impl->encrypt_multi_key(schedules.data(), indices.data(), masks.data(), masks.data(), count);
+
+                    subkeys.resize(2 * (first + count));
+                    for (std::size_t i = 0; i != count; ++i) {
+                        subkeys[2 * (first + i)] = multiply_x(masks[i]);
+                        subkeys[2 * (first + i) + 1] = multiply_x(subkeys[2 * (first + i)]);
+                        masks[i].fill(0);
+                    }
+                }
+
+                const typename dispatch_type::table_type *impl;
+                std::vector<key_schedule_type> schedules;
+                // CMAC subkeys K1 and K2 of every key, in key order, derived by cmac on demand
+                std::vector<block_type> subkeys;
+            };
+        }    // namespace block
+    }        // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_BLOCK_RIJNDAEL_MULTI_KEY_HPP
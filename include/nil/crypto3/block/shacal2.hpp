@@ -111,6 +111,20 @@ namespace nil {
                     return decrypt_block(ciphertext);
                 }
 
+                inline void encrypt_blocks(const block_type *plaintext, block_type *ciphertext,
+                                           std::size_t blocks) const {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        ciphertext[i] = encrypt(plaintext[i]);
+                    }
+                }
+
+                inline void decrypt_blocks(const block_type *ciphertext, block_type *plaintext,
+                                           std::size_t blocks) const {
+                    for (std::size_t i = 0; i != blocks; ++i) {
+                        plaintext[i] = decrypt(ciphertext[i]);
+                    }
+                }
+
             protected:
                 const key_schedule_type schedule;
 
@@ -27,11 +27,20 @@
 
 #include <iostream>
 #include <cstdint>
+#include <cstring>
+#include <list>
+#include <sstream>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 #include <boost/test/data/monomorphic.hpp>
 
+#include <boost/mpl/list.hpp>
+
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
@@ -40,9 +49,13 @@
 
 #include <nil/crypto3/block/algorithm/encrypt.hpp>
 #include <nil/crypto3/block/algorithm/decrypt.hpp>
+#include <nil/crypto3/block/algorithm/parallel.hpp>
 
 #include <nil/crypto3/block/aes.hpp>
 #include <nil/crypto3/block/rijndael.hpp>
+#include <nil/crypto3/block/rijndael_multi_key.hpp>
+#include <nil/crypto3/block/keystream_buffer.hpp>
+#include <nil/crypto3/block/ctr_drbg.hpp>
 
 using namespace nil::crypto3;
 using namespace nil::crypto3::block;
@@ -309,6 +322,266 @@ BOOST_DATA_TEST_CASE(rijndael_128_128, string_data("key_128_block_128"), triples
     }
 }
 
+BOOST_DATA_TEST_CASE(rijndael_128_160, string_data("key_128_block_160"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<128, 160>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_160_160, string_data("key_160_block_160"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<160, 160>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_192_160, string_data("key_192_block_160"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<192, 160>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_224_160, string_data("key_224_block_160"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<224, 160>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_256_160, string_data("key_256_block_160"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<256, 160>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_128_192, string_data("key_128_block_192"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<128, 192>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_160_192, string_data("key_160_block_192"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<160, 192>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_192_192, string_data("key_192_block_192"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<192, 192>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_224_192, string_data("key_224_block_192"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<224, 192>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_256_192, string_data("key_256_block_192"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<256, 192>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_128_224, string_data("key_128_block_224"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<128, 224>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_160_224, string_data("key_160_block_224"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<160, 224>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_192_224, string_data("key_192_block_224"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<192, 224>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_224_224, string_data("key_224_block_224"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<224, 224>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_256_224, string_data("key_256_block_224"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<256, 224>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_128_256, string_data("key_128_block_256"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<128, 256>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_160_256, string_data("key_160_block_256"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<160, 256>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_192_256, string_data("key_192_block_256"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<192, 256>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_224_256, string_data("key_224_block_256"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<224, 256>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
+BOOST_DATA_TEST_CASE(rijndael_256_256, string_data("key_256_block_256"), triples) {
+
+    byte_string const p(triples.first);
+
+    BOOST_FOREACH (boost::property_tree::ptree::value_type pair, triples.second) {
+        byte_string const k(pair.first);
+
+        std::string out = encrypt<block::rijndael<256, 256>>(p, k);
+
+        BOOST_CHECK_EQUAL(out, pair.second.data());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /*  NIST SP 800-38A AES tests
@@ -386,6 +659,1705 @@ BOOST_AUTO_TEST_CASE(aes_256_cipher) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+typedef boost::mpl::list<block::aes<128>, block::aes<192>, block::aes<256>> aes_types;
+
+// Forces a backend while in scope, the default selection is back once it is left, a failed check included
+class backend_guard {
+public:
+    explicit backend_guard(block::rijndael_backend::type backend) : forced(block::rijndael_backend::force(backend)) {
+    }
+
+    ~backend_guard() {
+        block::rijndael_backend::reset();
+    }
+
+    backend_guard(const backend_guard &) = delete;
+    backend_guard &operator=(const backend_guard &) = delete;
+
+    explicit operator bool() const {
+        return forced;
+    }
+
+private:
+    bool forced;
+};
+
+// Runs check(backend) with every backend this host supports forced in turn
+template<typename Check>
+void for_each_backend(Check check) {
+    for (block::rijndael_backend::type backend :
+         {block::rijndael_backend::generic, block::rijndael_backend::ssse3, block::rijndael_backend::aes_ni,
+          block::rijndael_backend::armv8, block::rijndael_backend::power8, block::rijndael_backend::vaes_avx2,
+          block::rijndael_backend::vaes_avx512, block::rijndael_backend::bitsliced}) {
+        const backend_guard guard(backend);
+        if (!guard) {
+            continue;
+        }
+        BOOST_TEST_MESSAGE("Checking " << block::rijndael_backend::name(backend));
+
+        check(backend);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(aes_bulk_test_suite)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_bulk_matches_single_block, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(i * 7 + 1);
+    }
+    Cipher cipher(key);
+
+    // 8-way, 4-way and single block paths are all exercised
+    for (std::size_t n : {0, 1, 3, 4, 7, 8, 13, 37}) {
+        std::vector<typename Cipher::block_type> plaintext(n), ciphertext(n), decrypted(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+                plaintext[i][j] = static_cast<std::uint8_t>(i * 31 + j);
+            }
+        }
+
+        cipher.encrypt_blocks(plaintext.data(), ciphertext.data(), n);
+        for (std::size_t i = 0; i != n; ++i) {
+            BOOST_CHECK(ciphertext[i] == cipher.encrypt(plaintext[i]));
+        }
+
+        cipher.decrypt_blocks(ciphertext.data(), decrypted.data(), n);
+        BOOST_CHECK(decrypted == plaintext);
+
+        cipher.encrypt_blocks(decrypted.data(), decrypted.data(), n);
+        BOOST_CHECK(decrypted == ciphertext);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_contiguous_stream_matches_single_pass, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0xa5 ^ i);
+    }
+    Cipher cipher(key);
+
+    // Block-aligned and unaligned lengths spanning several internal batches
+    for (std::size_t n : {16, 48, 1024, 1040, 4096 + 16 * 3, 1025, 4099}) {
+        std::vector<std::uint8_t> input(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            input[i] = static_cast<std::uint8_t>(i * 13 + 7);
+        }
+        std::list<std::uint8_t> single_pass(input.begin(), input.end());
+
+        std::string out = encrypt<Cipher>(input, key);
+        std::string expected = encrypt<Cipher>(single_pass, key);
+        BOOST_CHECK_EQUAL(out, expected);
+
+        if (n % 16 == 0) {
+            std::vector<typename Cipher::block_type> blocks(n / 16);
+            std::memcpy(blocks.data(), input.data(), n);
+            cipher.encrypt_blocks(blocks.data(), blocks.data(), blocks.size());
+
+            std::string manual;
+            for (const typename Cipher::block_type &b : blocks) {
+                for (std::uint8_t c : b) {
+                    manual += "0123456789abcdef"[c >> 4];
+                    manual += "0123456789abcdef"[c & 0x0F];
+                }
+            }
+            BOOST_CHECK_EQUAL(out, manual);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_streaming_output_iterator, Cipher, aes_types) {
+    std::vector<std::uint8_t> key(Cipher::key_bits / 8, 0x3c);
+
+    // Several output flushes, both for random-access and single-pass input
+    std::vector<std::uint8_t> input(3 * 4096 + 16 * 5);
+    for (std::size_t i = 0; i != input.size(); ++i) {
+        input[i] = static_cast<std::uint8_t>(i ^ (i >> 8));
+    }
+    std::string raw(input.begin(), input.end());
+
+    std::vector<std::uint8_t> expected(input.size());
+    std::vector<typename Cipher::block_type> blocks(input.size() / 16);
+    std::memcpy(blocks.data(), input.data(), input.size());
+    typename Cipher::key_type k;
+    std::copy(key.begin(), key.end(), k.begin());
+    Cipher(k).encrypt_blocks(blocks.data(), blocks.data(), blocks.size());
+    std::memcpy(expected.data(), blocks.data(), expected.size());
+
+    std::vector<std::uint8_t> out;
+    encrypt<Cipher>(input.begin(), input.end(), key.begin(), key.end(), std::back_inserter(out));
+    BOOST_CHECK(out == expected);
+
+    std::istringstream stream(raw);
+    std::vector<std::uint8_t> single_pass_out;
+    encrypt<Cipher>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>(), key.begin(),
+                    key.end(), std::back_inserter(single_pass_out));
+    BOOST_CHECK(single_pass_out == expected);
+
+    std::vector<std::uint8_t> decrypted;
+    decrypt<Cipher>(out.begin(), out.end(), key.begin(), key.end(), std::back_inserter(decrypted));
+    BOOST_CHECK(decrypted == input);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_parallel_ecb_matches_bulk_path, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x5a + 3 * i);
+    }
+    Cipher cipher(key);
+
+    // Single and partial chunks, several chunks with a partial tail, more chunks than threads
+    for (std::size_t threads : {1, 2, 4}) {
+        block::thread_pool pool(threads);
+        BOOST_CHECK_EQUAL(pool.size(), threads);
+
+        for (std::size_t n : {16, 1040, 32 * 1024, 3 * 32 * 1024 + 16 * 7, 9 * 32 * 1024}) {
+            std::vector<std::uint8_t> input(n);
+            for (std::size_t i = 0; i != n; ++i) {
+                input[i] = static_cast<std::uint8_t>(i * 29 + (i >> 9));
+            }
+
+            std::vector<typename Cipher::block_type> blocks(n / 16);
+            std::memcpy(blocks.data(), input.data(), n);
+            cipher.encrypt_blocks(blocks.data(), blocks.data(), blocks.size());
+            std::vector<std::uint8_t> expected(n);
+            std::memcpy(expected.data(), blocks.data(), n);
+
+            std::vector<std::uint8_t> out(n);
+            BOOST_CHECK(parallel_encrypt(input.begin(), input.end(), cipher, out.begin(), pool) == out.end());
+            BOOST_CHECK(out == expected);
+
+            std::vector<std::uint8_t> decrypted(n);
+            parallel_decrypt(out.cbegin(), out.cend(), cipher, decrypted.begin(), pool);
+            BOOST_CHECK(decrypted == input);
+        }
+
+        std::vector<std::uint8_t> ragged(32 * 1024 + 17), untouched(ragged.size());
+        BOOST_CHECK_THROW(parallel_encrypt(ragged.begin(), ragged.end(), cipher, untouched.begin(), pool),
+                          std::invalid_argument);
+        BOOST_CHECK(untouched == std::vector<std::uint8_t>(ragged.size()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_nested_parallel_for_runs_inline) {
+    block::thread_pool pool(4);
+
+    std::vector<std::atomic<std::size_t>> hits(8 * 8);
+    pool.parallel_for(8, [&](std::size_t i) {
+        pool.parallel_for(8, [&](std::size_t j) { ++hits[i * 8 + j]; });
+    });
+
+    for (const std::atomic<std::size_t> &hit : hits) {
+        BOOST_CHECK_EQUAL(hit.load(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_backend_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_backend_selection) {
+    BOOST_CHECK(block::rijndael_backend::is_available(block::rijndael_backend::generic));
+    BOOST_CHECK(block::rijndael_backend::is_available(block::rijndael_backend::bitsliced));
+    BOOST_CHECK(block::rijndael_backend::is_available(block::rijndael_backend::best()));
+    BOOST_CHECK_EQUAL(block::rijndael_backend::active(), block::rijndael_backend::best());
+
+    BOOST_CHECK(block::rijndael_backend::force(block::rijndael_backend::generic));
+    BOOST_CHECK_EQUAL(block::rijndael_backend::active(), block::rijndael_backend::generic);
+    BOOST_CHECK_EQUAL(block::aes<128>(block::aes<128>::key_type()).backend(), block::rijndael_backend::generic);
+
+    // Non-AES block sizes are only served by AES-NI or the generic implementation
+    block::rijndael_backend::reset();
+    BOOST_CHECK_EQUAL((block::rijndael<128, 256>(block::rijndael<128, 256>::key_type()).backend()),
+                      block::rijndael_backend::is_available(block::rijndael_backend::aes_ni) ?
+                          block::rijndael_backend::aes_ni :
+                          block::rijndael_backend::generic);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_backends_agree, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(i * 13 + 5);
+    }
+
+    // Covers the 16-block wide path along with every remainder shape
+    std::vector<typename Cipher::block_type> plaintext(16 + 8 + 7), expected(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+            plaintext[i][j] = static_cast<std::uint8_t>(i * 17 + j);
+        }
+    }
+
+    {
+        backend_guard generic(block::rijndael_backend::generic);
+        Cipher(key).encrypt_blocks(plaintext.data(), expected.data(), plaintext.size());
+    }
+
+    for_each_backend([&](block::rijndael_backend::type backend) {
+        Cipher cipher(key);
+        BOOST_CHECK_EQUAL(cipher.backend(), backend);
+
+        std::vector<typename Cipher::block_type> ciphertext(plaintext.size()), decrypted(plaintext.size());
+        cipher.encrypt_blocks(plaintext.data(), ciphertext.data(), plaintext.size());
+        BOOST_CHECK(ciphertext == expected);
+        BOOST_CHECK(cipher.encrypt(plaintext[3]) == expected[3]);
+
+        cipher.decrypt_blocks(ciphertext.data(), decrypted.data(), ciphertext.size());
+        BOOST_CHECK(decrypted == plaintext);
+        BOOST_CHECK(cipher.decrypt(expected[5]) == plaintext[5]);
+    });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_one_way_ciphers_match_rijndael, Cipher, aes_types) {
+    typedef block::rijndael_encryptor<Cipher::key_bits, Cipher::block_bits> encryptor_type;
+    typedef block::rijndael_decryptor<Cipher::key_bits, Cipher::block_bits> decryptor_type;
+
+    BOOST_STATIC_ASSERT(sizeof(encryptor_type) < sizeof(Cipher));
+    BOOST_STATIC_ASSERT(sizeof(decryptor_type) < sizeof(Cipher));
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(i * 37 + 11);
+    }
+
+    std::vector<typename Cipher::block_type> plaintext(8 + 3), expected(plaintext.size()),
+        ciphertext(plaintext.size()), decrypted(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+            plaintext[i][j] = static_cast<std::uint8_t>(i * 23 + j * 3);
+        }
+    }
+
+    for_each_backend([&](block::rijndael_backend::type backend) {
+        Cipher cipher(key);
+        cipher.encrypt_blocks(plaintext.data(), expected.data(), plaintext.size());
+
+        encryptor_type encryptor(key);
+        BOOST_CHECK_EQUAL(encryptor.backend(), backend);
+        encryptor.encrypt_blocks(plaintext.data(), ciphertext.data(), plaintext.size());
+        BOOST_CHECK(ciphertext == expected);
+        BOOST_CHECK(encryptor.encrypt(plaintext[4]) == expected[4]);
+
+        decryptor_type decryptor(key);
+        BOOST_CHECK_EQUAL(decryptor.backend(), backend);
+        decryptor.decrypt_blocks(ciphertext.data(), decrypted.data(), ciphertext.size());
+        BOOST_CHECK(decrypted == plaintext);
+        BOOST_CHECK(decryptor.decrypt(expected[7]) == cipher.decrypt(expected[7]));
+    });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_iterated_encryption_matches_chained_encrypt, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(i * 41 + 7);
+    }
+
+    typename Cipher::block_type plaintext;
+    for (std::size_t j = 0; j != plaintext.size(); ++j) {
+        plaintext[j] = static_cast<std::uint8_t>(j * 9 + 1);
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        Cipher cipher(key);
+        block::rijndael_encryptor<Cipher::key_bits, Cipher::block_bits> encryptor(key);
+
+        typename Cipher::block_type expected = plaintext;
+        std::size_t done = 0;
+        for (std::size_t iterations : {0, 1, 2, 17, 100}) {
+            for (; done != iterations; ++done) {
+                expected = cipher.encrypt(expected);
+            }
+            BOOST_CHECK(cipher.encrypt_iterated(plaintext, iterations) == expected);
+            BOOST_CHECK(encryptor.encrypt_iterated(plaintext, iterations) == expected);
+        }
+    });
+}
+
+typedef boost::mpl::list<block::rijndael<128, 256>, block::rijndael<160, 192>, block::rijndael<256, 160>,
+                         block::rijndael<224, 224>, block::rijndael<160, 128>>
+    wide_rijndael_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(wide_rijndael_aes_ni_matches_generic, Cipher, wide_rijndael_types) {
+    if (!block::rijndael_backend::is_available(block::rijndael_backend::aes_ni)) {
+        return;
+    }
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(i * 29 + 3);
+    }
+
+    std::vector<typename Cipher::block_type> plaintext(4 + 4 + 3), expected(plaintext.size()),
+        ciphertext(plaintext.size()), decrypted(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+            plaintext[i][j] = static_cast<std::uint8_t>(i * 11 + j * 7);
+        }
+    }
+
+    {
+        backend_guard generic(block::rijndael_backend::generic);
+        Cipher(key).encrypt_blocks(plaintext.data(), expected.data(), plaintext.size());
+    }
+
+    backend_guard aes_ni(block::rijndael_backend::aes_ni);
+    Cipher cipher(key);
+    BOOST_CHECK_EQUAL(cipher.backend(), block::rijndael_backend::aes_ni);
+
+    cipher.encrypt_blocks(plaintext.data(), ciphertext.data(), plaintext.size());
+    BOOST_CHECK(ciphertext == expected);
+    BOOST_CHECK(cipher.encrypt(plaintext[9]) == expected[9]);
+
+    cipher.decrypt_blocks(ciphertext.data(), decrypted.data(), ciphertext.size());
+    BOOST_CHECK(decrypted == plaintext);
+    BOOST_CHECK(cipher.decrypt(expected[2]) == plaintext[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_multi_key_test_suite)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_multi_key_matches_single_key, Cipher, aes_types) {
+    typedef block::rijndael_multi_key<Cipher::key_bits, Cipher::block_bits> engine_type;
+
+    std::vector<typename Cipher::key_type> keys(5);
+    for (std::size_t k = 0; k != keys.size(); ++k) {
+        for (std::size_t i = 0; i != keys[k].size(); ++i) {
+            keys[k][i] = static_cast<typename Cipher::key_type::value_type>(k * 101 + i * 3);
+        }
+    }
+
+    // Every lane of the 8-way pass uses a different key, then the 4, 2 and 1 block tails
+    std::vector<std::size_t> indices(8 + 7);
+    std::vector<typename Cipher::block_type> plaintext(indices.size()), ciphertext(indices.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        indices[i] = (i * 3) % keys.size();
+        for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+            plaintext[i][j] = static_cast<std::uint8_t>(i * 19 + j);
+        }
+    }
+
+    for_each_backend([&](block::rijndael_backend::type backend) {
+        engine_type engine;
+        BOOST_CHECK_EQUAL(engine.backend(), backend);
+        for (const typename Cipher::key_type &key : keys) {
+            engine.add_key(key);
+        }
+        BOOST_CHECK_EQUAL(engine.keys(), keys.size());
+
+        engine.encrypt(indices.data(), plaintext.data(), ciphertext.data(), plaintext.size());
+        for (std::size_t i = 0; i != plaintext.size(); ++i) {
+            BOOST_CHECK(ciphertext[i] == Cipher(keys[indices[i]]).encrypt(plaintext[i]));
+        }
+
+        engine.encrypt(indices.data(), ciphertext.data(), ciphertext.data(), 3);
+        for (std::size_t i = 0; i != 3; ++i) {
+            BOOST_CHECK(Cipher(keys[indices[i]]).decrypt(ciphertext[i]) ==
+                        Cipher(keys[indices[i]]).encrypt(plaintext[i]));
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_multi_buffer_cbc_matches_serial_cbc, Cipher, aes_types) {
+    typedef block::rijndael_multi_key<Cipher::key_bits, Cipher::block_bits> engine_type;
+    typedef typename engine_type::cbc_job job_type;
+
+    std::vector<typename Cipher::key_type> keys(3);
+    for (std::size_t k = 0; k != keys.size(); ++k) {
+        for (std::size_t i = 0; i != keys[k].size(); ++i) {
+            keys[k][i] = static_cast<typename Cipher::key_type::value_type>(k * 37 + i * 5);
+        }
+    }
+
+    // More jobs than lanes, with empty, single-block and uneven lengths to exercise lane refill
+    const std::size_t lengths[] = {5, 0, 1, 40, 3, 17, 2, 9, 33, 1, 12, 0, 7, 25, 4, 6, 19, 2};
+    const std::size_t jobs_count = sizeof(lengths) / sizeof(lengths[0]);
+
+    std::vector<std::vector<typename Cipher::block_type>> plaintext(jobs_count), expected(jobs_count);
+    std::vector<typename Cipher::block_type> ivs(jobs_count), last(jobs_count);
+    for (std::size_t n = 0; n != jobs_count; ++n) {
+        for (std::size_t j = 0; j != ivs[n].size(); ++j) {
+            ivs[n][j] = static_cast<std::uint8_t>(n * 3 + j);
+        }
+        plaintext[n].resize(lengths[n]);
+        for (std::size_t i = 0; i != lengths[n]; ++i) {
+            for (std::size_t j = 0; j != plaintext[n][i].size(); ++j) {
+                plaintext[n][i][j] = static_cast<std::uint8_t>(n * 41 + i * 13 + j);
+            }
+        }
+
+        Cipher cipher(keys[n % keys.size()]);
+        typename Cipher::block_type chain = ivs[n];
+        for (const typename Cipher::block_type &block : plaintext[n]) {
+            for (std::size_t j = 0; j != chain.size(); ++j) {
+                chain[j] ^= block[j];
+            }
+            chain = cipher.encrypt(chain);
+            expected[n].push_back(chain);
+        }
+        last[n] = chain;
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        engine_type engine;
+        engine.add_keys(keys.data(), keys.size());
+
+        // The first job is encrypted in place
+        std::vector<std::vector<typename Cipher::block_type>> ciphertext(plaintext);
+        std::vector<job_type> jobs(jobs_count);
+        for (std::size_t n = 0; n != jobs_count; ++n) {
+            jobs[n] = {n % keys.size(), ivs[n], n ? plaintext[n].data() : ciphertext[n].data(), ciphertext[n].data(),
+                       lengths[n]};
+        }
+
+        engine.encrypt_cbc(jobs.data(), jobs.size());
+        for (std::size_t n = 0; n != jobs_count; ++n) {
+            BOOST_CHECK(ciphertext[n] == expected[n]);
+            BOOST_CHECK(jobs[n].iv == last[n]);
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(aes_multi_message_cmac_sp800_38b) {
+    // SP 800-38B examples for AES-128 and AES-256, the four messages being prefixes of one another
+    const std::vector<std::uint8_t> message = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+    const std::size_t lengths[] = {0, 16, 40, 64};
+
+    const std::vector<std::uint8_t> key128 = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const std::vector<std::vector<std::uint8_t>> tags128 = {
+        {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46},
+        {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c},
+        {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27},
+        {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe}};
+
+    const std::vector<std::uint8_t> key256 = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+    const std::vector<std::vector<std::uint8_t>> tags256 = {
+        {0x02, 0x89, 0x62, 0xf6, 0x1b, 0x7b, 0xf8, 0x9e, 0xfc, 0x6b, 0x55, 0x1f, 0x46, 0x67, 0xd9, 0x83},
+        {0x28, 0xa7, 0x02, 0x3f, 0x45, 0x2e, 0x8f, 0x82, 0xbd, 0x4b, 0xf2, 0x8d, 0x8c, 0x37, 0xc3, 0x5c},
+        {0xaa, 0xf3, 0xd8, 0xf1, 0xde, 0x56, 0x40, 0xc2, 0x32, 0xf5, 0xb1, 0x69, 0xb9, 0xc9, 0x11, 0xe6},
+        {0xe1, 0x99, 0x21, 0x90, 0x54, 0x9f, 0x6e, 0xd5, 0x69, 0x6a, 0x2c, 0x05, 0x6c, 0x31, 0x54, 0x10}};
+
+    block::rijndael_multi_key<128, 128> engine128;
+    block::rijndael_multi_key<128, 128>::key_type k128;
+    std::copy(key128.begin(), key128.end(), k128.begin());
+    engine128.add_key(k128);
+
+    block::rijndael_multi_key<256, 128> engine256;
+    block::rijndael_multi_key<256, 128>::key_type k256;
+    std::copy(key256.begin(), key256.end(), k256.begin());
+    engine256.add_key(k256);
+
+    block::rijndael_multi_key<128, 128>::cmac_job jobs128[4];
+    block::rijndael_multi_key<256, 128>::cmac_job jobs256[4];
+    for (std::size_t n = 0; n != 4; ++n) {
+        jobs128[n] = {0, message.data(), lengths[n], {}};
+        jobs256[n] = {0, message.data(), lengths[n], {}};
+    }
+    engine128.cmac(jobs128, 4);
+    engine256.cmac(jobs256, 4);
+
+    for (std::size_t n = 0; n != 4; ++n) {
+        BOOST_CHECK(std::equal(tags128[n].begin(), tags128[n].end(), jobs128[n].tag.begin()));
+        BOOST_CHECK(std::equal(tags256[n].begin(), tags256[n].end(), jobs256[n].tag.begin()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_multi_message_cmac_matches_serial_cmac, Cipher, aes_types) {
+    typedef block::rijndael_multi_key<Cipher::key_bits, Cipher::block_bits> engine_type;
+    typedef typename engine_type::cmac_job job_type;
+    typedef typename Cipher::block_type block_type;
+
+    std::vector<typename Cipher::key_type> keys(3);
+    for (std::size_t k = 0; k != keys.size(); ++k) {
+        for (std::size_t i = 0; i != keys[k].size(); ++i) {
+            keys[k][i] = static_cast<typename Cipher::key_type::value_type>(k * 29 + i * 7);
+        }
+    }
+
+    // More jobs than lanes, lengths around block boundaries and past the per-pass step limit
+    const std::size_t lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 5, 300, 48, 520, 16, 0, 47, 1000, 3, 80};
+    const std::size_t jobs_count = sizeof(lengths) / sizeof(lengths[0]);
+
+    std::vector<std::vector<std::uint8_t>> messages(jobs_count);
+    std::vector<block_type> expected(jobs_count);
+    for (std::size_t n = 0; n != jobs_count; ++n) {
+        messages[n].resize(lengths[n]);
+        for (std::size_t i = 0; i != lengths[n]; ++i) {
+            messages[n][i] = static_cast<std::uint8_t>(n * 53 + i * 11);
+        }
+
+        // Serial CMAC: CBC-MAC with the last block masked by the doubled or quadrupled E(0)
+        const Cipher cipher(keys[n % keys.size()]);
+        block_type subkey = cipher.encrypt(block_type());
+        const std::size_t full = lengths[n] != 0 && lengths[n] % 16 == 0;
+        for (std::size_t d = 0; d != 2 - full; ++d) {
+            const std::uint8_t carry = subkey[0] >> 7;
+            for (std::size_t j = 0; j != 15; ++j) {
+                subkey[j] = static_cast<std::uint8_t>((subkey[j] << 1) | (subkey[j + 1] >> 7));
+            }
+            subkey[15] = static_cast<std::uint8_t>((subkey[15] << 1) ^ (carry ? 0x87 : 0));
+        }
+
+        block_type chain = block_type();
+        const std::size_t blocks = lengths[n] == 0 ? 1 : (lengths[n] + 15) / 16;
+        for (std::size_t b = 0; b != blocks; ++b) {
+            for (std::size_t j = 0; j != 16; ++j) {
+                const std::size_t i = b * 16 + j;
+                chain[j] ^= i < lengths[n] ? messages[n][i] : (i == lengths[n] ? 0x80 : 0);
+                chain[j] ^= b + 1 == blocks ? subkey[j] : 0;
+            }
+            chain = cipher.encrypt(chain);
+        }
+        expected[n] = chain;
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        // Keys added after a cmac call get their subkeys on the next one
+        engine_type engine;
+        engine.add_key(keys[0]);
+        job_type first = {0, messages[9].data(), lengths[9], {}};
+        engine.cmac(&first, 1);
+        BOOST_CHECK(first.tag == expected[9]);
+        engine.add_keys(keys.data() + 1, keys.size() - 1);
+
+        std::vector<job_type> jobs(jobs_count);
+        for (std::size_t n = 0; n != jobs_count; ++n) {
+            jobs[n] = {n % keys.size(), messages[n].data(), lengths[n], {}};
+        }
+
+        engine.cmac(jobs.data(), jobs.size());
+        for (std::size_t n = 0; n != jobs_count; ++n) {
+            BOOST_CHECK(jobs[n].tag == expected[n]);
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_batched_key_schedule_matches_single_key, Cipher, aes_types) {
+    typedef block::rijndael_multi_key<Cipher::key_bits, Cipher::block_bits> engine_type;
+
+    // Two full lockstep batches and a single key tail
+    std::vector<typename Cipher::key_type> keys(9);
+    std::vector<std::size_t> indices(keys.size());
+    std::vector<typename Cipher::block_type> plaintext(keys.size()), ciphertext(keys.size());
+    for (std::size_t k = 0; k != keys.size(); ++k) {
+        for (std::size_t i = 0; i != keys[k].size(); ++i) {
+            keys[k][i] = static_cast<typename Cipher::key_type::value_type>(k * 59 + i * 13);
+        }
+        for (std::size_t j = 0; j != plaintext[k].size(); ++j) {
+            plaintext[k][j] = static_cast<std::uint8_t>(k + j * 5);
+        }
+        indices[k] = 1 + k;
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        engine_type engine;
+        BOOST_CHECK_EQUAL(engine.add_key(keys[0]), 0);
+        BOOST_CHECK_EQUAL(engine.add_keys(keys.data(), keys.size()), 1);
+        BOOST_CHECK_EQUAL(engine.add_keys(keys.data(), 0), keys.size() + 1);
+        BOOST_CHECK_EQUAL(engine.keys(), keys.size() + 1);
+
+        engine.encrypt(indices.data(), plaintext.data(), ciphertext.data(), plaintext.size());
+        for (std::size_t k = 0; k != keys.size(); ++k) {
+            BOOST_CHECK(ciphertext[k] == Cipher(keys[k]).encrypt(plaintext[k]));
+        }
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_ctr_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_ctr_matches_encrypted_counters, Cipher, aes_types) {
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x11 * i + 5);
+    }
+
+    // Counters whose increments carry across the 32-bit, 64-bit and 128-bit boundaries
+    std::vector<typename Cipher::block_type> counters(3);
+    for (std::size_t j = 0; j != 16; ++j) {
+        counters[0][j] = static_cast<std::uint8_t>(j < 12 ? j : 0xff);
+        counters[1][j] = static_cast<std::uint8_t>(j < 8 ? 0x20 + j : 0xff);
+        counters[2][j] = 0xff;
+    }
+    counters[0][15] = 0xf5;
+    counters[1][15] = 0xf3;
+    counters[2][15] = 0xf9;
+
+    std::vector<typename Cipher::block_type> input(16 * 2 + 7), output(input.size()), expected(input.size());
+    for (std::size_t i = 0; i != input.size(); ++i) {
+        for (std::size_t j = 0; j != input[i].size(); ++j) {
+            input[i][j] = static_cast<std::uint8_t>(i * 7 + j * 31);
+        }
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        Cipher cipher(key);
+        block::rijndael_encryptor<Cipher::key_bits, Cipher::block_bits> encryptor(key);
+
+        for (const typename Cipher::block_type &counter : counters) {
+            typename Cipher::block_type next = counter;
+            for (std::size_t i = 0; i != input.size(); ++i) {
+                expected[i] = cipher.encrypt(next);
+                for (std::size_t j = 0; j != expected[i].size(); ++j) {
+                    expected[i][j] ^= input[i][j];
+                }
+                for (std::size_t j = next.size(); j-- != 0 && ++next[j] == 0;) {
+                }
+            }
+
+            // Every length exercises a different mix of the wide, narrow and masked tails
+            for (std::size_t blocks = 0; blocks <= input.size(); ++blocks) {
+                cipher.encrypt_ctr(counter, input.data(), output.data(), blocks);
+                BOOST_CHECK(std::equal(output.begin(), output.begin() + blocks, expected.begin()));
+            }
+
+            output = input;
+            encryptor.encrypt_ctr(counter, output.data(), output.data(), output.size());
+            BOOST_CHECK(output == expected);
+            cipher.encrypt_ctr(counter, output.data(), output.data(), output.size());
+            BOOST_CHECK(output == input);
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(aes_ctr_mode_sp800_38a) {
+    typedef block::aes<128> cipher_type;
+    typedef block::modes::counter<cipher_type, block::nop_padding> mode_type;
+    typedef mode_type::bind<mode_type::encryption_policy>::type ctr_type;
+
+    cipher_type::key_type key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    cipher_type::block_type iv = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                  0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+    std::vector<cipher_type::block_type> plaintext = {
+        {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a},
+        {0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51},
+        {0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef},
+        {0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+    std::vector<cipher_type::block_type> ciphertext = {
+        {0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce},
+        {0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff},
+        {0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab},
+        {0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee}};
+
+    ctr_type mode(cipher_type(key), iv);
+    std::vector<cipher_type::block_type> out(plaintext.size());
+
+    // Block by block the way the accumulator drives it, total_seen counting the current block
+    out[0] = mode.begin_message(plaintext[0], 128);
+    mode.process_blocks(plaintext.data() + 1, out.data() + 1, 2, 2 * 128);
+    out[3] = mode.end_message(plaintext[3], 4 * 128);
+    BOOST_CHECK(out == ciphertext);
+
+    // Random access to any block, in either direction
+    for (std::size_t first = 0; first != plaintext.size(); ++first) {
+        std::vector<cipher_type::block_type> part(plaintext.size() - first);
+        mode.process_blocks_at(ciphertext.data() + first, part.data(), part.size(), first);
+        BOOST_CHECK(std::equal(part.begin(), part.end(), plaintext.begin() + first));
+    }
+    BOOST_CHECK(mode.counter_at(1) == (cipher_type::block_type {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                                                0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xff, 0x00}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_chained_modes_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_cbc_cfb_modes_sp800_38a) {
+    typedef block::aes<128> cipher_type;
+    typedef block::modes::cbc<cipher_type, block::nop_padding> cbc_type;
+    typedef block::modes::cfb<cipher_type, block::nop_padding> cfb_type;
+
+    cipher_type cipher({0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c});
+    cipher_type::block_type iv = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    std::vector<cipher_type::block_type> plaintext = {
+        {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a},
+        {0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51},
+        {0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef},
+        {0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+    std::vector<cipher_type::block_type> cbc_ciphertext = {
+        {0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d},
+        {0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2},
+        {0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16},
+        {0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7}};
+    std::vector<cipher_type::block_type> cfb_ciphertext = {
+        {0x3b, 0x3f, 0xd9, 0x2e, 0xb7, 0x2d, 0xad, 0x20, 0x33, 0x34, 0x49, 0xf8, 0xe8, 0x3c, 0xfb, 0x4a},
+        {0xc8, 0xa6, 0x45, 0x37, 0xa0, 0xb3, 0xa9, 0x3f, 0xcd, 0xe3, 0xcd, 0xad, 0x9f, 0x1c, 0xe5, 0x8b},
+        {0x26, 0x75, 0x1f, 0x67, 0xa3, 0xcb, 0xb1, 0x40, 0xb1, 0x80, 0x8c, 0xf1, 0x87, 0xa4, 0xf4, 0xdf},
+        {0xc0, 0x4b, 0x05, 0x35, 0x7c, 0x5d, 0x1c, 0x0e, 0xea, 0xc4, 0xc6, 0x6f, 0x9f, 0xf7, 0xf2, 0xe6}};
+    std::vector<cipher_type::block_type> out(plaintext.size());
+
+    cbc_type::bind<cbc_type::encryption_policy>::type cbc_encrypt(cipher, iv);
+    out[0] = cbc_encrypt.begin_message(plaintext[0], 128);
+    cbc_encrypt.process_blocks(plaintext.data() + 1, out.data() + 1, 2, 2 * 128);
+    out[3] = cbc_encrypt.end_message(plaintext[3], 4 * 128);
+    BOOST_CHECK(out == cbc_ciphertext);
+
+    cbc_type::bind<cbc_type::decryption_policy>::type cbc_decrypt(cipher, iv);
+    cbc_decrypt.process_blocks(cbc_ciphertext.data(), out.data(), out.size(), 128);
+    BOOST_CHECK(out == plaintext);
+
+    cfb_type::bind<cfb_type::encryption_policy>::type cfb_encrypt(cipher, iv);
+    cfb_encrypt.process_blocks(plaintext.data(), out.data(), out.size(), 128);
+    BOOST_CHECK(out == cfb_ciphertext);
+
+    cfb_type::bind<cfb_type::decryption_policy>::type cfb_decrypt(cipher, iv);
+    out[0] = cfb_decrypt.process_block(cfb_ciphertext[0], 128);
+    cfb_decrypt.process_blocks(cfb_ciphertext.data() + 1, out.data() + 1, 3, 2 * 128);
+    BOOST_CHECK(out == plaintext);
+}
+
+BOOST_AUTO_TEST_CASE(aes_ofb_mode_sp800_38a) {
+    typedef block::aes<128> cipher_type;
+    typedef block::modes::ofb<cipher_type, block::nop_padding> ofb_type;
+
+    cipher_type::key_type key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    cipher_type::block_type iv = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    std::vector<cipher_type::block_type> plaintext = {
+        {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a},
+        {0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51},
+        {0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef},
+        {0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+    std::vector<cipher_type::block_type> ciphertext = {
+        {0x3b, 0x3f, 0xd9, 0x2e, 0xb7, 0x2d, 0xad, 0x20, 0x33, 0x34, 0x49, 0xf8, 0xe8, 0x3c, 0xfb, 0x4a},
+        {0x77, 0x89, 0x50, 0x8d, 0x16, 0x91, 0x8f, 0x03, 0xf5, 0x3c, 0x52, 0xda, 0xc5, 0x4e, 0xd8, 0x25},
+        {0x97, 0x40, 0x05, 0x1e, 0x9c, 0x5f, 0xec, 0xf6, 0x43, 0x44, 0xf7, 0xa8, 0x22, 0x60, 0xed, 0xcc},
+        {0x30, 0x4c, 0x65, 0x28, 0xf6, 0x59, 0xc7, 0x78, 0x66, 0xa5, 0x10, 0xd9, 0xc1, 0xd6, 0xae, 0x5e}};
+    std::vector<cipher_type::block_type> out(plaintext.size());
+
+    ofb_type::bind<ofb_type::encryption_policy>::type ofb_encrypt(cipher_type(key), iv);
+    out[0] = ofb_encrypt.begin_message(plaintext[0], 128);
+    ofb_encrypt.process_blocks(plaintext.data() + 1, out.data() + 1, 2, 2 * 128);
+    out[3] = ofb_encrypt.end_message(plaintext[3], 4 * 128);
+    BOOST_CHECK(out == ciphertext);
+
+    ofb_type::bind<ofb_type::decryption_policy>::type ofb_decrypt(cipher_type(key), iv);
+    ofb_decrypt.process_blocks(ciphertext.data(), out.data(), out.size(), 128);
+    BOOST_CHECK(out == plaintext);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_keystream_buffer_matches_direct_mode, Cipher, aes_types) {
+    typedef block::modes::counter<Cipher, block::nop_padding> ctr_type;
+    typedef block::modes::ofb<Cipher, block::nop_padding> ofb_type;
+    typedef typename ctr_type::template bind<typename ctr_type::encryption_policy>::type ctr_mode_type;
+    typedef typename ofb_type::template bind<typename ofb_type::encryption_policy>::type ofb_mode_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x29 * i + 3);
+    }
+    Cipher cipher(key);
+    typename Cipher::block_type iv;
+    for (std::size_t j = 0; j != iv.size(); ++j) {
+        iv[j] = static_cast<std::uint8_t>(j < 12 ? 0x50 + j : 0xff);
+    }
+
+    // Packet sizes off the block boundary, some larger than the whole ring
+    const std::size_t sizes[] = {1, 15, 16, 17, 100, 0, 333, 48, 1500, 7, 64, 2000, 31};
+    std::size_t total = 0;
+    for (std::size_t size : sizes) {
+        total += size;
+    }
+
+    std::vector<std::uint8_t> plaintext(total);
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 13 + 1);
+    }
+
+    std::vector<typename Cipher::block_type> blocks((total + 15) / 16);
+    std::memcpy(blocks.data(), plaintext.data(), total);
+
+    std::vector<typename Cipher::block_type> ctr_expected(blocks.size()), ofb_expected(blocks.size());
+    ctr_mode_type(cipher, iv).process_blocks(blocks.data(), ctr_expected.data(), blocks.size(), 128);
+    ofb_mode_type(cipher, iv).process_blocks(blocks.data(), ofb_expected.data(), blocks.size(), 128);
+
+    for (block::keystream_refill::type refill :
+         {block::keystream_refill::manual, block::keystream_refill::background}) {
+        // A ring of 8 blocks wraps around several times and runs dry on the larger packets
+        block::keystream_buffer<ctr_mode_type> ctr(ctr_mode_type(cipher, iv), 8, 2, 6, refill);
+        block::keystream_buffer<ofb_mode_type> ofb(ofb_mode_type(cipher, iv), 8, refill);
+        BOOST_CHECK_EQUAL(ctr.available(), 6 * 16);
+        BOOST_CHECK_EQUAL(ofb.available(), 8 * 16);
+
+        std::vector<std::uint8_t> ctr_out(total), ofb_out(plaintext);
+        for (std::size_t offset = 0, i = 0; i != sizeof(sizes) / sizeof(sizes[0]); offset += sizes[i++]) {
+            ctr.process(plaintext.data() + offset, ctr_out.data() + offset, sizes[i]);
+            ofb.process(ofb_out.data() + offset, ofb_out.data() + offset, sizes[i]);
+            if (refill == block::keystream_refill::manual) {
+                ctr.refill();
+                ofb.refill();
+            }
+        }
+
+        BOOST_CHECK(std::memcmp(ctr_out.data(), ctr_expected.data(), total) == 0);
+        BOOST_CHECK(std::memcmp(ofb_out.data(), ofb_expected.data(), total) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_chained_modes_bulk_decryption, Cipher, aes_types) {
+    typedef block::modes::cbc<Cipher, block::nop_padding> cbc_type;
+    typedef block::modes::cfb<Cipher, block::nop_padding> cfb_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x3d * i + 1);
+    }
+    Cipher cipher(key);
+    typename Cipher::block_type iv;
+    for (std::size_t j = 0; j != iv.size(); ++j) {
+        iv[j] = static_cast<std::uint8_t>(0xa0 + j);
+    }
+
+    std::vector<typename Cipher::block_type> plaintext(100), ciphertext(plaintext.size()), out(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        for (std::size_t j = 0; j != plaintext[i].size(); ++j) {
+            plaintext[i][j] = static_cast<std::uint8_t>(i * 11 + j * 7);
+        }
+    }
+
+    // Chunks crossing the internal batch boundary, the last one decrypted in place
+    const std::size_t chunks[] = {1, 31, 33, 5, 30};
+
+    typename cbc_type::template bind<typename cbc_type::encryption_policy>::type cbc_encrypt(cipher, iv);
+    cbc_encrypt.process_blocks(plaintext.data(), ciphertext.data(), plaintext.size(), 128);
+    typename Cipher::block_type previous = iv;
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        typename Cipher::block_type block;
+        for (std::size_t j = 0; j != block.size(); ++j) {
+            block[j] = plaintext[i][j] ^ previous[j];
+        }
+        previous = cipher.encrypt(block);
+        BOOST_CHECK(ciphertext[i] == previous);
+    }
+
+    typename cbc_type::template bind<typename cbc_type::decryption_policy>::type cbc_decrypt(cipher, iv);
+    out = ciphertext;
+    for (std::size_t offset = 0, c = 0; c != sizeof(chunks) / sizeof(chunks[0]); offset += chunks[c++]) {
+        cbc_decrypt.process_blocks(out.data() + offset, out.data() + offset, chunks[c], (offset + 1) * 128);
+    }
+    BOOST_CHECK(out == plaintext);
+
+    typename cfb_type::template bind<typename cfb_type::encryption_policy>::type cfb_encrypt(cipher, iv);
+    cfb_encrypt.process_blocks(plaintext.data(), ciphertext.data(), plaintext.size(), 128);
+
+    typename cfb_type::template bind<typename cfb_type::decryption_policy>::type cfb_decrypt(cipher, iv);
+    out = ciphertext;
+    for (std::size_t offset = 0, c = 0; c != sizeof(chunks) / sizeof(chunks[0]); offset += chunks[c++]) {
+        cfb_decrypt.process_blocks(out.data() + offset, out.data() + offset, chunks[c], (offset + 1) * 128);
+    }
+    BOOST_CHECK(out == plaintext);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_xts_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_xts_mode_ieee1619) {
+    typedef block::modes::xts<block::aes<128>, block::nop_padding> xts128_type;
+    typedef block::modes::xts<block::aes<256>, block::nop_padding> xts256_type;
+
+    // IEEE 1619 vector 1, then ciphertext stealing with the keys and data unit of vectors 15 to 18
+    std::vector<std::uint8_t> zero(32), data(40);
+    for (std::size_t i = 0; i != data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>(i);
+    }
+    const std::uint64_t sector = 0x123456789a;
+    const std::vector<std::uint8_t> ciphertext_zero = {
+        0x91, 0x7c, 0xf6, 0x9e, 0xbd, 0x68, 0xb2, 0xec, 0x9b, 0x9f, 0xe9, 0xa3, 0xea, 0xdd, 0xa6, 0x92,
+        0xcd, 0x43, 0xd2, 0xf5, 0x95, 0x98, 0xed, 0x85, 0x8c, 0x02, 0xc2, 0x65, 0x2f, 0xbf, 0x92, 0x2e};
+    const std::vector<std::uint8_t> ciphertext_17 = {0x6c, 0x16, 0x25, 0xdb, 0x46, 0x71, 0x52, 0x2d, 0x3d,
+                                                     0x75, 0x99, 0x60, 0x1d, 0xe7, 0xca, 0x09, 0xed};
+    const std::vector<std::uint8_t> ciphertext_31 = {
+        0xd0, 0x5b, 0xc0, 0x90, 0xa8, 0xe0, 0x4f, 0x1b, 0x3d, 0x3e, 0xcd, 0xd5, 0xba, 0xec, 0x0f, 0xd4,
+        0xed, 0xbf, 0x9d, 0xac, 0xe4, 0x5d, 0x6f, 0x6a, 0x73, 0x06, 0xe6, 0x4b, 0xe5, 0xdd, 0x82};
+    const std::vector<std::uint8_t> ciphertext_256 = {
+        0xc3, 0x0c, 0xa8, 0xf2, 0xed, 0x57, 0x30, 0x7e, 0xdc, 0x87, 0xe5, 0x44, 0x86, 0x7a, 0xc8, 0x88,
+        0xef, 0x0c, 0x8f, 0x58, 0x62, 0xbb, 0xbf, 0x8c, 0x1b, 0x61, 0x68, 0x01, 0xec, 0x7b, 0x5c, 0xab,
+        0x34, 0x8c, 0x20, 0x89, 0x28, 0xd7, 0x40, 0x62};
+
+    block::aes<128>::key_type key1, key2;
+    block::aes<256>::key_type key3, key4;
+    for (std::size_t i = 0; i != key3.size(); ++i) {
+        key3[i] = static_cast<std::uint8_t>(0xff - i);
+        key4[i] = static_cast<std::uint8_t>(0xbf - i);
+        if (i < key1.size()) {
+            key1[i] = key3[i];
+            key2[i] = key4[i];
+        }
+    }
+    block::aes<128>::key_type zero_key = {0};
+
+    xts128_type::bind<xts128_type::encryption_policy>::type zero_encrypt(zero_key, zero_key);
+    xts128_type::bind<xts128_type::decryption_policy>::type zero_decrypt(zero_key, zero_key);
+    std::vector<std::uint8_t> out(zero.size());
+    zero_encrypt.process_sector(0, zero.data(), out.data(), out.size());
+    BOOST_CHECK(out == ciphertext_zero);
+    zero_decrypt.process_sector(0, out.data(), out.data(), out.size());
+    BOOST_CHECK(out == zero);
+
+    xts128_type::bind<xts128_type::encryption_policy>::type encrypt128(key1, key2);
+    xts128_type::bind<xts128_type::decryption_policy>::type decrypt128(key1, key2);
+    for (const std::vector<std::uint8_t> *expected : {&ciphertext_17, &ciphertext_31}) {
+        out.assign(data.begin(), data.begin() + expected->size());
+        encrypt128.process_sector(sector, out.data(), out.data(), out.size());
+        BOOST_CHECK(out == *expected);
+        decrypt128.process_sector(sector, out.data(), out.data(), out.size());
+        BOOST_CHECK(std::equal(out.begin(), out.end(), data.begin()));
+    }
+
+    xts256_type::bind<xts256_type::encryption_policy>::type encrypt256(key3, key4);
+    xts256_type::bind<xts256_type::decryption_policy>::type decrypt256(key3, key4);
+    out.resize(data.size());
+    encrypt256.process_sector(sector, data.data(), out.data(), out.size());
+    BOOST_CHECK(out == ciphertext_256);
+    decrypt256.process_sector(sector, out.data(), out.data(), out.size());
+    BOOST_CHECK(out == data);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_xts_sectors_match_serial_tweaks, Cipher, aes_types) {
+    typedef block::modes::xts<Cipher, block::nop_padding> xts_type;
+
+    typename Cipher::key_type key1, key2;
+    for (std::size_t i = 0; i != key1.size(); ++i) {
+        key1[i] = static_cast<typename Cipher::key_type::value_type>(0x17 * i + 3);
+        key2[i] = static_cast<typename Cipher::key_type::value_type>(0x29 * i + 8);
+    }
+
+    // 39 blocks go through the wide, the four block and the single block groups
+    const std::size_t sectors = 5, sector_blocks = 39, sector_size = sector_blocks * 16;
+    std::vector<std::uint8_t> plaintext(sectors * sector_size + 16), ciphertext(plaintext.size()),
+        expected(plaintext.size()), out(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 13 + (i >> 8));
+    }
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        Cipher cipher(key1);
+        typename xts_type::template bind<typename xts_type::encryption_policy>::type encrypt(cipher, Cipher(key2));
+        typename xts_type::template bind<typename xts_type::decryption_policy>::type decrypt(cipher, Cipher(key2));
+
+        // Reference tweaks doubled one block at a time, starting from a sector number carrying past 32 bits
+        const std::uint64_t first_sector = 0xfffffffeull;
+        for (std::size_t s = 0; s != sectors; ++s) {
+            typename Cipher::block_type tweak = encrypt.tweak_at(first_sector + s), block;
+            for (std::size_t b = 0; b != sector_blocks; ++b) {
+                const std::size_t offset = s * sector_size + b * 16;
+                for (std::size_t j = 0; j != 16; ++j) {
+                    block[j] = plaintext[offset + j] ^ tweak[j];
+                }
+                block = cipher.encrypt(block);
+                for (std::size_t j = 0; j != 16; ++j) {
+                    expected[offset + j] = block[j] ^ tweak[j];
+                }
+                const std::uint8_t carry = tweak[15] >> 7;
+                for (std::size_t j = 15; j != 0; --j) {
+                    tweak[j] = static_cast<std::uint8_t>((tweak[j] << 1) | (tweak[j - 1] >> 7));
+                }
+                tweak[0] = static_cast<std::uint8_t>((tweak[0] << 1) ^ (carry ? 0x87 : 0));
+            }
+        }
+
+        encrypt.process_sectors(first_sector, plaintext.data(), ciphertext.data(), sector_size, sectors);
+        BOOST_CHECK(std::equal(ciphertext.begin(), ciphertext.begin() + sectors * sector_size, expected.begin()));
+
+        out = ciphertext;
+        decrypt.process_sectors(first_sector, out.data(), out.data(), sector_size, sectors);
+        BOOST_CHECK(std::equal(out.begin(), out.begin() + sectors * sector_size, plaintext.begin()));
+
+        // Sectors with a partial last block keep every full block but the last one and round trip
+        const std::size_t stolen_size = sector_size + 9;
+        encrypt.process_sectors(first_sector, plaintext.data(), ciphertext.data(), stolen_size, 2);
+        BOOST_CHECK(std::equal(ciphertext.begin(), ciphertext.begin() + sector_size - 16, expected.begin()));
+        for (std::size_t s = 0; s != 2; ++s) {
+            out.assign(ciphertext.begin() + s * stolen_size, ciphertext.begin() + (s + 1) * stolen_size);
+            decrypt.process_sector(first_sector + s, out.data(), out.data(), stolen_size);
+            BOOST_CHECK(std::equal(out.begin(), out.end(), plaintext.begin() + s * stolen_size));
+        }
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_gcm_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_gcm_mode_mcgrew_viega) {
+    typedef block::modes::gcm<block::aes<128>, block::nop_padding> gcm128_type;
+    typedef block::modes::gcm<block::aes<256>, block::nop_padding> gcm256_type;
+    typedef gcm128_type::bind<gcm128_type::encryption_policy>::type encrypt128_type;
+    typedef gcm128_type::bind<gcm128_type::decryption_policy>::type decrypt128_type;
+
+    // Test cases 2, 4, 6 and 16 of the GCM specification
+    const std::vector<std::uint8_t> plaintext = {
+        0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+        0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+        0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+        0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39};
+    const std::vector<std::uint8_t> aad = {
+        0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+        0xab, 0xad, 0xda, 0xd2};
+    const std::vector<std::uint8_t> iv = {
+        0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+    const std::vector<std::uint8_t> long_iv = {
+        0x93, 0x13, 0x22, 0x5d, 0xf8, 0x84, 0x06, 0xe5, 0x55, 0x90, 0x9c, 0x5a, 0xff, 0x52, 0x69, 0xaa,
+        0x6a, 0x7a, 0x95, 0x38, 0x53, 0x4f, 0x7d, 0xa1, 0xe4, 0xc3, 0x03, 0xd2, 0xa3, 0x18, 0xa7, 0x28,
+        0xc3, 0xc0, 0xc9, 0x51, 0x56, 0x80, 0x95, 0x39, 0xfc, 0xf0, 0xe2, 0x42, 0x9a, 0x6b, 0x52, 0x54,
+        0x16, 0xae, 0xdb, 0xf5, 0xa0, 0xde, 0x6a, 0x57, 0xa6, 0x37, 0xb3, 0x9b};
+    const std::vector<std::uint8_t> ciphertext_4 = {
+        0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+        0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+        0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+        0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91};
+    const std::vector<std::uint8_t> tag_4 = {
+        0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47};
+    const std::vector<std::uint8_t> ciphertext_6 = {
+        0x8c, 0xe2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xb6, 0x03, 0xa0, 0x33, 0xac, 0xa1, 0x3f, 0xb8, 0x94,
+        0xbe, 0x91, 0x12, 0xa5, 0xc3, 0xa2, 0x11, 0xa8, 0xba, 0x26, 0x2a, 0x3c, 0xca, 0x7e, 0x2c, 0xa7,
+        0x01, 0xe4, 0xa9, 0xa4, 0xfb, 0xa4, 0x3c, 0x90, 0xcc, 0xdc, 0xb2, 0x81, 0xd4, 0x8c, 0x7c, 0x6f,
+        0xd6, 0x28, 0x75, 0xd2, 0xac, 0xa4, 0x17, 0x03, 0x4c, 0x34, 0xae, 0xe5};
+    const std::vector<std::uint8_t> tag_6 = {
+        0x61, 0x9c, 0xc5, 0xae, 0xff, 0xfe, 0x0b, 0xfa, 0x46, 0x2a, 0xf4, 0x3c, 0x16, 0x99, 0xd0, 0x50};
+    const std::vector<std::uint8_t> ciphertext_16 = {
+        0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d,
+        0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa,
+        0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+        0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62};
+    const std::vector<std::uint8_t> tag_16 = {
+        0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b};
+    const std::vector<std::uint8_t> ciphertext_2 = {
+        0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92, 0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78};
+    const std::vector<std::uint8_t> tag_2 = {
+        0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd, 0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf};
+
+    block::aes<128>::key_type key = {0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+                                     0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08};
+    block::aes<256>::key_type long_key;
+    for (std::size_t i = 0; i != long_key.size(); ++i) {
+        long_key[i] = key[i % key.size()];
+    }
+    block::aes<128>::key_type zero_key = {0};
+    std::uint8_t tag[16];
+
+    std::vector<std::uint8_t> out(16), zero(16);
+    encrypt128_type zero_encrypt(block::aes<128>(zero_key), zero.data(), 12);
+    zero_encrypt.process(zero.data(), out.data(), out.size());
+    zero_encrypt.tag(tag);
+    BOOST_CHECK(out == ciphertext_2);
+    BOOST_CHECK(std::equal(tag_2.begin(), tag_2.end(), tag));
+
+    const block::aes<128> cipher(key);
+    for (const std::vector<std::uint8_t> *v : {&iv, &long_iv}) {
+        const std::vector<std::uint8_t> &ciphertext = v == &iv ? ciphertext_4 : ciphertext_6;
+        const std::vector<std::uint8_t> &expected_tag = v == &iv ? tag_4 : tag_6;
+
+        encrypt128_type encrypt(cipher, v->data(), v->size());
+        encrypt.process_aad(aad.data(), aad.size());
+        out.resize(plaintext.size());
+        encrypt.process(plaintext.data(), out.data(), out.size());
+        encrypt.tag(tag);
+        BOOST_CHECK(out == ciphertext);
+        BOOST_CHECK(std::equal(expected_tag.begin(), expected_tag.end(), tag));
+
+        decrypt128_type decrypt(cipher, v->data(), v->size());
+        decrypt.process_aad(aad.data(), aad.size());
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(out == plaintext);
+        BOOST_CHECK(decrypt.verify(expected_tag.data()));
+        BOOST_CHECK(decrypt.verify(expected_tag.data(), 12));
+
+        std::vector<std::uint8_t> forged_tag = expected_tag;
+        forged_tag[15] ^= 0x80;
+        BOOST_CHECK(!decrypt.verify(forged_tag.data()));
+    }
+
+    gcm256_type::bind<gcm256_type::encryption_policy>::type encrypt256(block::aes<256>(long_key), iv.data(),
+                                                                         iv.size());
+    encrypt256.process_aad(aad.data(), aad.size());
+    out.resize(plaintext.size());
+    encrypt256.process(plaintext.data(), out.data(), out.size());
+    encrypt256.tag(tag);
+    BOOST_CHECK(out == ciphertext_16);
+    BOOST_CHECK(std::equal(tag_16.begin(), tag_16.end(), tag));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_gcm_fused_pass_matches_generic, Cipher, aes_types) {
+    typedef block::modes::gcm<Cipher, block::nop_padding> gcm_type;
+    typedef typename gcm_type::template bind<typename gcm_type::encryption_policy>::type encrypt_type;
+    typedef typename gcm_type::template bind<typename gcm_type::decryption_policy>::type decrypt_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x35 * i + 11);
+    }
+
+    // 75 blocks go through the aggregated, the four block and the single block groups, then a partial block
+    std::vector<std::uint8_t> iv(12), aad(45), plaintext(75 * 16 + 11), expected, out(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 7 + (i >> 8));
+    }
+    for (std::size_t i = 0; i != aad.size(); ++i) {
+        aad[i] = static_cast<std::uint8_t>(0xa0 ^ i);
+    }
+    for (std::size_t i = 0; i != iv.size(); ++i) {
+        iv[i] = static_cast<std::uint8_t>(0xff - i);
+    }
+    // The counter carries over its low 32 bits without touching the rest of the block
+    iv[11] = iv[10] = iv[9] = iv[8] = 0xff;
+
+    std::uint8_t expected_tag[16], tag[16];
+    for_each_backend([&](block::rijndael_backend::type) {
+        const Cipher cipher(key);
+        encrypt_type encrypt(cipher, iv.data(), iv.size());
+        encrypt.process_aad(aad.data(), 32);
+        encrypt.process_aad(aad.data() + 32, aad.size() - 32);
+        encrypt.process(plaintext.data(), out.data(), 19 * 16);
+        encrypt.process(plaintext.data() + 19 * 16, out.data() + 19 * 16, plaintext.size() - 19 * 16);
+        encrypt.tag(tag);
+        if (expected.empty()) {
+            expected = out;
+            std::copy(tag, tag + 16, expected_tag);
+        }
+        BOOST_CHECK(out == expected);
+        BOOST_CHECK(std::equal(tag, tag + 16, expected_tag));
+
+        decrypt_type decrypt(cipher, iv.data(), iv.size());
+        decrypt.process_aad(aad.data(), aad.size());
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(out == plaintext);
+        BOOST_CHECK(decrypt.verify(expected_tag));
+    });
+
+    // Both GHASH variants agree whichever one the host uses
+    block::detail::ghash_key hash_key;
+    std::uint8_t h[16], hash[16] = {0}, table_hash[16] = {0};
+    std::copy(plaintext.begin(), plaintext.begin() + 16, h);
+    block::detail::ghash::schedule(h, hash_key);
+    block::detail::ghash::update(hash_key, hash, plaintext.data(), 75);
+    block::detail::ghash::update_table(hash_key, table_hash, plaintext.data(), 75);
+    BOOST_CHECK(std::equal(hash, hash + 16, table_hash));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_ccm_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_ccm_mode_rfc3610) {
+    typedef block::modes::ccm<block::aes<128>, block::nop_padding> ccm128_type;
+    typedef block::modes::ccm<block::aes<256>, block::nop_padding> ccm256_type;
+    typedef ccm128_type::bind<ccm128_type::encryption_policy>::type encrypt128_type;
+    typedef ccm128_type::bind<ccm128_type::decryption_policy>::type decrypt128_type;
+
+    // RFC 3610 packet vector 1, then a 6-byte AAD length encoding and a message without AAD
+    const std::vector<std::uint8_t> ciphertext_1 = {
+        0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+        0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84};
+    const std::vector<std::uint8_t> tag_1 = {
+        0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0};
+    const std::vector<std::uint8_t> ciphertext_long_aad = {
+        0x3f, 0xb0, 0x73, 0x40, 0x1b, 0x1e, 0xcb, 0x1d, 0xc9, 0xbd, 0x55, 0x8c, 0x30, 0xa2, 0xfd, 0x50,
+        0xdf, 0xca, 0x91, 0x63, 0x0d, 0x13, 0xd3, 0x57, 0x61, 0xd5, 0x6e, 0xa8, 0x49, 0x5d, 0xb9, 0x54,
+        0xf0, 0xec, 0xfb, 0x83, 0xf2, 0x25, 0x6e, 0x6d};
+    const std::vector<std::uint8_t> tag_long_aad = {
+        0x91, 0x8e, 0x06, 0x77, 0xac, 0xf3, 0xa6, 0x04, 0x76, 0xc6, 0x4f, 0x2e, 0xe1, 0x95, 0x7e, 0xde};
+    const std::vector<std::uint8_t> ciphertext_no_aad = {
+        0x8b, 0x49, 0x5b, 0x28, 0xbf, 0x48, 0xd2, 0x1e, 0xb7, 0xda, 0xb6, 0x7b, 0x15, 0x0e, 0x11, 0x9b,
+        0x01, 0x4d, 0xc4, 0x63, 0xce, 0xb2, 0x0e, 0x54, 0xd4, 0x16, 0x6c, 0x0e, 0xa7, 0x41, 0xa7, 0xce};
+    const std::vector<std::uint8_t> tag_no_aad = {
+        0x6e, 0x48, 0x4a, 0x47, 0x64, 0x97, 0x9f, 0xd9, 0x30, 0x2b, 0x9c, 0xd6};
+
+    block::aes<128>::key_type key;
+    block::aes<256>::key_type long_key;
+    for (std::size_t i = 0; i != long_key.size(); ++i) {
+        long_key[i] = static_cast<std::uint8_t>(i * 3);
+        if (i < key.size()) {
+            key[i] = static_cast<std::uint8_t>(0xc0 + i);
+        }
+    }
+    std::vector<std::uint8_t> nonce = {0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5},
+                              short_nonce(7), aad(70000), plaintext(40), out;
+    for (std::size_t i = 0; i != aad.size(); ++i) {
+        aad[i] = static_cast<std::uint8_t>(i ^ (i >> 8));
+    }
+    for (std::size_t i = 0; i != short_nonce.size(); ++i) {
+        short_nonce[i] = static_cast<std::uint8_t>(0x10 + i);
+    }
+    std::uint8_t tag[16];
+
+    for (std::size_t i = 0; i != 23; ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(8 + i);
+    }
+    out.resize(23);
+    const block::aes<128> cipher(key);
+    encrypt128_type encrypt(cipher, nonce.data(), nonce.size(), 8, out.size(), 8);
+    std::vector<std::uint8_t> header = {0, 1, 2, 3, 4, 5, 6, 7};
+    encrypt.process_aad(header.data(), 3);
+    encrypt.process_aad(header.data() + 3, 5);
+    encrypt.process(plaintext.data(), out.data(), out.size());
+    encrypt.tag(tag);
+    BOOST_CHECK(out == ciphertext_1);
+    BOOST_CHECK(std::equal(tag_1.begin(), tag_1.end(), tag));
+
+    decrypt128_type decrypt(cipher, nonce.data(), nonce.size(), 8, out.size(), 8);
+    decrypt.process_aad(header.data(), header.size());
+    decrypt.process(out.data(), out.data(), out.size());
+    BOOST_CHECK(std::equal(out.begin(), out.end(), plaintext.begin()));
+    BOOST_CHECK(decrypt.verify(tag_1.data()));
+    std::vector<std::uint8_t> forged_tag = tag_1;
+    forged_tag[0] ^= 1;
+    BOOST_CHECK(!decrypt.verify(forged_tag.data()));
+
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i);
+    }
+    out.resize(plaintext.size());
+    ccm256_type::bind<ccm256_type::encryption_policy>::type encrypt256(
+        block::aes<256>(long_key), short_nonce.data(), short_nonce.size(), aad.size(), plaintext.size());
+    encrypt256.process_aad(aad.data(), 1000);
+    encrypt256.process_aad(aad.data() + 1000, aad.size() - 1000);
+    encrypt256.process(plaintext.data(), out.data(), 32);
+    encrypt256.process(plaintext.data() + 32, out.data() + 32, plaintext.size() - 32);
+    encrypt256.tag(tag);
+    BOOST_CHECK(out == ciphertext_long_aad);
+    BOOST_CHECK(std::equal(tag_long_aad.begin(), tag_long_aad.end(), tag));
+
+    std::vector<std::uint8_t> twelve_byte_nonce(12);
+    for (std::size_t i = 0; i != twelve_byte_nonce.size(); ++i) {
+        twelve_byte_nonce[i] = static_cast<std::uint8_t>(0xf0 + i);
+    }
+    for (std::size_t i = 0; i != 32; ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(0x55 ^ i);
+    }
+    out.resize(32);
+    encrypt128_type encrypt_no_aad(block::aes<128>(block::aes<128>::key_type {0x00, 0x03, 0x06, 0x09, 0x0c, 0x0f,
+                                                                               0x12, 0x15, 0x18, 0x1b, 0x1e, 0x21,
+                                                                               0x24, 0x27, 0x2a, 0x2d}),
+                                   twelve_byte_nonce.data(), twelve_byte_nonce.size(), 0, out.size(), 12);
+    encrypt_no_aad.process(plaintext.data(), out.data(), out.size());
+    encrypt_no_aad.tag(tag);
+    BOOST_CHECK(out == ciphertext_no_aad);
+    BOOST_CHECK(std::equal(tag_no_aad.begin(), tag_no_aad.end(), tag));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_ccm_fused_pass_matches_generic, Cipher, aes_types) {
+    typedef block::modes::ccm<Cipher, block::nop_padding> ccm_type;
+    typedef typename ccm_type::template bind<typename ccm_type::encryption_policy>::type encrypt_type;
+    typedef typename ccm_type::template bind<typename ccm_type::decryption_policy>::type decrypt_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x3b * i + 5);
+    }
+
+    // A 2-byte counter field carries into its upper byte within the message
+    std::vector<std::uint8_t> nonce(13, 0x42), aad(21), plaintext(300 * 16 + 7), expected, out(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 11 + (i >> 8));
+    }
+    for (std::size_t i = 0; i != aad.size(); ++i) {
+        aad[i] = static_cast<std::uint8_t>(0x5a ^ i);
+    }
+
+    std::uint8_t expected_tag[16], tag[16];
+    for_each_backend([&](block::rijndael_backend::type) {
+        const Cipher cipher(key);
+        encrypt_type encrypt(cipher, nonce.data(), nonce.size(), aad.size(), plaintext.size());
+        encrypt.process_aad(aad.data(), aad.size());
+        encrypt.process(plaintext.data(), out.data(), 37 * 16);
+        encrypt.process(plaintext.data() + 37 * 16, out.data() + 37 * 16, plaintext.size() - 37 * 16);
+        encrypt.tag(tag);
+        if (expected.empty()) {
+            expected = out;
+            std::copy(tag, tag + 16, expected_tag);
+        }
+        BOOST_CHECK(out == expected);
+        BOOST_CHECK(std::equal(tag, tag + 16, expected_tag));
+
+        decrypt_type decrypt(cipher, nonce.data(), nonce.size(), aad.size(), plaintext.size());
+        decrypt.process_aad(aad.data(), aad.size());
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(out == plaintext);
+        BOOST_CHECK(decrypt.verify(expected_tag));
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_ocb_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_ocb_mode_rfc7253) {
+    typedef block::modes::ocb<block::aes<128>, block::nop_padding> ocb128_type;
+    typedef block::modes::ocb<block::aes<256>, block::nop_padding> ocb256_type;
+    typedef ocb128_type::bind<ocb128_type::encryption_policy>::type encrypt128_type;
+    typedef ocb128_type::bind<ocb128_type::decryption_policy>::type decrypt128_type;
+    typedef ocb256_type::bind<ocb256_type::encryption_policy>::type encrypt256_type;
+    typedef ocb256_type::bind<ocb256_type::decryption_policy>::type decrypt256_type;
+
+    // RFC 7253 sample results, then longer messages reaching L_6 and L_7 with the ciphertext folded to a block
+    const std::vector<std::uint8_t> tag_empty = {
+        0x78, 0x54, 0x07, 0xbf, 0xff, 0xc8, 0xad, 0x9e, 0xdc, 0xc5, 0x52, 0x0a, 0xc9, 0x11, 0x1e, 0xe6};
+    const std::vector<std::uint8_t> ciphertext_8 = {
+        0x68, 0x20, 0xb3, 0x65, 0x7b, 0x6f, 0x61, 0x5a};
+    const std::vector<std::uint8_t> tag_8 = {
+        0x57, 0x25, 0xbd, 0xa0, 0xd3, 0xb4, 0xeb, 0x3a, 0x25, 0x7c, 0x9a, 0xf1, 0xf8, 0xf0, 0x30, 0x09};
+    const std::vector<std::uint8_t> ciphertext_40 = {
+        0xd5, 0xca, 0x91, 0x74, 0x84, 0x10, 0xc1, 0x75, 0x1f, 0xf8, 0xa2, 0xf6, 0x18, 0x25, 0x5b, 0x68,
+        0xa0, 0xa1, 0x2e, 0x09, 0x3f, 0xf4, 0x54, 0x60, 0x6e, 0x59, 0xf9, 0xc1, 0xd0, 0xdd, 0xc5, 0x4b,
+        0x65, 0xe8, 0x62, 0x8e, 0x56, 0x8b, 0xad, 0x7a};
+    const std::vector<std::uint8_t> tag_40 = {
+        0xed, 0x07, 0xba, 0x06, 0xa4, 0xa6, 0x94, 0x83, 0xa7, 0x03, 0x54, 0x90, 0xc5, 0x76, 0x9e, 0x60};
+    const std::vector<std::uint8_t> fold_1601 = {
+        0x9e, 0xb7, 0x83, 0xc3, 0x76, 0x2c, 0xb6, 0x05, 0x2b, 0xcb, 0x85, 0x43, 0x85, 0xbc, 0x5d, 0xe1};
+    const std::vector<std::uint8_t> tag_1601 = {
+        0xc6, 0x24, 0xf3, 0x23, 0x16, 0xd4, 0x7d, 0x1c, 0xbc, 0xae, 0xae, 0x49};
+    const std::vector<std::uint8_t> fold_4096 = {
+        0x94, 0xb1, 0xf8, 0x4f, 0xf4, 0x40, 0xa7, 0x68, 0x19, 0x76, 0x5d, 0x47, 0xb1, 0x6b, 0xfd, 0xe4};
+    const std::vector<std::uint8_t> tag_4096 = {
+        0x56, 0xf7, 0x93, 0x1f, 0x81, 0x56, 0x4b, 0x9b, 0x2b, 0x6e, 0x23, 0xb1, 0x35, 0x94, 0xce, 0xa9};
+
+    block::aes<128>::key_type key;
+    block::aes<256>::key_type long_key;
+    for (std::size_t i = 0; i != long_key.size(); ++i) {
+        long_key[i] = static_cast<std::uint8_t>(i);
+        if (i < key.size()) {
+            key[i] = static_cast<std::uint8_t>(i);
+        }
+    }
+    std::vector<std::uint8_t> nonce = {0xbb, 0xaa, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00},
+                              data(40), out;
+    for (std::size_t i = 0; i != data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>(i);
+    }
+    std::uint8_t tag[16];
+
+    const block::aes<128> cipher(key);
+    encrypt128_type encrypt_empty(cipher, nonce.data(), nonce.size());
+    encrypt_empty.tag(tag);
+    BOOST_CHECK(std::equal(tag_empty.begin(), tag_empty.end(), tag));
+
+    for (const std::vector<std::uint8_t> *expected : {&ciphertext_8, &ciphertext_40}) {
+        const std::vector<std::uint8_t> &expected_tag = expected == &ciphertext_8 ? tag_8 : tag_40;
+        nonce.back() = expected == &ciphertext_8 ? 0x01 : 0x0d;
+
+        out.resize(expected->size());
+        encrypt128_type encrypt(cipher, nonce.data(), nonce.size());
+        encrypt.process_aad(data.data(), out.size());
+        encrypt.process(data.data(), out.data(), out.size());
+        encrypt.tag(tag);
+        BOOST_CHECK(out == *expected);
+        BOOST_CHECK(std::equal(expected_tag.begin(), expected_tag.end(), tag));
+
+        decrypt128_type decrypt(cipher, nonce.data(), nonce.size());
+        decrypt.process_aad(data.data(), out.size());
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(std::equal(out.begin(), out.end(), data.begin()));
+        BOOST_CHECK(decrypt.verify(expected_tag.data()));
+
+        std::vector<std::uint8_t> forged_tag = expected_tag;
+        forged_tag[7] ^= 4;
+        BOOST_CHECK(!decrypt.verify(forged_tag.data()));
+    }
+
+    std::vector<std::uint8_t> plaintext(4096), aad(1000), long_nonce(15), short_nonce = {9, 8, 7, 6, 5, 4, 3};
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 7 + (i >> 8));
+    }
+    for (std::size_t i = 0; i != aad.size(); ++i) {
+        aad[i] = static_cast<std::uint8_t>(0x33 ^ i);
+    }
+    for (std::size_t i = 0; i != long_nonce.size(); ++i) {
+        long_nonce[i] = static_cast<std::uint8_t>(0xe0 + i);
+    }
+
+    const block::aes<256> long_cipher(long_key);
+    for (const std::vector<std::uint8_t> *expected_fold : {&fold_1601, &fold_4096}) {
+        const bool partial = expected_fold == &fold_1601;
+        const std::vector<std::uint8_t> &v = partial ? long_nonce : short_nonce;
+        const std::vector<std::uint8_t> &expected_tag = partial ? tag_1601 : tag_4096;
+        const std::size_t aad_size = partial ? 1000 : 37, tag_size = expected_tag.size();
+
+        // Calls split at block boundaries, in the middle of a group and at the end of one
+        out.resize(partial ? 1601 : 4096);
+        encrypt256_type encrypt(long_cipher, v.data(), v.size(), tag_size);
+        const std::size_t aad_split = partial ? 512 : 32;
+        encrypt.process_aad(aad.data(), aad_split);
+        encrypt.process_aad(aad.data() + aad_split, aad_size - aad_split);
+        encrypt.process(plaintext.data(), out.data(), 3 * 16);
+        encrypt.process(plaintext.data() + 3 * 16, out.data() + 3 * 16, 77 * 16);
+        encrypt.process(plaintext.data() + 80 * 16, out.data() + 80 * 16, out.size() - 80 * 16);
+        encrypt.tag(tag);
+
+        std::uint8_t fold[16] = {0};
+        for (std::size_t i = 0; i != out.size(); ++i) {
+            fold[i % 16] ^= out[i];
+        }
+        BOOST_CHECK(std::equal(expected_fold->begin(), expected_fold->end(), fold));
+        BOOST_CHECK(std::equal(expected_tag.begin(), expected_tag.end(), tag));
+
+        decrypt256_type decrypt(long_cipher, v.data(), v.size(), tag_size);
+        decrypt.process_aad(aad.data(), aad_size);
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(std::equal(out.begin(), out.end(), plaintext.begin()));
+        BOOST_CHECK(decrypt.verify(expected_tag.data()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_ocb_bulk_pass_matches_generic, Cipher, aes_types) {
+    typedef block::modes::ocb<Cipher, block::nop_padding> ocb_type;
+    typedef typename ocb_type::template bind<typename ocb_type::encryption_policy>::type encrypt_type;
+    typedef typename ocb_type::template bind<typename ocb_type::decryption_policy>::type decrypt_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x47 * i + 1);
+    }
+
+    std::vector<std::uint8_t> nonce(12, 0x24), aad(75), plaintext(300 * 16 + 5), expected, out(plaintext.size());
+    for (std::size_t i = 0; i != plaintext.size(); ++i) {
+        plaintext[i] = static_cast<std::uint8_t>(i * 5 + (i >> 8));
+    }
+    for (std::size_t i = 0; i != aad.size(); ++i) {
+        aad[i] = static_cast<std::uint8_t>(0x6c ^ i);
+    }
+
+    std::uint8_t expected_tag[16], tag[16];
+    for_each_backend([&](block::rijndael_backend::type) {
+        const Cipher cipher(key);
+        encrypt_type encrypt(cipher, nonce.data(), nonce.size());
+        encrypt.process_aad(aad.data(), aad.size());
+        encrypt.process(plaintext.data(), out.data(), plaintext.size());
+        encrypt.tag(tag);
+        if (expected.empty()) {
+            expected = out;
+            std::copy(tag, tag + 16, expected_tag);
+        }
+        BOOST_CHECK(out == expected);
+        BOOST_CHECK(std::equal(tag, tag + 16, expected_tag));
+
+        decrypt_type decrypt(cipher, nonce.data(), nonce.size());
+        decrypt.process_aad(aad.data(), aad.size());
+        decrypt.process(out.data(), out.data(), out.size());
+        BOOST_CHECK(out == plaintext);
+        BOOST_CHECK(decrypt.verify(expected_tag));
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_pmac_mode_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_pmac_mode_test_vectors) {
+    typedef block::modes::pmac<block::aes<128>, block::nop_padding> pmac_type;
+    typedef pmac_type::bind<pmac_type::encryption_policy>::type mac_type;
+
+    // PMAC1 reference vectors over the message 00 01 02 ..., then 1000 zero bytes
+    const std::size_t lengths[] = {0, 3, 16, 20, 32, 34};
+    const std::vector<std::vector<std::uint8_t>> tags = {
+        {0x43, 0x99, 0x57, 0x2c, 0xd6, 0xea, 0x53, 0x41, 0xb8, 0xd3, 0x58, 0x76, 0xa7, 0x09, 0x8a, 0xf7},
+        {0x25, 0x6b, 0xa5, 0x19, 0x3c, 0x1b, 0x99, 0x1b, 0x4d, 0xf0, 0xc5, 0x1f, 0x38, 0x8a, 0x9e, 0x27},
+        {0xeb, 0xbd, 0x82, 0x2f, 0xa4, 0x58, 0xda, 0xf6, 0xdf, 0xda, 0xd7, 0xc2, 0x7d, 0xa7, 0x63, 0x38},
+        {0x04, 0x12, 0xca, 0x15, 0x0b, 0xbf, 0x79, 0x05, 0x8d, 0x8c, 0x75, 0xa5, 0x8c, 0x99, 0x3f, 0x55},
+        {0xe9, 0x7a, 0xc0, 0x4e, 0x9e, 0x5e, 0x33, 0x99, 0xce, 0x53, 0x55, 0xcd, 0x74, 0x07, 0xbc, 0x75},
+        {0x5c, 0xba, 0x7d, 0x5e, 0xb2, 0x4f, 0x7c, 0x86, 0xcc, 0xc5, 0x46, 0x04, 0xe5, 0x3d, 0x55, 0x12}};
+    const std::vector<std::uint8_t> tag_zeros = {
+        0xc2, 0xc9, 0xfa, 0x1d, 0x99, 0x85, 0xf6, 0xf0, 0xd2, 0xaf, 0xf9, 0x15, 0xa0, 0xe8, 0xd9, 0x10};
+
+    block::aes<128>::key_type key;
+    std::vector<std::uint8_t> message(34);
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<std::uint8_t>(i);
+    }
+    for (std::size_t i = 0; i != message.size(); ++i) {
+        message[i] = static_cast<std::uint8_t>(i);
+    }
+    const block::aes<128> cipher(key);
+
+    for (std::size_t n = 0; n != tags.size(); ++n) {
+        mac_type mac(cipher);
+        mac.process(message.data(), lengths[n]);
+        BOOST_CHECK(mac.verify(tags[n].data()));
+    }
+
+    // Split at, before and after block boundaries, the tag truncated
+    const std::vector<std::uint8_t> zeros(1000);
+    mac_type mac(cipher, 12);
+    mac.process(zeros.data(), 1);
+    mac.process(zeros.data() + 1, 15);
+    mac.process(zeros.data() + 16, 0);
+    mac.process(zeros.data() + 16, 499);
+    mac.process(zeros.data() + 515, 485);
+    std::uint8_t tag[12];
+    mac.tag(tag);
+    BOOST_CHECK(std::equal(tag, tag + 12, tag_zeros.begin()));
+    BOOST_CHECK(mac.verify(tag_zeros.data()));
+
+    std::vector<std::uint8_t> wrong(tag_zeros);
+    wrong[11] ^= 1;
+    BOOST_CHECK(!mac.verify(wrong.data()));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_pmac_bulk_pass_matches_generic, Cipher, aes_types) {
+    typedef block::modes::pmac<Cipher, block::nop_padding> pmac_type;
+    typedef typename pmac_type::template bind<typename pmac_type::encryption_policy>::type mac_type;
+
+    typename Cipher::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<typename Cipher::key_type::value_type>(0x3b * i + 5);
+    }
+
+    std::vector<std::uint8_t> message(300 * 16 + 5);
+    for (std::size_t i = 0; i != message.size(); ++i) {
+        message[i] = static_cast<std::uint8_t>(i * 7 + (i >> 8));
+    }
+
+    // Whole message, then block aligned, then exactly one block held back at the end
+    const std::size_t sizes[] = {message.size(), 300 * 16, 17};
+    std::vector<std::vector<std::uint8_t>> expected;
+    for_each_backend([&](block::rijndael_backend::type) {
+        const Cipher cipher(key);
+        for (std::size_t n = 0; n != 3; ++n) {
+            std::vector<std::uint8_t> whole(16), split(16);
+
+            mac_type single(cipher);
+            single.process(message.data(), sizes[n]);
+            single.tag(whole.data());
+
+            // Uneven calls, some of them shorter than a block
+            mac_type chunked(cipher);
+            for (std::size_t done = 0, step = 1; done != sizes[n]; step = step * 3 + 1) {
+                const std::size_t size = std::min(step, sizes[n] - done);
+                chunked.process(message.data() + done, size);
+                done += size;
+            }
+            chunked.tag(split.data());
+
+            if (expected.size() == n) {
+                expected.push_back(whole);
+            }
+            BOOST_CHECK(whole == expected[n]);
+            BOOST_CHECK(split == expected[n]);
+        }
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(aes_ctr_drbg_test_suite)
+
+BOOST_AUTO_TEST_CASE(aes_ctr_drbg_known_answers) {
+    // Cross-checked against the OpenSSL CTR-DRBG with the derivation function disabled
+    std::uint8_t entropy[96], personalization[48], additional[3][48];
+    for (std::size_t i = 0; i != 96; ++i) {
+        entropy[i] = static_cast<std::uint8_t>(i);
+    }
+    for (std::size_t i = 0; i != 48; ++i) {
+        personalization[i] = static_cast<std::uint8_t>(0x80 + i);
+        additional[0][i] = static_cast<std::uint8_t>(0xc0 + i);
+        additional[1][i] = static_cast<std::uint8_t>(0x30 + i);
+        additional[2][i] = static_cast<std::uint8_t>(0x60 + i);
+    }
+    std::vector<std::uint8_t> out(64);
+
+    block::ctr_drbg<256> personalized(entropy, 48, personalization, 48);
+    personalized.generate(out.data(), out.size());
+    personalized.generate(out.data(), out.size());
+    BOOST_CHECK(out == (std::vector<std::uint8_t> {
+                           0x90, 0xb6, 0xd2, 0x15, 0xad, 0x8f, 0x7c, 0x0d, 0x3b, 0x94, 0x8a, 0xd6, 0x68, 0x88, 0x4c,
+                           0x5f, 0x5f, 0x04, 0xd0, 0x32, 0xf4, 0x2d, 0x99, 0x16, 0x3e, 0x73, 0x09, 0x0f, 0x6a, 0xa2,
+                           0xd5, 0xb4, 0x8c, 0x52, 0xcc, 0x6a, 0xff, 0xa4, 0x50, 0x06, 0xb6, 0x58, 0x52, 0x88, 0xc4,
+                           0x05, 0xf4, 0x03, 0x31, 0xaa, 0xc2, 0xc7, 0xdd, 0x68, 0x86, 0xf1, 0x27, 0xde, 0xaf, 0x75,
+                           0x9e, 0x51, 0x43, 0x21}));
+
+    // Additional input of full and partial length, reseeded in between
+    block::ctr_drbg<256> reseeded(entropy, 48);
+    reseeded.generate(out.data(), out.size(), additional[0], 48);
+    reseeded.reseed(entropy + 48, 48, additional[1], 20);
+    reseeded.generate(out.data(), out.size(), additional[2], 33);
+    BOOST_CHECK(out == (std::vector<std::uint8_t> {
+                           0x6b, 0x89, 0x67, 0xd5, 0xa2, 0x7c, 0x98, 0xf6, 0x82, 0x18, 0xe6, 0x2d, 0x24, 0xb8, 0x1f,
+                           0x00, 0x68, 0xed, 0x19, 0x9c, 0xa2, 0xd3, 0x15, 0xde, 0x79, 0x87, 0xe0, 0x67, 0x0b, 0x80,
+                           0x81, 0x86, 0x05, 0x3d, 0xe9, 0x2d, 0xf9, 0xe6, 0xef, 0x9c, 0xef, 0x35, 0x87, 0x1b, 0x94,
+                           0x6a, 0xeb, 0x72, 0x3e, 0xfd, 0x1e, 0xcb, 0x8f, 0x9c, 0xdc, 0x8f, 0xfa, 0xd7, 0x16, 0x9d,
+                           0x42, 0xc4, 0x4e, 0xc7}));
+
+    // Requests ending inside a block
+    block::ctr_drbg<128> partial(entropy, 32);
+    out.resize(5);
+    partial.generate(out.data(), out.size());
+    BOOST_CHECK(out == (std::vector<std::uint8_t> {0x16, 0x86, 0xff, 0xcf, 0x9f}));
+    out.resize(37);
+    partial.generate(out.data(), out.size());
+    BOOST_CHECK(out == (std::vector<std::uint8_t> {
+                           0x8a, 0x0f, 0x6b, 0xa3, 0x7b, 0xc5, 0x9e, 0x9d, 0x5f, 0xd7, 0x79, 0xe0, 0x06,
+                           0x4d, 0x80, 0x7e, 0x2e, 0x3b, 0x04, 0x7c, 0xee, 0xd2, 0x4e, 0x7e, 0x31, 0xbd,
+                           0x97, 0x23, 0x4d, 0xc1, 0x32, 0x0b, 0xc6, 0x18, 0x1a, 0xf4, 0x1d}));
+}
+
+BOOST_AUTO_TEST_CASE(aes_ctr_drbg_bulk_requests) {
+    typedef std::array<std::uint8_t, 16> probe_type;
+
+    std::uint8_t entropy[48], personalization[40];
+    for (std::size_t i = 0; i != 48; ++i) {
+        entropy[i] = static_cast<std::uint8_t>(i);
+    }
+    for (std::size_t i = 0; i != 40; ++i) {
+        personalization[i] = static_cast<std::uint8_t>(0x80 + i);
+    }
+
+    // Last bytes of requests at, just over and well past the single pass limit
+    const std::size_t aes192_sizes[] = {256, 300, 4097};
+    const probe_type aes192_last[] = {
+        {0x62, 0x78, 0x5c, 0x07, 0x1f, 0xd0, 0x7e, 0x1f, 0xe3, 0x60, 0x82, 0x9c, 0x02, 0xd2, 0x6e, 0x59},
+        {0x74, 0x75, 0xaf, 0x03, 0xb3, 0x8f, 0xa0, 0xb9, 0x34, 0xe6, 0x2c, 0x01, 0x67, 0x8b, 0xdb, 0x9b},
+        {0x74, 0xa5, 0x3d, 0x1d, 0x93, 0x5a, 0xac, 0x25, 0xba, 0xc2, 0xa6, 0x2e, 0x5e, 0x14, 0x85, 0x17}};
+
+    // First and last bytes of each request a 150000 byte output is split into
+    const std::size_t bulk_offsets[] = {0, 65520, 65536, 131056, 131072, 149984};
+    const probe_type bulk_probes[] = {
+        {0x06, 0x15, 0x50, 0x23, 0x4d, 0x15, 0x8c, 0x5e, 0xc9, 0x55, 0x95, 0xfe, 0x04, 0xef, 0x7a, 0x25},
+        {0x75, 0x9c, 0x50, 0x80, 0xff, 0x39, 0xfd, 0x97, 0xbb, 0x73, 0x47, 0x40, 0x6d, 0x54, 0x5b, 0x5e},
+        {0xa9, 0x6a, 0x28, 0x96, 0x87, 0x8e, 0x61, 0x5f, 0x52, 0x03, 0x00, 0xc1, 0xc1, 0x44, 0xdc, 0xbd},
+        {0x11, 0x93, 0x6e, 0xaf, 0x49, 0x79, 0x9a, 0xdf, 0xcf, 0xd8, 0xfa, 0x1e, 0xae, 0xcf, 0x50, 0xe8},
+        {0x02, 0x66, 0x14, 0x04, 0x31, 0x4b, 0xd1, 0x5e, 0xa9, 0x6b, 0x72, 0x3f, 0xbe, 0xbd, 0xaa, 0x45},
+        {0xf5, 0xbf, 0xe4, 0x88, 0xf7, 0xe6, 0xd6, 0xae, 0xb6, 0xf3, 0x54, 0x42, 0x2e, 0xb5, 0xcb, 0x3b}};
+
+    for_each_backend([&](block::rijndael_backend::type) {
+        block::ctr_drbg<192> aes192(entropy, 40, personalization, 40);
+        for (std::size_t i = 0; i != 3; ++i) {
+            std::vector<std::uint8_t> out(aes192_sizes[i]);
+            aes192.generate(out.data(), out.size());
+            BOOST_CHECK(std::equal(aes192_last[i].begin(), aes192_last[i].end(), out.end() - 16));
+        }
+
+        block::ctr_drbg<256> aes256(entropy, 48);
+        std::vector<std::uint8_t> out(150000);
+        aes256.generate(out.data(), out.size());
+        for (std::size_t i = 0; i != 6; ++i) {
+            BOOST_CHECK(std::equal(bulk_probes[i].begin(), bulk_probes[i].end(), out.begin() + bulk_offsets[i]));
+        }
+    });
+
+    // Per-thread generators seeded from the system are distinct and keep their identity
+    std::array<probe_type, 4> nonces, other_nonces;
+    block::ctr_drbg<256> &local = block::ctr_drbg<256>::thread_instance();
+    BOOST_CHECK(&local == &block::ctr_drbg<256>::thread_instance());
+    local.generate(nonces);
+    std::thread([&other_nonces] { block::ctr_drbg<256>::thread_instance().generate(other_nonces); }).join();
+    BOOST_CHECK(nonces != other_nonces);
+    BOOST_CHECK(nonces[0] != nonces[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 /*
 BOOST_AUTO_TEST_SUITE(aes_various_containers_test_suite)
 
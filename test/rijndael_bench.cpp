@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2020 Mikhail Komarov <nemo@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE rijndael_bench_test
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/mpl/list.hpp>
+
+#include <nil/crypto3/block/algorithm/parallel.hpp>
+
+#include <nil/crypto3/block/aes.hpp>
+#include <nil/crypto3/block/rijndael_multi_key.hpp>
+
+using namespace nil::crypto3;
+
+namespace {
+    // Best of a few runs, in seconds, to hide the first-touch and frequency ramp-up cost
+    template<typename F>
+    double best_of(std::size_t runs, F f) {
+        double best = 0;
+        for (std::size_t r = 0; r != runs; ++r) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            f();
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = r == 0 || elapsed < best ? elapsed : best;
+        }
+        return best;
+    }
+}    // namespace
+
+BOOST_AUTO_TEST_SUITE(parallel_ecb_bench_suite)
+
+// Throughput of parallel_encrypt against the pool size, the speedup is relative to a single thread
+BOOST_AUTO_TEST_CASE(aes128_parallel_ecb_scaling) {
+    typedef block::aes<128> cipher_type;
+
+    cipher_type::key_type key;
+    for (std::size_t i = 0; i != key.size(); ++i) {
+        key[i] = static_cast<cipher_type::key_type::value_type>(i * 17 + 3);
+    }
+    const cipher_type cipher(key);
+
+    const std::size_t octets = 64 * 1024 * 1024;
+    std::vector<std::uint8_t> input(octets), reference(octets), output(octets);
+    for (std::size_t i = 0; i != octets; ++i) {
+        input[i] = static_cast<std::uint8_t>(i * 29 + (i >> 11));
+    }
+
+    std::vector<std::size_t> sizes = {1, 2, 4, 8};
+    const std::size_t hardware = std::thread::hardware_concurrency();
+    if (hardware > sizes.back()) {
+        sizes.push_back(hardware);
+    }
+
+    double single = 0;
+    for (std::size_t threads : sizes) {
+        block::thread_pool pool(threads);
+        std::vector<std::uint8_t> &out = threads == 1 ? reference : output;
+
+        const double elapsed =
+            best_of(5, [&] { parallel_encrypt(input.begin(), input.end(), cipher, out.begin(), pool); });
+        single = threads == 1 ? elapsed : single;
+
+        BOOST_TEST_MESSAGE("threads " << threads << ": " << octets / elapsed / (1024 * 1024) << " MiB/s, speedup "
+                                      << single / elapsed);
+        BOOST_CHECK(out == reference);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(key_setup_bench_suite)
+
+typedef boost::mpl::list<block::aes<128>, block::aes<192>, block::aes<256>> aes_types;
+
+// Nanoseconds per key for a cipher object, which builds both schedules, and for batched encryption-only
+// schedules through rijndael_multi_key, on every backend available here
+BOOST_AUTO_TEST_CASE_TEMPLATE(aes_key_setup, Cipher, aes_types) {
+    typedef block::rijndael_multi_key<Cipher::key_bits, Cipher::block_bits> engine_type;
+
+    const std::size_t key_bits = Cipher::key_bits;
+    const std::size_t keys_count = 256;
+    std::vector<typename Cipher::key_type> keys(keys_count);
+    for (std::size_t k = 0; k != keys_count; ++k) {
+        for (std::size_t i = 0; i != keys[k].size(); ++i) {
+            keys[k][i] = static_cast<typename Cipher::key_type::value_type>(k * 31 + i * 7);
+        }
+    }
+
+    for (block::rijndael_backend::type backend :
+         {block::rijndael_backend::generic, block::rijndael_backend::ssse3, block::rijndael_backend::aes_ni,
+          block::rijndael_backend::armv8, block::rijndael_backend::power8, block::rijndael_backend::vaes_avx2,
+          block::rijndael_backend::vaes_avx512, block::rijndael_backend::bitsliced}) {
+        if (!block::rijndael_backend::force(backend)) {
+            continue;
+        }
+
+        // Keeps the constructions from being optimized away
+        std::size_t sink = 0;
+        const double single = best_of(5, [&] {
+            for (std::size_t k = 0; k != keys_count; ++k) {
+                const Cipher cipher(keys[k]);
+                sink += cipher.encrypt(typename Cipher::block_type())[0];
+            }
+        });
+
+        engine_type engine;
+        engine.reserve(keys_count);
+        const double batched = best_of(5, [&] {
+            engine.clear();
+            engine.add_keys(keys.data(), keys_count);
+        });
+        BOOST_CHECK_EQUAL(engine.keys(), keys_count);
+
+        BOOST_TEST_MESSAGE(block::rijndael_backend::name(backend)
+                           << " aes" << key_bits << ": " << single * 1e9 / keys_count << " ns single, "
+                           << batched * 1e9 / keys_count << " ns batched encrypt-only (" << sink % 2 << ")");
+    }
+
+    block::rijndael_backend::reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()